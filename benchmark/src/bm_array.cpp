@@ -0,0 +1,109 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "container/array.hpp"
+#include "string/string.hpp"
+
+using namespace atlas;
+
+template<typename T>
+static Array<T> make_search_array(size_t count)
+{
+    Array<T> array;
+    for (size_t i = 0; i < count; ++i)
+    {
+        array.add(static_cast<T>(i % 127 + 1));
+    }
+    return array;
+}
+
+template<typename T>
+static void BM_ArrayFindScalar(benchmark::State& state)
+{
+    const Array<T> array = make_search_array<T>(state.range(0));
+    // the value is not in the array, so the whole array is scanned.
+    const T search = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(array.find([search](const T& elem) { return elem == search; }));
+    }
+
+    state.SetBytesProcessed(state.iterations() * array.size() * sizeof(T));
+}
+
+template<typename T>
+static void BM_ArrayFind(benchmark::State& state)
+{
+    const Array<T> array = make_search_array<T>(state.range(0));
+    const T search = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(array.find(search));
+    }
+
+    state.SetBytesProcessed(state.iterations() * array.size() * sizeof(T));
+}
+
+BENCHMARK(BM_ArrayFindScalar<uint8>)->Range(8, 4096);
+BENCHMARK(BM_ArrayFind<uint8>)->Range(8, 4096);
+BENCHMARK(BM_ArrayFindScalar<uint32>)->Range(8, 4096);
+BENCHMARK(BM_ArrayFind<uint32>)->Range(8, 4096);
+BENCHMARK(BM_ArrayFindScalar<uint64>)->Range(8, 4096);
+BENCHMARK(BM_ArrayFind<uint64>)->Range(8, 4096);
+
+static void BM_ArrayRemoveAll(benchmark::State& state)
+{
+    const Array<uint32> source = make_search_array<uint32>(state.range(0));
+    Array<uint32> array;
+    for (auto _ : state)
+    {
+        array = source;
+        benchmark::DoNotOptimize(array.remove_all(7));
+    }
+
+    state.SetItemsProcessed(state.iterations() * source.size());
+}
+BENCHMARK(BM_ArrayRemoveAll)->Range(8, 4096);
+
+static void BM_ArrayStringGrow(benchmark::State& state)
+{
+    const String value("a string too long to be stored inline");
+    for (auto _ : state)
+    {
+        Array<String> array;
+        for (int64 i = 0; i < state.range(0); ++i)
+        {
+            array.add(value);
+        }
+        benchmark::DoNotOptimize(array.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayStringGrow)->Range(8, 4096);
+
+static void BM_ArrayStringRemoveAt(benchmark::State& state)
+{
+    Array<String> source;
+    for (int64 i = 0; i < state.range(0); ++i)
+    {
+        source.add(String::format("{}", i));
+    }
+    Array<String> array;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        array = source;
+        state.ResumeTiming();
+        // erases from the front, so the whole tail is moved every time.
+        while (array.size() > 1)
+        {
+            array.remove_at(0);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ArrayStringRemoveAt)->Range(8, 1024);
@@ -0,0 +1,55 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "concurrency/lock_free_list.hpp"
+
+using namespace atlas;
+
+#define BATCH_SIZE 64
+
+static void BM_LockFreeLIFOPushPop(benchmark::State& state)
+{
+    // shared by all benchmark threads
+    static LockFreePointerListLIFORoot<PLATFORM_CACHE_LINE_SIZE> list;
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            list.push(LockFreeLinkPolicy::alloc_lock_free_link());
+        }
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            if (LockFreeLinkPolicy::link_ptr_type link = list.pop())
+            {
+                LockFreeLinkPolicy::free_lock_free_link(link);
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE * 2);
+}
+BENCHMARK(BM_LockFreeLIFOPushPop)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_LockFreeFIFOPushPop(benchmark::State& state)
+{
+    static LockFreePointerFIFOBase<int32, PLATFORM_CACHE_LINE_SIZE> queue;
+    int32 payload = 0;
+
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            queue.push(&payload);
+        }
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            benchmark::DoNotOptimize(queue.pop());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE * 2);
+}
+BENCHMARK(BM_LockFreeFIFOPushPop)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,47 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "memory/standard_malloc.hpp"
+#include "memory/thread_caching_malloc.hpp"
+
+using namespace atlas;
+
+#define BATCH_SIZE 64
+
+static StandardMalloc g_standard_malloc;
+static ThreadCachingMalloc g_thread_caching_malloc(&g_standard_malloc);
+
+template<typename MallocType>
+static void malloc_free_batch(benchmark::State& state, MallocType& malloc)
+{
+    void* blocks[BATCH_SIZE];
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            // mixes sizes of strings, small arrays and coroutine frames.
+            blocks[i] = malloc.malloc(16 + (i * 37) % 512);
+        }
+        benchmark::DoNotOptimize(blocks);
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            malloc.free(blocks[i]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+
+static void BM_StandardMalloc(benchmark::State& state)
+{
+    malloc_free_batch(state, g_standard_malloc);
+}
+BENCHMARK(BM_StandardMalloc)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_ThreadCachingMalloc(benchmark::State& state)
+{
+    malloc_free_batch(state, g_thread_caching_malloc);
+}
+BENCHMARK(BM_ThreadCachingMalloc)->ThreadRange(1, 16)->UseRealTime();
@@ -0,0 +1,73 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "memory/object_pool.hpp"
+
+using namespace atlas;
+
+#define BATCH_SIZE 64
+
+struct ChurnNode
+{
+    ChurnNode* next;
+    void* payload;
+    uint64 data[4];
+};
+
+template<typename AllocatorType>
+static void node_churn(benchmark::State& state, AllocatorType& allocator)
+{
+    ChurnNode* nodes[BATCH_SIZE];
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            nodes[i] = allocator.allocate(1);
+        }
+        benchmark::DoNotOptimize(nodes);
+        // frees out of allocation order, like nodes of a container being erased.
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            allocator.deallocate(nodes[(i * 7) % BATCH_SIZE], 1);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+
+static void BM_HeapAllocatorNodeChurn(benchmark::State& state)
+{
+    HeapAllocator<ChurnNode> allocator;
+    node_churn(state, allocator);
+}
+BENCHMARK(BM_HeapAllocatorNodeChurn)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_PoolAllocatorNodeChurn(benchmark::State& state)
+{
+    PoolAllocator<ChurnNode> allocator;
+    node_churn(state, allocator);
+}
+BENCHMARK(BM_PoolAllocatorNodeChurn)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_ObjectPoolNodeChurn(benchmark::State& state)
+{
+    ObjectPool<ChurnNode> pool;
+    ChurnNode* nodes[BATCH_SIZE];
+    for (auto _ : state)
+    {
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            nodes[i] = pool.allocate();
+        }
+        benchmark::DoNotOptimize(nodes);
+        for (int32 i = 0; i < BATCH_SIZE; ++i)
+        {
+            pool.deallocate(nodes[(i * 7) % BATCH_SIZE]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+}
+BENCHMARK(BM_ObjectPoolNodeChurn);
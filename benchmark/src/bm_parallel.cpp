@@ -0,0 +1,70 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "async/parallel.hpp"
+
+using namespace atlas;
+
+static Array<uint32> make_random_array(size_t count)
+{
+    Array<uint32> values;
+    values.reserve(count);
+    uint32 random_state = 1;
+    for (size_t i = 0; i < count; ++i)
+    {
+        random_state = random_state * 1664525u + 1013904223u;
+        values.add(random_state);
+    }
+    return values;
+}
+
+static void BM_StdSort(benchmark::State& state)
+{
+    const Array<uint32> source = make_random_array(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<uint32> values = source;
+        state.ResumeTiming();
+        std::sort(values.begin(), values.end());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSort)->RangeMultiplier(10)->Range(10000, 1000000)->UseRealTime();
+
+static void BM_ParallelSort(benchmark::State& state)
+{
+    const Array<uint32> source = make_random_array(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Array<uint32> values = source;
+        state.ResumeTiming();
+        parallel_sort(values);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParallelSort)->RangeMultiplier(10)->Range(10000, 1000000)->UseRealTime();
+
+static void BM_ParallelReduce(benchmark::State& state)
+{
+    const Array<uint32> values = make_random_array(state.range(0));
+    for (auto _ : state)
+    {
+        uint64 sum = parallel_reduce(values.size(), 4096, uint64(0), [&values](size_t begin, size_t end) {
+            uint64 partial = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                partial += values[i];
+            }
+            return partial;
+        }, std::plus<uint64>());
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParallelReduce)->RangeMultiplier(10)->Range(10000, 1000000)->UseRealTime();
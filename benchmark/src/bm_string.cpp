@@ -47,6 +47,4 @@ static void BM_LargeStdStringCreation(benchmark::State& state)
     for (auto _ : state)
         benchmark::DoNotOptimize(std::string(str));
 }
-BENCHMARK(BM_LargeStdStringCreation)->Iterations(ITERATION_TIMES);
-
-BENCHMARK_MAIN();
\ No newline at end of file
+BENCHMARK(BM_LargeStdStringCreation)->Iterations(ITERATION_TIMES);
\ No newline at end of file
@@ -0,0 +1,30 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "async/task.hpp"
+
+using namespace atlas;
+
+static Task<int32> chained_await(int32 depth)
+{
+    if (depth == 0)
+    {
+        co_return 0;
+    }
+    co_return co_await chained_await(depth - 1) + 1;
+}
+
+static void BM_TaskChainedAwait(benchmark::State& state)
+{
+    const int32 depth = static_cast<int32>(state.range(0));
+    for (auto _ : state)
+    {
+        Task<int32> task = launch(chained_await(depth));
+        benchmark::DoNotOptimize(task.get_result());
+    }
+    state.SetItemsProcessed(state.iterations() * (depth + 1));
+}
+
+BENCHMARK(BM_TaskChainedAwait)->RangeMultiplier(10)->Range(1, 1000);
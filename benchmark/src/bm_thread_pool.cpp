@@ -0,0 +1,68 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+#include "async/static_thread_pool.hpp"
+#include "async/work_stealing_thread_pool.hpp"
+
+using namespace atlas;
+
+#define TASK_COUNT (1 << 16)
+
+template<typename ThreadPoolType>
+static void run_producers(benchmark::State& state)
+{
+    const int32 producer_count = static_cast<int32>(state.range(0));
+    const int32 task_per_producer = TASK_COUNT / producer_count;
+    const int32 total_task = task_per_producer * producer_count;
+
+    ThreadPoolType thread_pool(Thread::hardware_concurrency());
+
+    for (auto _ : state)
+    {
+        std::atomic<int32> remain = total_task;
+        Array<std::thread> producers(producer_count);
+        for (int32 i = 0; i < producer_count; ++i)
+        {
+            producers.emplace([&]() {
+                for (int32 j = 0; j < task_per_producer; ++j)
+                {
+                    thread_pool.push_task(j & 1, [&remain]() {
+                        remain.fetch_sub(1, std::memory_order_release);
+                    });
+                }
+            });
+        }
+
+        for (auto&& producer : producers)
+        {
+            producer.join();
+        }
+
+        while (remain.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * total_task);
+}
+
+static void BM_StaticThreadPoolContention(benchmark::State& state)
+{
+    run_producers<StaticThreadPool<2>>(state);
+}
+BENCHMARK(BM_StaticThreadPoolContention)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+static void BM_BoundedStaticThreadPoolContention(benchmark::State& state)
+{
+    run_producers<StaticThreadPool<2, BoundedThreadPoolPolicy<1024>>>(state);
+}
+BENCHMARK(BM_BoundedStaticThreadPoolContention)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
+
+static void BM_WorkStealingThreadPoolContention(benchmark::State& state)
+{
+    run_producers<WorkStealingThreadPool<2>>(state);
+}
+BENCHMARK(BM_WorkStealingThreadPoolContention)->RangeMultiplier(2)->Range(1, 64)->UseRealTime();
@@ -0,0 +1,93 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <shared_mutex>
+
+#include "benchmark/benchmark.h"
+
+#include "container/array.hpp"
+#include "container/concurrent_unordered_map.hpp"
+#include "container/unordered_map.hpp"
+#include "string/string.hpp"
+
+using namespace atlas;
+
+#define KEY_COUNT 1024
+
+static void make_path_map(UnorderedMap<String, int32>& map, Array<std::string>& keys)
+{
+    for (int32 i = 0; i < KEY_COUNT; ++i)
+    {
+        String key = String::format("content/textures/environment/texture_{}.png", i);
+        keys.add(std::string(key.data(), key.size()));
+        map.insert(std::move(key), i);
+    }
+}
+
+static void BM_UnorderedMapFindByString(benchmark::State& state)
+{
+    UnorderedMap<String, int32> map;
+    Array<std::string> keys;
+    make_path_map(map, keys);
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        // what lookups with a view cost before the map was transparent.
+        const std::string& key = keys[index++ % KEY_COUNT];
+        benchmark::DoNotOptimize(map.find_value(String(StringView(key.data(), key.size()))));
+    }
+}
+BENCHMARK(BM_UnorderedMapFindByString);
+
+static void BM_UnorderedMapFindByView(benchmark::State& state)
+{
+    UnorderedMap<String, int32> map;
+    Array<std::string> keys;
+    make_path_map(map, keys);
+    size_t index = 0;
+    for (auto _ : state)
+    {
+        const std::string& key = keys[index++ % KEY_COUNT];
+        benchmark::DoNotOptimize(map.find_value(StringView(key.data(), key.size())));
+    }
+}
+BENCHMARK(BM_UnorderedMapFindByView);
+
+static void BM_SharedMutexUnorderedMapFind(benchmark::State& state)
+{
+    // what registries guarded by a single reader writer lock cost when every thread reads.
+    static std::shared_mutex mutex;
+    static UnorderedMap<uint32, int32> map;
+    if (state.thread_index() == 0)
+    {
+        for (int32 i = 0; i < KEY_COUNT; ++i)
+        {
+            map.insert(i, i);
+        }
+    }
+    uint32 key = state.thread_index();
+    for (auto _ : state)
+    {
+        std::shared_lock lock(mutex);
+        benchmark::DoNotOptimize(map.find_value(key++ % KEY_COUNT));
+    }
+}
+BENCHMARK(BM_SharedMutexUnorderedMapFind)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_ConcurrentUnorderedMapFind(benchmark::State& state)
+{
+    static ConcurrentUnorderedMap<uint32, int32> map;
+    if (state.thread_index() == 0)
+    {
+        for (int32 i = 0; i < KEY_COUNT; ++i)
+        {
+            map.insert(i, i);
+        }
+    }
+    uint32 key = state.thread_index();
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(map.find_value(key++ % KEY_COUNT));
+    }
+}
+BENCHMARK(BM_ConcurrentUnorderedMapFind)->ThreadRange(1, 8)->UseRealTime();
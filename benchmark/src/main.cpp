@@ -0,0 +1,6 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "benchmark/benchmark.h"
+
+BENCHMARK_MAIN();
\ No newline at end of file
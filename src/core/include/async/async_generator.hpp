@@ -0,0 +1,249 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "async/task.hpp"
+
+namespace atlas
+{
+
+template<typename T>
+class AsyncGenerator;
+
+namespace details
+{
+
+template<typename T>
+class AsyncGeneratorPromise
+{
+    /**
+     * @brief Suspends the generator and transfers execution to the consumer waiting for the next value.
+     */
+    struct YieldAwaiter
+    {
+        constexpr bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<AsyncGeneratorPromise> generator) const noexcept
+        {
+            std::coroutine_handle<> consumer = std::exchange(generator.promise().consumer_, nullptr);
+            return consumer ? consumer : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+public:
+    using value_type = std::remove_reference_t<T>;
+
+    AsyncGeneratorPromise() = default;
+
+    static void* operator new(size_t size)
+    {
+        return CoroutineFrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr)
+    {
+        CoroutineFrameAllocator::deallocate(ptr);
+    }
+
+    AsyncGenerator<T> get_return_object();
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    YieldAwaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    /**
+     * @brief The yielded value lives in the generator frame until the generator is resumed, it is never copied.
+     * @param value
+     * @return
+     */
+    YieldAwaiter yield_value(value_type& value) noexcept
+    {
+        value_ = std::addressof(value);
+        return {};
+    }
+
+    YieldAwaiter yield_value(value_type&& value) noexcept
+    {
+        value_ = std::addressof(value);
+        return {};
+    }
+
+    void return_void() noexcept
+    {
+        value_ = nullptr;
+    }
+
+    void unhandled_exception()
+    {
+        LOG_CRITICAL(core, "Fatal exception in coroutine");
+        std::terminate();
+    }
+
+    template<typename TaskType>
+    auto await_transform(TaskType&& task) requires(std::is_base_of_v<TaskPromiseBase, typename TaskType::promise_type>)
+    {
+        task.set_stop_token(stop_token_);
+        return TaskAwaiter<typename TaskType::promise_type>(task.co_handle());
+    }
+
+    template<Awaitable AwaiterType>
+    AwaiterType await_transform(AwaiterType&& awaiter)
+    {
+        return awaiter;
+    }
+
+    NODISCARD const StopToken& get_stop_token() const
+    {
+        return stop_token_;
+    }
+
+    void set_stop_token(const StopToken& token)
+    {
+        stop_token_ = token;
+    }
+
+    void set_consumer(std::coroutine_handle<> consumer)
+    {
+        consumer_ = consumer;
+    }
+
+    NODISCARD value_type* get_value() const
+    {
+        return value_;
+    }
+
+private:
+    value_type* value_{ nullptr };
+    std::coroutine_handle<> consumer_{ nullptr };
+    StopToken stop_token_;
+};
+
+template<typename T>
+class AsyncGeneratorNextAwaiter
+{
+public:
+    using handle_type = std::coroutine_handle<AsyncGeneratorPromise<T>>;
+    using value_type = typename AsyncGeneratorPromise<T>::value_type;
+
+    explicit AsyncGeneratorNextAwaiter(handle_type generator) noexcept : generator_(generator) {}
+
+    AsyncGeneratorNextAwaiter(AsyncGeneratorNextAwaiter&& rhs) noexcept : generator_(std::exchange(rhs.generator_, nullptr)) {}
+
+    AsyncGeneratorNextAwaiter(const AsyncGeneratorNextAwaiter&) = delete;
+    AsyncGeneratorNextAwaiter& operator=(const AsyncGeneratorNextAwaiter&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return !generator_ || generator_.done();
+    }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> consumer) noexcept
+    {
+        if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>)
+        {
+            generator_.promise().set_stop_token(consumer.promise().get_stop_token());
+        }
+        generator_.promise().set_consumer(consumer);
+        return generator_;
+    }
+
+    /**
+     * @return The yielded value, or nullptr once the generator has finished.
+     */
+    value_type* await_resume() const noexcept
+    {
+        return generator_ && !generator_.done() ? generator_.promise().get_value() : nullptr;
+    }
+
+private:
+    handle_type generator_;
+};
+
+}// namespace details
+
+/**
+ * @brief A coroutine that produces a sequence of values asynchronously. It may co_await tasks and other awaitables
+ * between co_yield.
+ * The generator is lazy: it runs only while the consumer waits for the next value and suspends at every co_yield,
+ * so a slow consumer throttles the producer and at most one value is in flight.
+ * Usage:
+ * @code
+ * AsyncGenerator<IOBuffer> chunks = llio.async_read_chunks(path, 64 * 1024);
+ * while (IOBuffer* chunk = co_await chunks.next())
+ * {
+ *     process(*chunk);
+ * }
+ * @endcode
+ * @tparam T
+ */
+template<typename T>
+class AsyncGenerator
+{
+public:
+    using promise_type = details::AsyncGeneratorPromise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    AsyncGenerator() = default;
+
+    explicit AsyncGenerator(handle_type handle) noexcept : handle_(handle) {}
+
+    AsyncGenerator(AsyncGenerator&& rhs) noexcept : handle_(std::exchange(rhs.handle_, nullptr)) {}
+
+    AsyncGenerator(const AsyncGenerator&) = delete;
+    AsyncGenerator& operator=(const AsyncGenerator&) = delete;
+
+    AsyncGenerator& operator=(AsyncGenerator&& rhs) noexcept
+    {
+        AsyncGenerator(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Destroys the generator frame, it must be suspended at a co_yield or not be started.
+     */
+    ~AsyncGenerator()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    /**
+     * @brief Resumes the generator until it yields the next value or finishes. Only one consumer may wait at a time.
+     * @return An awaitable that produces a pointer to the value, valid until next is awaited again, or nullptr once
+     * the generator has finished.
+     */
+    details::AsyncGeneratorNextAwaiter<T> next() noexcept
+    {
+        return details::AsyncGeneratorNextAwaiter<T>(handle_);
+    }
+
+    NODISCARD bool is_done() const noexcept
+    {
+        return !handle_ || handle_.done();
+    }
+
+    void swap(AsyncGenerator& rhs) noexcept
+    {
+        std::swap(handle_, rhs.handle_);
+    }
+
+private:
+    handle_type handle_{ nullptr };
+};
+
+template<typename T>
+AsyncGenerator<T> details::AsyncGeneratorPromise<T>::get_return_object()
+{
+    return AsyncGenerator<T>(std::coroutine_handle<AsyncGeneratorPromise<T>>::from_promise(*this));
+}
+
+}// namespace atlas
@@ -0,0 +1,421 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <type_traits>
+
+#include "core_def.hpp"
+#include "assertion.hpp"
+#include "async/thread_pool_scheduler.hpp"
+
+namespace atlas
+{
+
+template<typename T>
+class Channel;
+
+namespace details
+{
+
+template<typename T>
+class ChannelSendAwaiter
+{
+    friend class Channel<T>;
+public:
+    ChannelSendAwaiter(Channel<T>& channel, T&& value) : channel_(&channel), value_(std::move(value)) {}
+
+    ChannelSendAwaiter(ChannelSendAwaiter&& rhs) noexcept
+        : channel_(std::exchange(rhs.channel_, nullptr))
+        , value_(std::move(rhs.value_))
+    {}
+
+    ChannelSendAwaiter(const ChannelSendAwaiter&) = delete;
+    ChannelSendAwaiter& operator=(const ChannelSendAwaiter&) = delete;
+
+    constexpr bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
+    {
+        continuation_ = handle;
+        return channel_->suspend_sender(this);
+    }
+
+    /**
+     * @return False if the channel was closed, the value has been dropped.
+     */
+    bool await_resume() const noexcept
+    {
+        return sent_;
+    }
+
+private:
+    Channel<T>* channel_;
+    T value_;
+    std::coroutine_handle<> continuation_{ nullptr };
+    std::optional<ThreadPoolScheduler::ScheduleOperation> resume_operation_;
+    ChannelSendAwaiter* next_{ nullptr };
+    bool sent_{ false };
+};
+
+template<typename T>
+class ChannelReceiveAwaiter
+{
+    friend class Channel<T>;
+public:
+    explicit ChannelReceiveAwaiter(Channel<T>& channel) noexcept : channel_(&channel) {}
+
+    ChannelReceiveAwaiter(ChannelReceiveAwaiter&& rhs) noexcept : channel_(std::exchange(rhs.channel_, nullptr)) {}
+
+    ChannelReceiveAwaiter(const ChannelReceiveAwaiter&) = delete;
+    ChannelReceiveAwaiter& operator=(const ChannelReceiveAwaiter&) = delete;
+
+    constexpr bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> handle)
+    {
+        continuation_ = handle;
+        return channel_->suspend_receiver(this);
+    }
+
+    /**
+     * @return The received value, or nullopt once the channel is closed and drained.
+     */
+    std::optional<T> await_resume() noexcept
+    {
+        return std::move(value_);
+    }
+
+private:
+    Channel<T>* channel_;
+    std::optional<T> value_;
+    std::coroutine_handle<> continuation_{ nullptr };
+    std::optional<ThreadPoolScheduler::ScheduleOperation> resume_operation_;
+    ChannelReceiveAwaiter* next_{ nullptr };
+};
+
+}// namespace details
+
+/**
+ * @brief Bounded multi producer multi consumer channel between coroutines.
+ * A sender suspends while the buffer is full and a receiver suspends while it is empty, so stages of a pipeline run
+ * concurrently with at most capacity values between them. Waiting coroutines are linked intrusively through their
+ * awaiters, the channel allocates only through its buffer.
+ * With a scheduler, a coroutine that wakes another one transfers control to it and continues on the scheduler, and
+ * try_send, try_receive and close schedule the coroutines they wake. Without one, a woken coroutine is resumed inline
+ * on the thread that wakes it, after the lock has been released.
+ * Usage:
+ * @code
+ * Channel<IOBuffer> chunks(4);
+ * // producer
+ * co_await chunks.send(std::move(chunk));
+ * chunks.close();
+ * // consumer
+ * while (std::optional<IOBuffer> chunk = co_await chunks.receive())
+ * {
+ *     process(*chunk);
+ * }
+ * @endcode
+ * @tparam T
+ */
+template<typename T>
+class Channel
+{
+    using send_awaiter = details::ChannelSendAwaiter<T>;
+    using receive_awaiter = details::ChannelReceiveAwaiter<T>;
+    friend class details::ChannelSendAwaiter<T>;
+    friend class details::ChannelReceiveAwaiter<T>;
+public:
+    /**
+     * @brief Constructs a channel.
+     * @param capacity Number of values buffered without a receiver, zero makes every send wait for a receiver.
+     * @param scheduler Resumes the coroutines woken by the channel, must outlive it. Null resumes them inline.
+     */
+    explicit Channel(size_t capacity, ThreadPoolScheduler* scheduler = nullptr) : capacity_(capacity), scheduler_(scheduler) {}
+
+    Channel(const Channel&) = delete;
+    Channel(Channel&&) = delete;
+    Channel& operator=(const Channel&) = delete;
+    Channel& operator=(Channel&&) = delete;
+
+    ~Channel()
+    {
+        ASSERT(!waiting_senders_ && !waiting_receivers_);
+    }
+
+    /**
+     * @brief Sends a value, suspends while the channel is full.
+     * @param value
+     * @return An awaitable that produces false if the channel was closed.
+     */
+    send_awaiter send(T value)
+    {
+        return send_awaiter(*this, std::move(value));
+    }
+
+    /**
+     * @brief Receives a value, suspends while the channel is empty and open.
+     * @return An awaitable that produces nullopt once the channel is closed and every value has been received.
+     */
+    receive_awaiter receive() noexcept
+    {
+        return receive_awaiter(*this);
+    }
+
+    /**
+     * @brief Sends a value if it does not need to wait.
+     * @param value Left untouched on failure.
+     * @return
+     */
+    bool try_send(T& value)
+    {
+        std::unique_lock lock(mutex_);
+        if (closed_)
+        {
+            return false;
+        }
+        if (receive_awaiter* receiver = pop_waiter(waiting_receivers_))
+        {
+            receiver->value_.emplace(std::move(value));
+            lock.unlock();
+            wake(receiver);
+            return true;
+        }
+        if (buffer_.size() < capacity_)
+        {
+            buffer_.push(std::move(value));
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Receives a value if one is available.
+     * @return
+     */
+    std::optional<T> try_receive()
+    {
+        receive_awaiter receiver(*this);
+        std::unique_lock lock(mutex_);
+        send_awaiter* sender = take_value(receiver);
+        lock.unlock();
+        if (sender)
+        {
+            wake(sender);
+        }
+        return std::move(receiver.value_);
+    }
+
+    /**
+     * @brief Closes the channel. Pending and later sends fail, receivers drain the buffered values and then get
+     * nullopt.
+     */
+    void close()
+    {
+        std::unique_lock lock(mutex_);
+        closed_ = true;
+        send_awaiter* senders = std::exchange(waiting_senders_, nullptr);
+        receive_awaiter* receivers = std::exchange(waiting_receivers_, nullptr);
+        waiting_senders_tail_ = nullptr;
+        waiting_receivers_tail_ = nullptr;
+        lock.unlock();
+
+        // senders only wait while the buffer is full, so waiting receivers never have a value to drain.
+        wake_all(senders);
+        wake_all(receivers);
+    }
+
+    NODISCARD bool is_closed() const
+    {
+        std::lock_guard lock(mutex_);
+        return closed_;
+    }
+
+    NODISCARD size_t capacity() const
+    {
+        return capacity_;
+    }
+
+private:
+    template<typename Awaiter>
+    static void push_waiter(Awaiter*& head, Awaiter*& tail, Awaiter* waiter)
+    {
+        waiter->next_ = nullptr;
+        if (tail)
+        {
+            tail->next_ = waiter;
+        }
+        else
+        {
+            head = waiter;
+        }
+        tail = waiter;
+    }
+
+    template<typename Awaiter>
+    Awaiter* pop_waiter(Awaiter*& head)
+    {
+        Awaiter* waiter = head;
+        if (waiter)
+        {
+            head = waiter->next_;
+            if (!head)
+            {
+                if constexpr (std::is_same_v<Awaiter, send_awaiter>)
+                {
+                    waiting_senders_tail_ = nullptr;
+                }
+                else
+                {
+                    waiting_receivers_tail_ = nullptr;
+                }
+            }
+        }
+        return waiter;
+    }
+
+    /**
+     * @brief Resumes a waiting coroutine on the scheduler, or inline without one.
+     * @param waiter Must not be touched afterwards, it lives in the frame of the woken coroutine.
+     */
+    template<typename Awaiter>
+    void wake(Awaiter* waiter)
+    {
+        if (scheduler_)
+        {
+            waiter->resume_operation_.emplace(*scheduler_);
+            waiter->resume_operation_->await_suspend(waiter->continuation_);
+        }
+        else
+        {
+            waiter->continuation_.resume();
+        }
+    }
+
+    /**
+     * @brief Transfers control from the coroutine that woke another one to the woken one.
+     * @param self The awaiter of the calling coroutine, which continues on the scheduler.
+     * @param woken
+     * @return The coroutine await_suspend resumes.
+     */
+    template<typename SelfAwaiter, typename Awaiter>
+    std::coroutine_handle<> transfer(SelfAwaiter* self, Awaiter* woken)
+    {
+        if (!scheduler_)
+        {
+            const std::coroutine_handle<> continuation = self->continuation_;
+            woken->continuation_.resume();
+            return continuation;
+        }
+
+        // self may be resumed by a worker as soon as it is scheduled, read the woken handle first.
+        const std::coroutine_handle<> woken_continuation = woken->continuation_;
+        wake(self);
+        return woken_continuation;
+    }
+
+    template<typename Awaiter>
+    void wake_all(Awaiter* waiter)
+    {
+        while (waiter)
+        {
+            // the awaiter lives in the coroutine frame, unlink it before resuming.
+            Awaiter* next = waiter->next_;
+            wake(waiter);
+            waiter = next;
+        }
+    }
+
+    /**
+     * @brief Moves the next value into the receiver, refills the buffer from the first waiting sender.
+     * @return The sender to resume after the lock has been released.
+     */
+    send_awaiter* take_value(receive_awaiter& receiver)
+    {
+        if (!buffer_.empty())
+        {
+            receiver.value_.emplace(std::move(buffer_.front()));
+            buffer_.pop();
+            if (send_awaiter* sender = pop_waiter(waiting_senders_))
+            {
+                buffer_.push(std::move(sender->value_));
+                sender->sent_ = true;
+                return sender;
+            }
+        }
+        else if (send_awaiter* sender = pop_waiter(waiting_senders_))
+        {
+            receiver.value_.emplace(std::move(sender->value_));
+            sender->sent_ = true;
+            return sender;
+        }
+        return nullptr;
+    }
+
+    std::coroutine_handle<> suspend_sender(send_awaiter* sender)
+    {
+        std::unique_lock lock(mutex_);
+        if (closed_)
+        {
+            return sender->continuation_;
+        }
+
+        if (receive_awaiter* receiver = pop_waiter(waiting_receivers_))
+        {
+            receiver->value_.emplace(std::move(sender->value_));
+            sender->sent_ = true;
+            lock.unlock();
+            return transfer(sender, receiver);
+        }
+
+        if (buffer_.size() < capacity_)
+        {
+            buffer_.push(std::move(sender->value_));
+            sender->sent_ = true;
+            return sender->continuation_;
+        }
+
+        push_waiter(waiting_senders_, waiting_senders_tail_, sender);
+        return std::noop_coroutine();
+    }
+
+    std::coroutine_handle<> suspend_receiver(receive_awaiter* receiver)
+    {
+        std::unique_lock lock(mutex_);
+        if (send_awaiter* sender = take_value(*receiver))
+        {
+            lock.unlock();
+            return transfer(receiver, sender);
+        }
+
+        if (receiver->value_ || closed_)
+        {
+            return receiver->continuation_;
+        }
+
+        push_waiter(waiting_receivers_, waiting_receivers_tail_, receiver);
+        return std::noop_coroutine();
+    }
+
+    mutable std::mutex mutex_;
+    const size_t capacity_;
+    ThreadPoolScheduler* scheduler_;
+    std::queue<T> buffer_;
+    send_awaiter* waiting_senders_{ nullptr };
+    send_awaiter* waiting_senders_tail_{ nullptr };
+    receive_awaiter* waiting_receivers_{ nullptr };
+    receive_awaiter* waiting_receivers_tail_{ nullptr };
+    bool closed_{ false };
+};
+
+}// namespace atlas
@@ -0,0 +1,42 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Allocates coroutine frames from thread local free lists of size classes.
+ * A frame freed on the thread that allocated it goes back to the local free list, a frame freed on another thread is
+ * pushed to a lock free return list of the owner, which is drained when the owner runs out of local frames. Both lists
+ * hold at most max_cached_frames per size class. The cache of an exited thread is adopted by the next new thread.
+ * Frames larger than max_pooled_size, or allocated while the thread exits, fall back to Memory::malloc.
+ */
+class CORE_API CoroutineFrameAllocator
+{
+public:
+    static constexpr size_t size_class_granularity = 64;
+    static constexpr size_t max_pooled_size = 2048;
+    /** Max number of free frames kept in each local and return list, extra frames are released to Memory::free. */
+    static constexpr uint32 max_cached_frames = 256;
+
+    CoroutineFrameAllocator() = delete;
+
+    /**
+     * @brief Allocates a coroutine frame.
+     * @param size
+     * @return
+     */
+    static void* allocate(size_t size);
+
+    /**
+     * @brief Frees a coroutine frame allocated by allocate, from any thread.
+     * @param ptr
+     */
+    static void deallocate(void* ptr);
+};
+
+}// namespace atlas
@@ -0,0 +1,314 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <ranges>
+#include <span>
+
+#include "async/work_stealing_thread_pool.hpp"
+#include "container/array.hpp"
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Shared worker pool of parallel_for, parallel_reduce and parallel_sort.
+ * Worker count is configured by "async.parallel_worker_count", zero means one worker per extra hardware thread.
+ */
+class CORE_API ParallelWorkerPool
+{
+public:
+    using thread_pool_type = WorkStealingThreadPool<1>;
+
+    ParallelWorkerPool() = delete;
+
+    static thread_pool_type& get();
+};
+
+namespace details
+{
+
+/**
+ * @brief State shared by the calling thread and the helper tasks of one parallel loop.
+ * The caller and every helper claim chunks from the same index until the range is exhausted. Chunks shrink as the
+ * range drains, so late participants still find work and the tail is balanced. Helpers may start after the loop
+ * has completed, so the state is reference counted and a helper never touches the body before it claimed a chunk.
+ */
+template<typename Body>
+struct ParallelForState
+{
+    ParallelForState(size_t count, size_t grain, uint32 participant_count, Body& body)
+        : count(count)
+        , grain(grain)
+        , participant_count(participant_count)
+        , uses(participant_count)
+        , body(body)
+    {}
+
+    /**
+     * @brief Claims the next chunk. Claims release and observe acquire, so whoever sees the range exhausted also sees
+     * the active count of every participant that claimed a chunk, and wait cannot miss one still running.
+     */
+    bool claim(size_t& begin, size_t& end)
+    {
+        size_t current = next.load(std::memory_order_acquire);
+        while (current < count)
+        {
+            const size_t remaining = count - current;
+            const size_t chunk = std::min(remaining, std::max(grain, remaining / (2 * participant_count)));
+            if (next.compare_exchange_weak(current, current + chunk, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                begin = current;
+                end = current + chunk;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run()
+    {
+        active.fetch_add(1, std::memory_order_seq_cst);
+        size_t begin, end;
+        while (claim(begin, end))
+        {
+            body(begin, end);
+        }
+        if (active.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            active.notify_one();
+        }
+    }
+
+    /**
+     * @brief Called by the caller after its own run, every chunk has been claimed by then. The acquire load of the
+     * last decrement makes the writes of every body visible before the loop returns.
+     */
+    void wait()
+    {
+        uint32 current = active.load(std::memory_order_acquire);
+        while (current != 0)
+        {
+            active.wait(current, std::memory_order_acquire);
+            current = active.load(std::memory_order_acquire);
+        }
+    }
+
+    void release()
+    {
+        if (uses.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    const size_t count;
+    const size_t grain;
+    const uint32 participant_count;
+    std::atomic<uint32> uses;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_t> next{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> active{ 0 };
+    Body& body;
+};
+
+template<typename Body>
+void parallel_for_chunks(size_t count, size_t grain, Body& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grain = std::max<size_t>(grain, 1);
+    ParallelWorkerPool::thread_pool_type& pool = ParallelWorkerPool::get();
+    const size_t max_helpers = (count - 1) / grain;
+    const uint32 helper_count = static_cast<uint32>(std::min<size_t>(pool.worker_count(), max_helpers));
+    if (helper_count == 0)
+    {
+        body(0, count);
+        return;
+    }
+
+    auto state = new ParallelForState<Body>(count, grain, helper_count + 1, body);
+    for (uint32 i = 0; i < helper_count; ++i)
+    {
+        pool.push_task([state]() {
+            state->run();
+            state->release();
+        });
+    }
+
+    // The caller always takes part, so a loop nested in a worker of the pool completes even if no helper starts.
+    state->run();
+    state->wait();
+    state->release();
+}
+
+/**
+ * @brief Splits the k first merged elements of a and b between them, elements of a go first on ties.
+ * @return Number of elements taken from a.
+ */
+template<typename T, typename Compare>
+size_t merge_co_rank(size_t k, std::span<const T> a, std::span<const T> b, Compare& comp)
+{
+    size_t low = k > b.size() ? k - b.size() : 0;
+    size_t high = std::min(k, a.size());
+    while (low < high)
+    {
+        const size_t i = low + (high - low) / 2;
+        const size_t j = k - i;
+        if (j > 0 && !comp(b[j - 1], a[i]))
+        {
+            low = i + 1;
+        }
+        else
+        {
+            high = i;
+        }
+    }
+    return low;
+}
+
+}// namespace details
+
+/**
+ * @brief Calls fn(begin, end) on disjoint chunks of [0, count) on the calling thread and the parallel worker pool,
+ * returns after every chunk has been processed. Chunk size adapts to the remaining work, never below grain.
+ * @param count
+ * @param grain Minimal number of indices in a chunk, should amortize the cost of claiming a chunk.
+ * @param fn
+ */
+template<typename Fn> requires std::invocable<Fn&, size_t, size_t>
+void parallel_for(size_t count, size_t grain, Fn&& fn)
+{
+    details::parallel_for_chunks(count, grain, fn);
+}
+
+/**
+ * @brief Calls fn(element) on every element of a contiguous range in parallel.
+ * @param range
+ * @param grain Minimal number of elements in a chunk.
+ * @param fn
+ */
+template<std::ranges::contiguous_range Range, typename Fn>
+    requires std::invocable<Fn&, std::ranges::range_reference_t<Range>>
+void parallel_for(Range&& range, size_t grain, Fn&& fn)
+{
+    auto data = std::ranges::data(range);
+    auto body = [data, &fn](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            std::invoke(fn, data[i]);
+        }
+    };
+    details::parallel_for_chunks(static_cast<size_t>(std::ranges::size(range)), grain, body);
+}
+
+/**
+ * @brief Reduces [0, count) in parallel. Every chunk is reduced by map(begin, end) without any lock, then combined into
+ * the result with reduce under a lock, in no particular order.
+ * @param count
+ * @param grain Minimal number of indices in a chunk.
+ * @param identity
+ * @param map Returns the reduction of a chunk.
+ * @param reduce Must be associative and commutative.
+ * @return
+ */
+template<typename T, typename MapFn, typename ReduceFn>
+    requires std::invocable<MapFn&, size_t, size_t> && std::invocable<ReduceFn&, T, T>
+T parallel_reduce(size_t count, size_t grain, T identity, MapFn&& map, ReduceFn&& reduce)
+{
+    std::mutex mutex;
+    T result = identity;
+    auto body = [&](size_t begin, size_t end) {
+        T partial = std::invoke(map, begin, end);
+        std::lock_guard lock(mutex);
+        result = std::invoke(reduce, std::move(result), std::move(partial));
+    };
+    details::parallel_for_chunks(count, grain, body);
+    return result;
+}
+
+/**
+ * @brief Sorts a range with a parallel merge sort. Blocks are sorted concurrently, then merged in rounds where
+ * every merge is split further by output position, so the last round is parallel as well.
+ * The sort is not stable. Allocates a buffer of the same size, T must be default constructible and movable.
+ * @param range
+ * @param comp
+ * @param grain Ranges smaller than this are sorted serially.
+ */
+template<typename T, typename Compare = std::less<>>
+void parallel_sort(std::span<T> range, Compare comp = {}, size_t grain = 2048)
+{
+    const size_t count = range.size();
+    const size_t worker_count = ParallelWorkerPool::get().worker_count();
+    if (count <= grain || worker_count == 0)
+    {
+        std::sort(range.begin(), range.end(), comp);
+        return;
+    }
+
+    const size_t block_count = std::min<size_t>((worker_count + 1) * 2, (count + grain - 1) / grain);
+    const size_t block_size = (count + block_count - 1) / block_count;
+    parallel_for(block_count, 1, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            const size_t first = block * block_size;
+            const size_t last = std::min(first + block_size, count);
+            std::sort(range.begin() + first, range.begin() + last, comp);
+        }
+    });
+
+    Array<T> buffer;
+    buffer.resize(count);
+    std::span<T> source = range;
+    std::span<T> target(buffer.data(), count);
+    for (size_t width = block_size; width < count; width *= 2)
+    {
+        parallel_for(count, grain, [&](size_t begin, size_t end) {
+            // merges every pair of runs overlapping the output range [begin, end).
+            for (size_t pair = begin / (2 * width) * (2 * width); pair < end; pair += 2 * width)
+            {
+                const size_t middle = std::min(pair + width, count);
+                std::span<const T> a(source.data() + pair, middle - pair);
+                std::span<const T> b(source.data() + middle, std::min(pair + 2 * width, count) - middle);
+                const size_t k_begin = std::max(begin, pair) - pair;
+                const size_t k_end = std::min(end, pair + a.size() + b.size()) - pair;
+                const size_t i_begin = details::merge_co_rank(k_begin, a, b, comp);
+                const size_t i_end = details::merge_co_rank(k_end, a, b, comp);
+                std::merge(std::make_move_iterator(source.begin() + pair + i_begin),
+                           std::make_move_iterator(source.begin() + pair + i_end),
+                           std::make_move_iterator(source.begin() + middle + (k_begin - i_begin)),
+                           std::make_move_iterator(source.begin() + middle + (k_end - i_end)),
+                           target.begin() + pair + k_begin, comp);
+            }
+        });
+        std::swap(source, target);
+    }
+
+    if (source.data() != range.data())
+    {
+        parallel_for(count, grain, [&](size_t begin, size_t end) {
+            std::move(source.begin() + begin, source.begin() + end, range.begin() + begin);
+        });
+    }
+}
+
+/**
+ * @brief Sorts an array with a parallel merge sort.
+ * @param array
+ * @param comp
+ */
+template<typename T, typename Compare = std::less<>>
+void parallel_sort(Array<T>& array, Compare comp = {})
+{
+    parallel_sort(std::span<T>(array.data(), array.size()), std::move(comp));
+}
+
+}// namespace atlas
@@ -6,6 +6,7 @@
 #include <queue>
 
 #include "async/thread.hpp"
+#include "concurrency/ring_queue.hpp"
 #include "container/array.hpp"
 #include "core_def.hpp"
 #include "platform/platform_fwd.hpp"
@@ -18,20 +19,60 @@ struct CORE_API ThreadPoolPolicy
     using task_type = std::move_only_function<void()>;
 };
 
+/**
+ * @brief Backs every queue of StaticThreadPool with a fixed capacity MPMCRingQueue instead of a mutex guarded
+ * std::queue. Queueing a task takes no lock and the queue never allocates, a full queue pushes back on the producer.
+ * @tparam QueueCapacity Must be a power of two.
+ */
+template<size_t QueueCapacity>
+struct BoundedThreadPoolPolicy : ThreadPoolPolicy
+{
+    static constexpr size_t queue_capacity = QueueCapacity;
+};
+
+namespace details
+{
+
+template<typename Policy>
+struct ThreadPoolQueue
+{
+    using type = std::queue<typename Policy::task_type>;
+};
+
+template<typename Policy> requires requires { Policy::queue_capacity; }
+struct ThreadPoolQueue<Policy>
+{
+    using type = MPMCRingQueue<typename Policy::task_type, Policy::queue_capacity>;
+};
+
+}// namespace details
+
 template<uint32 NumOfQueues, typename Policy = ThreadPoolPolicy> requires(std::invocable<typename Policy::task_type>)
 class StaticThreadPool
 {
+    static constexpr bool is_bounded = requires { Policy::queue_capacity; };
+    using queue_type = typename details::ThreadPoolQueue<Policy>::type;
 public:
     using task_type = typename Policy::task_type;
 
     StaticThreadPool() = default;
 
     StaticThreadPool(size_t size, StringView work_thread_name = "")
+        : StaticThreadPool(size, ThreadAffinityPolicy{}, work_thread_name)
+    {}
+
+    /**
+     * @brief Creates the workers, each of them applies affinity and priority to itself before running any task.
+     * @param size
+     * @param affinity
+     * @param work_thread_name
+     */
+    StaticThreadPool(size_t size, const ThreadAffinityPolicy& affinity, StringView work_thread_name = "")
     {
         threads_.reserve(size);
         for (uint32 i = 0; i < size; ++i)
         {
-            create_thread(work_thread_name);
+            create_thread(work_thread_name, affinity);
         }
     }
 
@@ -51,7 +92,7 @@ public:
         std::mutex mutex_ = std::move(rhs.mutex_);
         std::condition_variable new_request_ = std::move(rhs.awake_signal_);
         Array<std::thread> threads_ = std::move(rhs.threads_);
-        std::queue<task_type> priority_queue_[NumOfQueues] = std::move(rhs.priority_queue_);
+        queue_type priority_queue_[NumOfQueues] = std::move(rhs.priority_queue_);
 
         return *this;
     }
@@ -85,15 +126,59 @@ public:
         emplace_task(0, std::move(task));
     }
 
+    /**
+     * @brief Queues a task. With a bounded policy, it yields until a worker frees a slot if the queue is full, so
+     * a worker must not push to its own full pool.
+     * @param queue_index
+     * @param args
+     */
     template<typename... Args>
     void emplace_task(uint32 queue_index, Args&&... args)
     {
         ASSERT(queue_index< NumOfQueues && !threads_.is_empty());
+        if constexpr (is_bounded)
+        {
+            while (!try_emplace_task(queue_index, std::forward<Args>(args)...))
+            {
+                std::this_thread::yield();
+            }
+        }
+        else
+        {
+            {
+                std::lock_guard lock(mutex_);
+                priority_queue_[queue_index].emplace(std::forward<Args>(args)...);
+            }
+            awake_signal_.notify_one();
+        }
+    }
+
+    bool try_push_task(uint32 queue_index, const task_type& task) requires is_bounded
+    {
+        return try_emplace_task(queue_index, task);
+    }
+
+    bool try_push_task(uint32 queue_index, task_type&& task) requires is_bounded
+    {
+        return try_emplace_task(queue_index, std::move(task));
+    }
+
+    /**
+     * @brief Queues a task if the bounded queue is not full.
+     * @param queue_index
+     * @param args
+     * @return False if queue is full, args are left untouched.
+     */
+    template<typename... Args>
+    bool try_emplace_task(uint32 queue_index, Args&&... args) requires is_bounded
+    {
+        ASSERT(queue_index< NumOfQueues && !threads_.is_empty());
+        if (!priority_queue_[queue_index].try_emplace(std::forward<Args>(args)...))
         {
-            std::lock_guard lock(mutex_);
-            priority_queue_[queue_index].emplace(std::forward<Args>(args)...);
+            return false;
         }
-        awake_signal_.notify_one();
+        wake_one();
+        return true;
     }
 
     bool request_stop()
@@ -103,11 +188,20 @@ public:
             return false;
         }
 
+        if constexpr (is_bounded)
         {
-            std::lock_guard lock(mutex_);
             stop_source_.request_stop();
+            wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+            wake_epoch_.notify_all(); // wake up all work thread
+        }
+        else
+        {
+            {
+                std::lock_guard lock(mutex_);
+                stop_source_.request_stop();
+            }
+            awake_signal_.notify_all(); // wake up all work thread
         }
-        awake_signal_.notify_all(); // wake up all work thread
         return true;
     }
 
@@ -122,7 +216,7 @@ public:
     }
 
 private:
-    void create_thread(StringView work_thread_name)
+    void create_thread(StringView work_thread_name, const ThreadAffinityPolicy& affinity)
     {
         static const char* default_name = "static thread pool worker";
         if (work_thread_name.empty())
@@ -133,36 +227,76 @@ private:
         size_t current = threads_.size();
         String thread_name = String::format("{}-{}", work_thread_name, current);
 
-        threads_.emplace([this, thread_name](StopToken stoken) {
-            while (true)
+        threads_.emplace([this, thread_name, affinity, current](StopToken stoken) {
+            affinity.apply(static_cast<uint32>(current));
+            if constexpr (is_bounded)
+            {
+                run_bounded(stoken);
+            }
+            else
+            {
+                run(stoken);
+            }
+            LOG_INFO(core, "{} terminated", thread_name)
+        }, stop_source_.get_token());
+
+        PlatformTraits::set_thread_name(threads_.last().native_handle(), thread_name);
+    }
+
+    void run(const StopToken& stoken)
+    {
+        while (true)
+        {
+            std::unique_lock lock(mutex_);
+            if (stoken.stop_requested())
+            {
+                break;
+            }
+
+            std::optional<task_type> task = pop_task();
+            if (!task)
             {
-                std::unique_lock lock(mutex_);
+                awake_signal_.wait(lock);
                 if (stoken.stop_requested())
                 {
                     break;
                 }
+                task = pop_task();
+            }
 
-                std::optional<task_type> task = pop_task();
-                if (!task)
-                {
-                    awake_signal_.wait(lock);
-                    if (stoken.stop_requested())
-                    {
-                        break;
-                    }
-                    task = pop_task();
-                }
+            if (task)
+            {
+                lock.unlock();
+                std::invoke(std::move(*task));
+            }
+        }
+    }
 
-                if (task)
-                {
-                    lock.unlock();
-                    std::invoke(std::move(*task));
-                }
+    void run_bounded(const StopToken& stoken)
+    {
+        while (!stoken.stop_requested())
+        {
+            // Read before popping, a task pushed after this read bumps the epoch and the wait below returns.
+            const uint32 epoch = wake_epoch_.load(std::memory_order_seq_cst);
+            if (std::optional<task_type> task = pop_task())
+            {
+                std::invoke(std::move(*task));
+                continue;
             }
-            LOG_INFO(core, "{} terminated", thread_name)
-        }, stop_source_.get_token());
+            idle_count_.fetch_add(1, std::memory_order_seq_cst);
+            wake_epoch_.wait(epoch, std::memory_order_seq_cst);
+            idle_count_.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
 
-        PlatformTraits::set_thread_name(threads_.last().native_handle(), thread_name);
+    void wake_one()
+    {
+        wake_epoch_.fetch_add(1, std::memory_order_seq_cst);
+        // a worker going idle after this check sees the new epoch and does not block.
+        if (idle_count_.load(std::memory_order_seq_cst) > 0)
+        {
+            wake_epoch_.notify_one();
+        }
     }
 
     std::optional<task_type> pop_task()
@@ -170,7 +304,16 @@ private:
         std::optional<task_type> ret;
         for (uint32 i = 0; i < NumOfQueues; ++i)
         {
-            if (!priority_queue_[i].empty())
+            if constexpr (is_bounded)
+            {
+                task_type task;
+                if (priority_queue_[i].try_pop(task))
+                {
+                    ret = std::move(task);
+                    break;
+                }
+            }
+            else if (!priority_queue_[i].empty())
             {
                 ret = std::move(priority_queue_[i].front());
                 priority_queue_[i].pop();
@@ -185,7 +328,10 @@ private:
     std::mutex mutex_;
     std::condition_variable awake_signal_;
     Array<std::thread> threads_;
-    std::queue<task_type> priority_queue_[NumOfQueues];
+    queue_type priority_queue_[NumOfQueues];
+    /** Bumped by every push to a bounded pool, idle workers wait on it instead of the condition variable. */
+    std::atomic<uint32> wake_epoch_{ 0 };
+    std::atomic<uint32> idle_count_{ 0 };
 };
 
 }// namespace atlas
@@ -3,10 +3,14 @@
 
 #pragma once
 
-#include <future>
+#include <atomic>
 #include <coroutine>
+#include <functional>
+#include <optional>
+#include <thread>
 #include <utility>
 
+#include "async/coroutine_frame_allocator.hpp"
 #include "core_log.hpp"
 #include "utility/delegate_fwd.hpp"
 #include "utility/stop_token.hpp"
@@ -32,37 +36,75 @@ class Task;
 namespace details
 {
 
-struct SharedCoroutineReferenceCounter
+/**
+ * @brief A node of the task completion list. Nodes are linked intrusively and executed once when the task finished.
+ */
+struct TaskCompletionNode
 {
-    std::atomic<uint32> uses = 1;
+    virtual ~TaskCompletionNode() = default;
+
+    virtual void on_completed() = 0;
+
+    TaskCompletionNode* next{ nullptr };
+};
+
+/**
+ * @brief Blocks a thread until task completes, lives on the stack of the waiting thread.
+ * The waiter may wake up as soon as the task completed, so it returns only once the completing thread released the
+ * node after notifying it.
+ */
+struct TaskWaitNode final : public TaskCompletionNode
+{
+    static constexpr uint32 pending = 0;
+    static constexpr uint32 completed = 1;
+    static constexpr uint32 released = 2;
+
+    void on_completed() override
+    {
+        state.store(completed, std::memory_order_release);
+        state.notify_one();
+        // last access to the node.
+        state.store(released, std::memory_order_release);
+    }
+
+    void wait()
+    {
+        state.wait(pending, std::memory_order_acquire);
+        // only spins while the completing thread is inside notify_one.
+        while (state.load(std::memory_order_acquire) != released)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    std::atomic<uint32> state{ pending };
 };
 
+/**
+ * @brief Shares ownership of a coroutine frame, the reference counter is embedded in the promise.
+ * @tparam PromiseType
+ */
+template<typename PromiseType>
 class SharedCoroutineHandle
 {
 public:
+    using handle_type = std::coroutine_handle<PromiseType>;
+
     SharedCoroutineHandle() = default;
 
     explicit SharedCoroutineHandle(std::nullptr_t) {}
 
-    explicit SharedCoroutineHandle(std::coroutine_handle<> handle)
-        : handle_ptr_(handle.address())
-        , counter_(new SharedCoroutineReferenceCounter())
-    {}
-
-    SharedCoroutineHandle(const SharedCoroutineHandle& rhs)
-        : handle_ptr_(rhs.handle_ptr_)
-        , counter_(rhs.counter_)
+    explicit SharedCoroutineHandle(handle_type handle) : handle_(handle)
     {
-        if (counter_)
+        if (handle_)
         {
-            counter_->uses.fetch_add(1, std::memory_order_relaxed);
+            handle_.promise().add_reference();
         }
     }
 
-    SharedCoroutineHandle(SharedCoroutineHandle&& rhs) noexcept
-        : handle_ptr_(std::exchange(rhs.handle_ptr_, nullptr))
-        , counter_(std::exchange(rhs.counter_, nullptr))
-    {}
+    SharedCoroutineHandle(const SharedCoroutineHandle& rhs) : SharedCoroutineHandle(rhs.handle_) {}
+
+    SharedCoroutineHandle(SharedCoroutineHandle&& rhs) noexcept : handle_(std::exchange(rhs.handle_, nullptr)) {}
 
     ~SharedCoroutineHandle()
     {
@@ -95,45 +137,25 @@ public:
 
     void reset()
     {
-        if (counter_)
+        handle_type handle = std::exchange(handle_, nullptr);
+        if (handle && handle.promise().release_reference())
         {
-            const uint32 old = counter_->uses.fetch_sub(1, std::memory_order_acq_rel);
-            if (old == 1)
-            {
-                destroy_handle();
-            }
-            else
-            {
-                handle_ptr_ = nullptr;
-                counter_ = nullptr;
-            }
+            handle.destroy();
         }
     }
 
-    template<typename PromiseType>
-    NODISCARD auto get() const
+    NODISCARD handle_type get() const
     {
-        return handle_ptr_ ? std::coroutine_handle<PromiseType>::from_address(handle_ptr_) : nullptr;
+        return handle_;
     }
 
     void swap(SharedCoroutineHandle& rhs) noexcept
     {
-        std::swap(handle_ptr_, rhs.handle_ptr_);
-        std::swap(counter_, rhs.counter_);
+        std::swap(handle_, rhs.handle_);
     }
 
 private:
-    void destroy_handle()
-    {
-        void* handle = std::exchange(handle_ptr_, nullptr);
-        auto counter = std::exchange(counter_, nullptr);
-        delete counter;
-        auto co_handle = std::coroutine_handle<>::from_address(handle);
-        co_handle.destroy();
-    }
-
-    void* handle_ptr_{ nullptr };
-    SharedCoroutineReferenceCounter* counter_{ nullptr };
+    handle_type handle_{ nullptr };
 };
 
 template<typename PromiseType>
@@ -153,10 +175,16 @@ struct TaskAwaiter
         return false;
     }
 
-    void await_suspend(std::coroutine_handle<> continuation) noexcept
+    /**
+     * @brief Transfers execution to the awaited task instead of resuming it on top of the awaiting coroutine, so a
+     * chain of awaits runs in constant stack space.
+     * @param continuation
+     * @return
+     */
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
     {
         handle_.promise().set_continuation(continuation);
-        handle_.resume();
+        return handle_;
     }
 
     typename PromiseType::value_type await_resume() noexcept
@@ -171,6 +199,12 @@ private:
     std::coroutine_handle<PromiseType> handle_;
 };
 
+/**
+ * @brief Base of task promises.
+ * Completion is an atomic state machine: the completion list is either empty, a lock free stack of nodes waiting for
+ * the task, or the completed tag. Nothing is allocated unless a callback is attached with then(), blocking waiters
+ * use a node on their own stack.
+ */
 class TaskPromiseBase
 {
     struct FinalAwaiter
@@ -178,21 +212,34 @@ class TaskPromiseBase
         constexpr bool await_ready() const noexcept { return false; }
 
         template<typename Promise>
-        void await_suspend(std::coroutine_handle<Promise> coroutine) const noexcept
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coroutine) const noexcept
         {
             TaskPromiseBase& promise = coroutine.promise();
             auto continuation = std::exchange(promise.continuation_, nullptr);
-            promise.shared_handle_.reset();
-            if (continuation)
+            promise.complete();
+            // Drops the reference held by the running coroutine.
+            if (promise.release_reference())
             {
-                continuation.resume();
+                coroutine.destroy();
             }
+            // Transfers to the awaiting coroutine rather than resuming it nested in this frame.
+            return continuation ? continuation : std::noop_coroutine();
         }
 
         void await_resume() const noexcept {}
     };
 public:
-    TaskPromiseBase() : shared_handle_(std::coroutine_handle<TaskPromiseBase>::from_promise(*this)) {}
+    TaskPromiseBase() = default;
+
+    static void* operator new(size_t size)
+    {
+        return CoroutineFrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr)
+    {
+        CoroutineFrameAllocator::deallocate(ptr);
+    }
 
     std::suspend_always initial_suspend() { return {}; }
     FinalAwaiter final_suspend() noexcept
@@ -241,148 +288,203 @@ public:
         continuation_ = continuation;
     }
 
-protected:
-    StopToken stop_token_;
-    SharedCoroutineHandle shared_handle_;
-    std::coroutine_handle<> continuation_{ nullptr };
-};
-
-template<typename T>
-class TaskPromise : public TaskPromiseBase
-{
-    using base = TaskPromiseBase;
-    using base::shared_handle_;
-public:
-    using value_type = T;
+    void add_reference()
+    {
+        uses_.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    TaskPromise() = default;
+    /**
+     * @brief Releases a reference.
+     * @return True if it was the last reference and the coroutine frame should be destroyed.
+     */
+    bool release_reference()
+    {
+        return uses_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
 
-    Task<T> get_return_object()
+    /**
+     * @brief Returns true if the coroutine has completed.
+     * @return
+     */
+    NODISCARD bool is_ready() const
     {
-        return Task<T>(shared_handle_);
+        return completion_list_.load(std::memory_order_acquire) == completed_tag();
     }
 
-    void return_value(T value)
+    /**
+     * @brief Blocks calling thread until the coroutine completes.
+     */
+    void wait()
     {
-        std::unique_lock lock(mutex_);
-        value_ = std::move(value);
-        completion_.notify_all();
-        if (on_completed_.is_empty() || stop_token_.stop_requested())
+        if (is_ready())
         {
             return;
         }
 
-        InlineArray<std::function<void(T)>, 10> invocation = std::move(on_completed_);
-        lock.unlock();
-        for (auto&& fn : invocation)
+        TaskWaitNode node;
+        if (add_completion_node(&node))
         {
-            fn(*value_);
+            node.wait();
         }
     }
 
-    void wait()
+    /**
+     * @brief Links a node into the completion list. The node must stay alive until it was executed.
+     * @param node
+     * @return False if the coroutine has already completed, the node won't be executed.
+     */
+    bool add_completion_node(TaskCompletionNode* node)
     {
-        std::unique_lock lock(mutex_);
-        if (!value_.has_value())
+        TaskCompletionNode* head = completion_list_.load(std::memory_order_acquire);
+        do
         {
-            completion_.wait(lock);
+            if (head == completed_tag())
+            {
+                return false;
+            }
+            node->next = head;
         }
+        while (!completion_list_.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_acquire));
+        return true;
     }
 
-    T& get_result()
+protected:
+    StopToken stop_token_;
+
+private:
+    static TaskCompletionNode* completed_tag()
     {
-        std::unique_lock lock(mutex_);
-        if (!value_.has_value())
-        {
-            completion_.wait(lock);
-        }
-        return *value_;
+        return reinterpret_cast<TaskCompletionNode*>(static_cast<uintptr_t>(1));
     }
 
-    void on_completed(std::function<void(T)>&& func)
+    void complete()
     {
-        std::unique_lock lock(mutex_);
-        if (!stop_token_.stop_requested())
+        TaskCompletionNode* node = completion_list_.exchange(completed_tag(), std::memory_order_acq_rel);
+        // The list is LIFO, reverse it to execute nodes in the order they were added.
+        TaskCompletionNode* reversed = nullptr;
+        while (node)
         {
-            if (value_.has_value())
-            {
-                lock.unlock();
-                func(*value_);
-            }
-            else
-            {
-                on_completed_.add(std::move(func));
-            }
+            TaskCompletionNode* next = node->next;
+            node->next = reversed;
+            reversed = node;
+            node = next;
+        }
+
+        while (reversed)
+        {
+            // A node may be released by on_completed.
+            TaskCompletionNode* next = reversed->next;
+            reversed->on_completed();
+            reversed = next;
         }
     }
 
-private:
-    std::mutex mutex_;
-    std::condition_variable completion_;
-    std::optional<T> value_;
-    InlineArray<std::function<void(T)>, 3> on_completed_;
+    // One reference is held by the running coroutine, released at final suspend point.
+    std::atomic<uint32> uses_{ 1 };
+    std::atomic<TaskCompletionNode*> completion_list_{ nullptr };
+    std::coroutine_handle<> continuation_{ nullptr };
 };
 
-template<>
-class TaskPromise<void> : public TaskPromiseBase
+template<typename T>
+class TaskPromise : public TaskPromiseBase
 {
     using base = TaskPromiseBase;
+
+    struct CallbackNode final : public TaskCompletionNode
+    {
+        CallbackNode(TaskPromise& promise, std::function<void(T)>&& func) : promise(promise), func(std::move(func)) {}
+
+        void on_completed() override
+        {
+            if (!promise.stop_token_.stop_requested())
+            {
+                func(*promise.value_);
+            }
+            delete this;
+        }
+
+        TaskPromise& promise;
+        std::function<void(T)> func;
+    };
 public:
-    using value_type = void;
+    using value_type = T;
 
     TaskPromise() = default;
 
-    Task<> get_return_object();
+    Task<T> get_return_object();
+
+    void return_value(T value)
+    {
+        value_.emplace(std::move(value));
+    }
 
-    void return_void()
+    T& get_result()
+    {
+        wait();
+        return *value_;
+    }
+
+    void on_completed(std::function<void(T)>&& func)
     {
-        std::unique_lock lock(mutex_);
-        has_value_ = true;
-        completion_.notify_all();
-        if (on_completed_.is_empty() || stop_token_.stop_requested())
+        if (stop_token_.stop_requested())
         {
             return;
         }
 
-        InlineArray<std::function<void()>, 10> invocation = std::move(on_completed_);
-        lock.unlock();
-        for (auto&& fn : invocation)
+        auto node = new CallbackNode(*this, std::move(func));
+        if (!add_completion_node(node))
         {
-            fn();
+            node->on_completed();
         }
     }
 
-    void wait()
+private:
+    std::optional<T> value_;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase
+{
+    using base = TaskPromiseBase;
+
+    struct CallbackNode final : public TaskCompletionNode
     {
-        std::unique_lock lock(mutex_);
-        if (!has_value_)
+        CallbackNode(TaskPromise& promise, std::function<void()>&& func) : promise(promise), func(std::move(func)) {}
+
+        void on_completed() override
         {
-            completion_.wait(lock);
+            if (!promise.stop_token_.stop_requested())
+            {
+                func();
+            }
+            delete this;
         }
-    }
+
+        TaskPromise& promise;
+        std::function<void()> func;
+    };
+public:
+    using value_type = void;
+
+    TaskPromise() = default;
+
+    Task<> get_return_object();
+
+    void return_void() {}
 
     void on_completed(std::function<void()>&& func)
     {
-        std::unique_lock lock(mutex_);
-        if (!stop_token_.stop_requested())
+        if (stop_token_.stop_requested())
         {
-            if (has_value_)
-            {
-                lock.unlock();
-                func();
-            }
-            else
-            {
-                on_completed_.add(std::move(func));
-            }
+            return;
         }
-    }
 
-private:
-    std::mutex mutex_;
-    std::condition_variable completion_;
-    bool has_value_{ false };
-    InlineArray<std::function<void()>, 3> on_completed_;
+        auto node = new CallbackNode(*this, std::move(func));
+        if (!add_completion_node(node))
+        {
+            node->on_completed();
+        }
+    }
 };
 
 }// namespace details
@@ -390,10 +492,11 @@ private:
 template<typename T>
 class TaskBase
 {
-protected:
-    using shared_coroutine_handle = details::SharedCoroutineHandle;
 public:
     using promise_type = details::TaskPromise<T>;
+protected:
+    using shared_coroutine_handle = details::SharedCoroutineHandle<promise_type>;
+public:
 
     TaskBase(TaskBase&& task) noexcept: shared_handle_(std::exchange(task.shared_handle_, {})) {}
 
@@ -401,11 +504,17 @@ public:
 
     TaskBase& operator=(TaskBase&) = delete;
 
+    TaskBase& operator=(TaskBase&& task) noexcept
+    {
+        shared_handle_ = std::move(task.shared_handle_);
+        return *this;
+    }
+
     ~TaskBase() = default;
 
     NODISCARD std::coroutine_handle<promise_type> co_handle() const
     {
-        return shared_handle_.get<promise_type>();
+        return shared_handle_.get();
     }
 
     void start()
@@ -459,6 +568,12 @@ public:
 
     Task& operator=(Task&) = delete;
 
+    Task& operator=(Task&& task) noexcept
+    {
+        base::operator=(std::move(task));
+        return *this;
+    }
+
     ~Task() = default;
     /**
     * @brief Waits task complete.
@@ -525,6 +640,12 @@ public:
 
     Task& operator=(Task&) = delete;
 
+    Task& operator=(Task&& task) noexcept
+    {
+        base::operator=(std::move(task));
+        return *this;
+    }
+
     ~Task() = default;
     /**
     * @brief Waits task complete.
@@ -549,9 +670,17 @@ private:
     explicit Task(const shared_coroutine_handle& handle) noexcept : base(handle) {}
 };
 
+template<typename T>
+Task<T> details::TaskPromise<T>::get_return_object()
+{
+    using handle_type = std::coroutine_handle<TaskPromise<T>>;
+    return Task<T>(typename Task<T>::shared_coroutine_handle(handle_type::from_promise(*this)));
+}
+
 inline Task<> details::TaskPromise<void>::get_return_object()
 {
-    return Task{shared_handle_};
+    using handle_type = std::coroutine_handle<TaskPromise<void>>;
+    return Task<>(Task<>::shared_coroutine_handle(handle_type::from_promise(*this)));
 }
 
 class StopTokenAwaiter
@@ -571,10 +700,10 @@ public:
     }
 
     template<typename PromiseType>
-    void await_suspend(std::coroutine_handle<PromiseType> handle) noexcept
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> handle) noexcept
     {
         token_ = handle.promise().get_stop_token();
-        handle.resume();
+        return handle;
     }
 
     StopToken await_resume() const noexcept
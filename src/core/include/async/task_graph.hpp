@@ -0,0 +1,293 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <span>
+
+#include "async/thread.hpp"
+#include "concurrency/lock_free_list.hpp"
+#include "concurrency/priority_queue.hpp"
+#include "container/array.hpp"
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+enum class ETaskGraphPriority : uint8
+{
+    High,
+    Normal,
+    Low
+};
+
+constexpr uint8 g_task_graph_priority_count = static_cast<uint8>(ETaskGraphPriority::Low) + 1;
+
+class GraphTask;
+class TaskGraph;
+
+/**
+ * @brief Completion event of a graph task.
+ * Tasks depending on an event are linked as its subsequents and dispatched once the event completes.
+ * Events are reference counted, always hold them by GraphEventRef.
+ */
+class CORE_API GraphEvent
+{
+    friend class GraphEventRef;
+    friend class TaskGraph;
+public:
+    GraphEvent(const GraphEvent&) = delete;
+    GraphEvent& operator=(const GraphEvent&) = delete;
+
+    /**
+     * @brief Returns true if the event has completed.
+     * @return
+     */
+    NODISCARD bool is_completed() const
+    {
+        return completed_.load(std::memory_order_acquire) != 0;
+    }
+
+    /**
+     * @brief Blocks calling thread until the event completes.
+     * Named threads should call TaskGraph::wait_until_completed instead, so their own tasks keep running.
+     */
+    void wait() const;
+
+private:
+    GraphEvent() = default;
+
+    /**
+     * @brief Links a task to run after this event.
+     * @param task
+     * @return False if the event has already completed.
+     */
+    bool add_subsequent(GraphTask* task)
+    {
+        return subsequents_.push_if_not_closed(task);
+    }
+
+    void dispatch_subsequents();
+
+    ClosableLockFreePointerListUnorderedSingleConsumer<GraphTask, PLATFORM_CACHE_LINE_SIZE> subsequents_;
+    std::atomic<uint32> uses_{ 0 };
+    std::atomic<uint32> completed_{ 0 };
+};
+
+/**
+ * @brief Intrusive reference to a GraphEvent.
+ */
+class CORE_API GraphEventRef
+{
+public:
+    GraphEventRef() = default;
+
+    GraphEventRef(const GraphEventRef& rhs) : GraphEventRef(rhs.event_) {}
+
+    GraphEventRef(GraphEventRef&& rhs) noexcept : event_(std::exchange(rhs.event_, nullptr)) {}
+
+    ~GraphEventRef()
+    {
+        reset();
+    }
+
+    GraphEventRef& operator= (const GraphEventRef& rhs)
+    {
+        GraphEventRef(rhs).swap(*this);
+        return *this;
+    }
+
+    GraphEventRef& operator= (GraphEventRef&& rhs) noexcept
+    {
+        GraphEventRef(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    /**
+     * @brief Creates a new event which is not completed.
+     * @return
+     */
+    static GraphEventRef create()
+    {
+        return GraphEventRef(new GraphEvent());
+    }
+
+    void reset();
+
+    NODISCARD GraphEvent* get() const
+    {
+        return event_;
+    }
+
+    GraphEvent* operator-> () const
+    {
+        return event_;
+    }
+
+    explicit operator bool() const
+    {
+        return event_ != nullptr;
+    }
+
+    NODISCARD bool operator== (const GraphEventRef& rhs) const
+    {
+        return event_ == rhs.event_;
+    }
+
+    void swap(GraphEventRef& rhs) noexcept
+    {
+        std::swap(event_, rhs.event_);
+    }
+
+private:
+    explicit GraphEventRef(GraphEvent* event) : event_(event)
+    {
+        if (event_)
+        {
+            event_->uses_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    GraphEvent* event_{ nullptr };
+};
+
+/**
+ * @brief A unit of work in the task graph. Queued once all prerequisites have completed.
+ */
+class GraphTask
+{
+    friend class GraphEvent;
+    friend class TaskGraph;
+public:
+    using work_type = std::move_only_function<void()>;
+
+    GraphTask(TaskGraph& graph, work_type&& work, uint32 thread, ETaskGraphPriority priority)
+        : graph_(graph)
+        , work_(std::move(work))
+        , completion_(GraphEventRef::create())
+        , thread_(thread)
+        , priority_(priority)
+    {}
+
+private:
+    void prerequisites_completed(int32 count);
+
+    TaskGraph& graph_;
+    work_type work_;
+    GraphEventRef completion_;
+    std::atomic<int32> prerequisites_remaining_{ 1 };
+    uint32 thread_;
+    ETaskGraphPriority priority_;
+};
+
+/**
+ * @brief Executes tasks with prerequisites without any global lock.
+ * Tasks either target any thread, then they are run by the worker threads owned by the graph, or target a named
+ * thread, which is an external thread (e.g. game thread) that runs its tasks when calling process_until_idle or
+ * wait_until_completed. Every queue is a PriorityQueue which tracks stalled threads, so a push signals exactly the
+ * thread chosen by the queue instead of waking every worker.
+ */
+class CORE_API TaskGraph
+{
+    friend class GraphTask;
+public:
+    static constexpr uint32 any_thread = ~0u;
+
+    /**
+     * @brief Constructs a task graph.
+     * @param named_thread_count Number of external threads which have their own queue.
+     * @param worker_count Number of worker threads for any thread tasks, at most LockFreeLinkPolicy::max_bits_in_link_ptr.
+     * @param work_thread_name
+     */
+    TaskGraph(uint32 named_thread_count, uint32 worker_count, StringView work_thread_name = "");
+
+    /**
+     * @brief Constructs a task graph whose workers apply affinity and priority to themselves before running any task.
+     * Named threads are owned by the caller and keep their settings.
+     * @param named_thread_count
+     * @param worker_count
+     * @param affinity
+     * @param work_thread_name
+     */
+    TaskGraph(uint32 named_thread_count, uint32 worker_count, const ThreadAffinityPolicy& affinity, StringView work_thread_name = "");
+
+    /**
+     * @note All dispatched tasks should have completed before the graph destructs.
+     */
+    ~TaskGraph();
+
+    TaskGraph(const TaskGraph&) = delete;
+    TaskGraph(TaskGraph&&) = delete;
+    TaskGraph& operator=(const TaskGraph&) = delete;
+    TaskGraph& operator=(TaskGraph&&) = delete;
+
+    /**
+     * @brief Dispatches a task which is queued once all prerequisites have completed.
+     * @param work
+     * @param prerequisites
+     * @param thread Index of a named thread, or any_thread.
+     * @param priority
+     * @return Event which completes after the task was executed.
+     */
+    GraphEventRef dispatch(GraphTask::work_type&& work, std::span<const GraphEventRef> prerequisites = {},
+                           uint32 thread = any_thread, ETaskGraphPriority priority = ETaskGraphPriority::Normal);
+
+    /**
+     * @brief Runs tasks queued to a named thread until its queue is empty. Must be called from that named thread.
+     * @param named_thread
+     */
+    void process_until_idle(uint32 named_thread);
+
+    /**
+     * @brief Runs tasks queued to a named thread until the event has completed. Must be called from that named thread.
+     * @param named_thread
+     * @param event
+     */
+    void wait_until_completed(uint32 named_thread, const GraphEventRef& event);
+
+    bool request_stop();
+
+    void join();
+
+    NODISCARD uint32 worker_count() const
+    {
+        return static_cast<uint32>(threads_.size());
+    }
+
+    NODISCARD uint32 named_thread_count() const
+    {
+        return named_thread_count_;
+    }
+
+private:
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) WakeSignal
+    {
+        std::atomic<uint32> value{ 0 };
+    };
+
+    struct NamedThread
+    {
+        PriorityQueue<GraphTask, g_task_graph_priority_count> queue;
+        WakeSignal signal;
+    };
+
+    void queue_task(GraphTask* task);
+
+    void execute(GraphTask* task);
+
+    void run_worker(uint32 worker_index, const StopToken& stoken);
+
+    static void signal(WakeSignal& signal);
+
+    StopSource stop_source_;
+    uint32 named_thread_count_{ 0 };
+    std::unique_ptr<NamedThread[]> named_threads_;
+    std::unique_ptr<WakeSignal[]> worker_signals_;
+    PriorityQueue<GraphTask, g_task_graph_priority_count> any_thread_queue_;
+    Array<std::thread> threads_;
+};
+
+}// namespace atlas
@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <span>
 #include <thread>
 
+#include "container/array.hpp"
 #include "core_def.hpp"
 #include "utility/stop_token.hpp"
 #include "platform/platform_fwd.hpp"
@@ -107,10 +109,36 @@ public:
         PlatformTraits::set_thread_name(native_handle(), name);
     }
 
+    /**
+     * @brief Restricts the thread to run only on the given logical processors.
+     * @param processors Indices of logical processors, see ProcessorInfo::index.
+     * @return True if the affinity has been applied.
+     */
+    bool set_affinity(std::span<const uint32> processors)
+    {
+        return PlatformTraits::set_thread_affinity(native_handle(), processors);
+    }
+
+    /**
+     * @brief Changes the scheduling priority of the thread.
+     * @note Linux only lets a thread change its own priority, use this_thread::set_priority from inside the thread.
+     * @param priority
+     * @return True if the priority has been applied.
+     */
+    bool set_priority(EThreadPriority priority)
+    {
+        return PlatformTraits::set_thread_priority(native_handle(), priority);
+    }
+
     static uint32 hardware_concurrency() noexcept
     {
         return std::thread::hardware_concurrency();
     }
+
+    static const CpuTopology& get_cpu_topology()
+    {
+        return PlatformTraits::get_cpu_topology();
+    }
 private:
     StopSource stop_source_;
     std::thread thread_;
@@ -129,6 +157,90 @@ CORE_API inline void set_name(const String& name)
     PlatformTraits::set_thread_name(PlatformTraits::get_this_thread_handle(), name);
 }
 
+CORE_API inline bool set_affinity(std::span<const uint32> processors)
+{
+    return PlatformTraits::set_thread_affinity(PlatformTraits::get_this_thread_handle(), processors);
+}
+
+CORE_API inline bool set_priority(EThreadPriority priority)
+{
+    return PlatformTraits::set_thread_priority(PlatformTraits::get_this_thread_handle(), priority);
+}
+
 }// namespace this_thread
 
+enum class EThreadAffinityMode : uint8
+{
+    /** Leaves scheduling to the OS. */
+    None,
+    /** Every worker may run on any of the processors. */
+    Shared,
+    /** Worker i runs only on processors[i % processors.size()]. */
+    Pinned,
+};
+
+/**
+ * @brief Describes where the workers of a thread pool run and at which priority. StaticThreadPool,
+ * WorkStealingThreadPool, ThreadPoolScheduler and TaskGraph take one at construction.
+ */
+struct ThreadAffinityPolicy
+{
+    EThreadAffinityMode mode{ EThreadAffinityMode::None };
+    /** Logical processor indices, empty means every processor for Shared and one per physical core for Pinned. */
+    Array<uint32> processors;
+    EThreadPriority priority{ EThreadPriority::Normal };
+
+    /**
+     * @brief Pins one worker per physical core, so workers never share a core with a SMT sibling.
+     * @return
+     */
+    static ThreadAffinityPolicy pin_to_physical_cores(EThreadPriority priority = EThreadPriority::Normal)
+    {
+        return { EThreadAffinityMode::Pinned, PlatformTraits::get_cpu_topology().get_physical_core_processors(), priority };
+    }
+
+    /**
+     * @brief Applies the policy to the calling thread, workers call it themselves before running any task since
+     * Linux only lets a thread change its own priority.
+     * @param worker_index
+     */
+    void apply(uint32 worker_index) const
+    {
+        void* thread_handle = PlatformTraits::get_this_thread_handle();
+        if (mode != EThreadAffinityMode::None)
+        {
+            const Array<uint32>& candidates = processors.is_empty() ? default_processors() : processors;
+            if (mode == EThreadAffinityMode::Pinned)
+            {
+                const uint32 processor = candidates[worker_index % candidates.size()];
+                PlatformTraits::set_thread_affinity(thread_handle, std::span<const uint32>(&processor, 1));
+            }
+            else
+            {
+                PlatformTraits::set_thread_affinity(thread_handle, std::span<const uint32>(candidates.data(), candidates.size()));
+            }
+        }
+
+        if (priority != EThreadPriority::Normal)
+        {
+            PlatformTraits::set_thread_priority(thread_handle, priority);
+        }
+    }
+
+private:
+    const Array<uint32>& default_processors() const
+    {
+        static const Array<uint32> all = []() {
+            Array<uint32> result;
+            for (auto&& processor : PlatformTraits::get_cpu_topology().processors)
+            {
+                result.add(processor.index);
+            }
+            return result;
+        }();
+        static const Array<uint32> physical = PlatformTraits::get_cpu_topology().get_physical_core_processors();
+        return mode == EThreadAffinityMode::Pinned ? physical : all;
+    }
+};
+
 }// namespace atlas
@@ -0,0 +1,132 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <memory>
+
+#include "async/thread.hpp"
+#include "async/worker_parking.hpp"
+#include "container/array.hpp"
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief ThreadPoolScheduler resumes coroutines on a fixed set of worker threads.
+ * Scheduling never allocates: the awaiter lives in the suspended coroutine frame and is linked into a worker inbox
+ * as an intrusive node. Each worker owns a lock free inbox, idle workers take over the inbox of a random busy worker.
+ * Usage:
+ * @code
+ * co_await co_schedule_on(scheduler);
+ * @endcode
+ */
+class CORE_API ThreadPoolScheduler
+{
+public:
+    class ScheduleOperation
+    {
+        friend class ThreadPoolScheduler;
+    public:
+        explicit ScheduleOperation(ThreadPoolScheduler& scheduler) noexcept : scheduler_(&scheduler) {}
+
+        ScheduleOperation(ScheduleOperation&& rhs) noexcept : scheduler_(std::exchange(rhs.scheduler_, nullptr)) {}
+
+        ScheduleOperation(const ScheduleOperation&) = delete;
+        ScheduleOperation& operator=(const ScheduleOperation&) = delete;
+
+        constexpr bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) noexcept
+        {
+            handle_ = handle;
+            scheduler_ ? scheduler_->schedule(this) : handle.resume();
+        }
+
+        void await_resume() noexcept {}
+
+    private:
+        ThreadPoolScheduler* scheduler_;
+        std::coroutine_handle<> handle_{ nullptr };
+        ScheduleOperation* next_{ nullptr };
+    };
+
+    using awaiter_type = ScheduleOperation;
+
+    explicit ThreadPoolScheduler(uint32 thread_count = Thread::hardware_concurrency(), StringView work_thread_name = "");
+
+    /**
+     * @brief Creates the workers, each of them applies affinity and priority to itself before resuming anything.
+     * @param thread_count
+     * @param affinity
+     * @param work_thread_name
+     */
+    ThreadPoolScheduler(uint32 thread_count, const ThreadAffinityPolicy& affinity, StringView work_thread_name = "");
+
+    ~ThreadPoolScheduler();
+
+    ThreadPoolScheduler(const ThreadPoolScheduler&) = delete;
+    ThreadPoolScheduler(ThreadPoolScheduler&&) = delete;
+    ThreadPoolScheduler& operator=(const ThreadPoolScheduler&) = delete;
+    ThreadPoolScheduler& operator=(ThreadPoolScheduler&&) = delete;
+
+    /**
+     * @brief Enqueues a suspended coroutine. The operation must stay alive until the coroutine is resumed.
+     * @param operation
+     */
+    void schedule(ScheduleOperation* operation) noexcept;
+
+    /**
+     * @brief Requests all workers to exit. Operations that were not resumed yet will be resumed by join.
+     * @return
+     */
+    bool request_stop();
+
+    /**
+     * @brief Stops and joins all workers, then resumes the remaining operations on the calling thread.
+     */
+    void join();
+
+    /**
+     * @brief Gets number of worker threads.
+     * @return
+     */
+    NODISCARD uint32 worker_count() const
+    {
+        return worker_count_;
+    }
+
+    /**
+     * @brief Returns true if the calling thread is a worker of this scheduler.
+     * @return
+     */
+    NODISCARD bool is_in_worker_thread() const;
+
+private:
+    struct Worker;
+
+    void run(uint32 worker_index, const StopToken& stoken);
+
+    ScheduleOperation* take_inbox(Worker& worker);
+
+    ScheduleOperation* steal(uint32 worker_index);
+
+    NODISCARD bool has_pending_operation() const;
+
+    void drain();
+
+    StopSource stop_source_;
+    uint32 worker_count_{ 0 };
+    std::unique_ptr<Worker[]> workers_;
+    WorkerParking parking_;
+    Array<std::thread> threads_;
+    std::atomic<uint32> next_worker_{ 0 };
+};
+
+}// namespace atlas
@@ -0,0 +1,504 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+#include "async/task.hpp"
+#include "async/thread.hpp"
+#include "async/thread_pool_scheduler.hpp"
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+using TimerClock = std::chrono::steady_clock;
+
+class TimerService;
+
+struct TimerNode;
+
+/**
+ * @brief Unlinks a timer from the wheel as soon as its stop token is triggered.
+ */
+struct TimerStopHandler
+{
+    void operator()() const;
+
+    TimerService* service;
+    TimerNode* node;
+};
+
+/**
+ * @brief A pending timer, linked intrusively into the timer wheel. The node must stay alive until it has fired or
+ * has been cancelled.
+ */
+struct TimerNode
+{
+    virtual ~TimerNode() = default;
+
+    /**
+     * @brief Called once on the timer thread, without any lock held.
+     * @param cancelled True if the timer was stopped through its stop token or by shutdown of the service.
+     */
+    virtual void on_fired(bool cancelled) = 0;
+
+    TimerNode* prev{ nullptr };
+    TimerNode* next{ nullptr };
+    uint64 expiry_tick{ 0 };
+    uint32 slot{ 0 };
+    bool linked{ false };
+    /** A stop request fires the timer early as cancelled. */
+    StopToken stop_token;
+    std::optional<StopCallback<TimerStopHandler>> stop_callback;
+};
+
+/**
+ * @brief Fires timers from a dedicated thread with a hierarchical timer wheel.
+ * The wheel has 4 levels of 64 slots with a resolution of one millisecond. A timer is linked into the level whose
+ * range covers its delay, and moves down a level each time the level below wraps around, so scheduling and
+ * cancelling are O(1) and the thread sleeps until the next occupied slot. Delays beyond the top level (about 4.6
+ * hours) are re-linked when they reach it.
+ * A stop request unlinks a timer at once through a StopCallback and hands it to the timer thread.
+ * The timer thread only fires timers, coroutines waiting on a timer are resumed on a ThreadPoolScheduler so their
+ * code never delays other timers.
+ */
+class CORE_API TimerService
+{
+public:
+    static constexpr auto tick_duration = std::chrono::milliseconds(1);
+
+    /**
+     * @brief Constructor.
+     * @param scheduler Resumes coroutines woken up by timers, it must outlive the service. The service creates its
+     * own scheduler with two workers if null, so continuations that do heavy work should move to another scheduler.
+     */
+    explicit TimerService(ThreadPoolScheduler* scheduler = nullptr);
+
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;
+    TimerService(TimerService&&) = delete;
+    TimerService& operator=(const TimerService&) = delete;
+    TimerService& operator=(TimerService&&) = delete;
+
+    /**
+     * @brief Gets the timer service shared by co_sleep_for, co_sleep_until and with_timeout.
+     * @return
+     */
+    static TimerService& get();
+
+    /**
+     * @brief Gets the scheduler that resumes coroutines woken up by timers, unless they pass their own.
+     * @return
+     */
+    NODISCARD ThreadPoolScheduler& get_scheduler() const
+    {
+        return *scheduler_;
+    }
+
+    /**
+     * @brief Links a timer into the wheel. The node may fire on the timer thread before this returns.
+     * @param node
+     * @param deadline
+     */
+    void schedule(TimerNode* node, TimerClock::time_point deadline);
+
+    /**
+     * @brief Unlinks a pending timer.
+     * @param node
+     * @return False if the timer has already fired or is firing, on_fired is called in that case.
+     */
+    bool cancel(TimerNode* node);
+
+private:
+    friend struct TimerStopHandler;
+
+    static constexpr uint32 slot_bits_ = 6;
+    static constexpr uint32 slots_per_level_ = 1 << slot_bits_;
+    static constexpr uint32 level_count_ = 4;
+    static constexpr uint64 max_delta_ = (uint64(1) << (slot_bits_ * level_count_)) - 1;
+    static constexpr uint32 continuation_worker_count_ = 2;
+
+    void run(const StopToken& stoken);
+
+    NODISCARD uint64 to_tick(TimerClock::time_point time_point) const;
+
+    NODISCARD TimerClock::time_point to_time_point(uint64 tick) const;
+
+    void link(TimerNode* node);
+
+    void unlink(TimerNode* node);
+
+    void advance(uint64 target_tick, TimerNode*& expired);
+
+    NODISCARD uint64 next_event_tick() const;
+
+    void stop(TimerNode* node);
+
+    static void fire(TimerNode* list, bool cancelled);
+
+    std::unique_ptr<ThreadPoolScheduler> owned_scheduler_;
+    ThreadPoolScheduler* scheduler_;
+    std::mutex mutex_;
+    std::condition_variable awake_signal_;
+    TimerClock::time_point epoch_;
+    uint64 now_tick_{ 0 };
+    /** Tick the timer thread sleeps until, a timer expiring earlier must wake it up. */
+    uint64 wake_tick_{ 0 };
+    uint64 occupied_[level_count_]{};
+    TimerNode* slots_[level_count_][slots_per_level_]{};
+    /** Timers unlinked by a stop request, fired as cancelled by the timer thread. */
+    TimerNode* stopped_{ nullptr };
+    Thread thread_;
+};
+
+namespace details
+{
+
+/**
+ * @brief Suspends the awaiting coroutine until the deadline, the timer node lives in the coroutine frame.
+ */
+class SleepAwaiter final : public TimerNode
+{
+public:
+    SleepAwaiter(TimerClock::time_point deadline, ThreadPoolScheduler* scheduler) noexcept
+        : deadline_(deadline)
+        , scheduler_(scheduler)
+    {}
+
+    SleepAwaiter(SleepAwaiter&& rhs) noexcept : deadline_(rhs.deadline_), scheduler_(rhs.scheduler_) {}
+
+    SleepAwaiter(const SleepAwaiter&) = delete;
+    SleepAwaiter& operator=(const SleepAwaiter&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return deadline_ <= TimerClock::now();
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>)
+        {
+            stop_token = handle.promise().get_stop_token();
+            if (stop_token.stop_requested())
+            {
+                cancelled_ = true;
+                return false;
+            }
+        }
+        continuation_ = handle;
+        TimerService& service = TimerService::get();
+        if (!scheduler_)
+        {
+            scheduler_ = &service.get_scheduler();
+        }
+        service.schedule(this, deadline_);
+        return true;
+    }
+
+    /**
+     * @return False if the sleep was cut short by a stop request.
+     */
+    bool await_resume() const noexcept
+    {
+        return !cancelled_;
+    }
+
+    void on_fired(bool cancelled) override
+    {
+        cancelled_ = cancelled;
+        resume_operation_.emplace(*scheduler_);
+        resume_operation_->await_suspend(continuation_);
+    }
+
+private:
+    TimerClock::time_point deadline_;
+    ThreadPoolScheduler* scheduler_;
+    std::coroutine_handle<> continuation_{ nullptr };
+    /** Links the coroutine into the scheduler, it lives until the coroutine is resumed. */
+    std::optional<ThreadPoolScheduler::ScheduleOperation> resume_operation_;
+    bool cancelled_{ false };
+};
+
+enum class ETimeoutOutcome : uint32
+{
+    Pending,
+    Completed,
+    TimedOut,
+};
+
+/**
+ * @brief Shared by with_timeout, the completion of its task and its timer. The task may keep running after the
+ * timeout, so the state is released by whoever finishes last.
+ */
+struct TimeoutState final : public TimerNode
+{
+    struct CompletionNode final : public TaskCompletionNode
+    {
+        void on_completed() override
+        {
+            TimeoutState* local = state;
+            local->finish(ETimeoutOutcome::Completed);
+            local->release();
+        }
+
+        TimeoutState* state{ nullptr };
+    };
+
+    TimeoutState()
+    {
+        completion.state = this;
+    }
+
+    void on_fired(bool) override
+    {
+        finish(ETimeoutOutcome::TimedOut);
+        release();
+    }
+
+    /**
+     * @brief Records the first outcome, stops the task on timeout or the timer on completion, then resumes the
+     * awaiting coroutine if it has already suspended. A timeout comes from the timer thread, the coroutine is handed
+     * to the scheduler then instead of being resumed inline.
+     * @param result
+     */
+    void finish(ETimeoutOutcome result)
+    {
+        ETimeoutOutcome expected = ETimeoutOutcome::Pending;
+        if (!outcome.compare_exchange_strong(expected, result, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        if (result == ETimeoutOutcome::TimedOut)
+        {
+            stop_source.request_stop();
+        }
+        else if (TimerService::get().cancel(this))
+        {
+            // drops the reference of the timer, which will not fire anymore.
+            release();
+        }
+
+        if (arrive())
+        {
+            if (result == ETimeoutOutcome::TimedOut)
+            {
+                resume_operation.emplace(*scheduler);
+                resume_operation->await_suspend(continuation);
+            }
+            else
+            {
+                continuation.resume();
+            }
+        }
+    }
+
+    /**
+     * @brief Arrives once from the first outcome and once from the awaiter after the task started.
+     * @return True if caller is the last one to arrive.
+     */
+    bool arrive()
+    {
+        return arrivals.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    void release()
+    {
+        if (uses.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    // held by the awaiter, the completion node and the timer.
+    std::atomic<uint32> uses{ 3 };
+    std::atomic<uint32> arrivals{ 2 };
+    std::atomic<ETimeoutOutcome> outcome{ ETimeoutOutcome::Pending };
+    StopSource stop_source;
+    CompletionNode completion;
+    std::coroutine_handle<> continuation{ nullptr };
+    ThreadPoolScheduler* scheduler{ nullptr };
+    std::optional<ThreadPoolScheduler::ScheduleOperation> resume_operation;
+};
+
+template<typename T>
+class TimeoutAwaiter
+{
+public:
+    TimeoutAwaiter(Task<T>& task, TimerClock::time_point deadline, ThreadPoolScheduler* scheduler) noexcept
+        : task_(task)
+        , deadline_(deadline)
+        , scheduler_(scheduler)
+    {}
+
+    TimeoutAwaiter(TimeoutAwaiter&& rhs) noexcept
+        : task_(rhs.task_)
+        , deadline_(rhs.deadline_)
+        , scheduler_(rhs.scheduler_)
+        , state_(std::exchange(rhs.state_, nullptr))
+    {}
+
+    TimeoutAwaiter(const TimeoutAwaiter&) = delete;
+    TimeoutAwaiter& operator=(const TimeoutAwaiter&) = delete;
+
+    ~TimeoutAwaiter()
+    {
+        if (state_)
+        {
+            state_->release();
+        }
+    }
+
+    constexpr bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        TimerService& service = TimerService::get();
+        state_ = new TimeoutState();
+        state_->continuation = handle;
+        state_->scheduler = scheduler_ ? scheduler_ : &service.get_scheduler();
+        if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>)
+        {
+            // a stop request of the awaiting coroutine fires the timer, which stops the task.
+            state_->stop_token = handle.promise().get_stop_token();
+        }
+        task_.set_stop_token(state_->stop_source.get_token());
+
+        // the timer is linked first, so a task completing synchronously finds it and cancels it.
+        service.schedule(state_, deadline_);
+        if (task_.co_handle().promise().add_completion_node(&state_->completion))
+        {
+            task_.start();
+        }
+        else
+        {
+            state_->completion.on_completed();
+        }
+        // Resumes inline if the task has completed or timed out synchronously.
+        return !state_->arrive();
+    }
+
+    /**
+     * @return True if the task completed before the deadline, otherwise the task has been requested to stop.
+     */
+    bool await_resume() const noexcept
+    {
+        return state_->outcome.load(std::memory_order_acquire) == ETimeoutOutcome::Completed;
+    }
+
+private:
+    Task<T>& task_;
+    TimerClock::time_point deadline_;
+    ThreadPoolScheduler* scheduler_;
+    TimeoutState* state_{ nullptr };
+};
+
+}// namespace details
+
+/**
+ * @brief Suspends the awaiting coroutine without blocking any thread, it is resumed on the scheduler of the timer
+ * service. A stop request of the awaiting coroutine resumes it early.
+ * Usage:
+ * @code
+ * if (!co_await co_sleep_for(std::chrono::milliseconds(100)))
+ * {
+ *     co_return; // canceled
+ * }
+ * @endcode
+ * @param duration
+ * @return An awaitable that produces false if the sleep was canceled.
+ */
+inline details::SleepAwaiter co_sleep_for(TimerClock::duration duration)
+{
+    return details::SleepAwaiter(TimerClock::now() + duration, nullptr);
+}
+
+/**
+ * @brief Suspends the awaiting coroutine, then resumes it on the given scheduler.
+ * @param duration
+ * @param scheduler
+ * @return An awaitable that produces false if the sleep was canceled.
+ */
+inline details::SleepAwaiter co_sleep_for(TimerClock::duration duration, ThreadPoolScheduler& scheduler)
+{
+    return details::SleepAwaiter(TimerClock::now() + duration, &scheduler);
+}
+
+/**
+ * @brief Suspends the awaiting coroutine until the deadline, see co_sleep_for.
+ * @param deadline
+ * @return An awaitable that produces false if the sleep was canceled.
+ */
+inline details::SleepAwaiter co_sleep_until(TimerClock::time_point deadline)
+{
+    return details::SleepAwaiter(deadline, nullptr);
+}
+
+inline details::SleepAwaiter co_sleep_until(TimerClock::time_point deadline, ThreadPoolScheduler& scheduler)
+{
+    return details::SleepAwaiter(deadline, &scheduler);
+}
+
+/**
+ * @brief Starts the task and resumes the awaiting coroutine once it completes or the deadline passes, whichever
+ * comes first. On timeout the task is requested to stop and keeps running until it observes the request, the caller
+ * still owns it. A stop request of the awaiting coroutine counts as a timeout.
+ * Usage:
+ * @code
+ * Task<Array<byte>> read = async_read(path);
+ * if (co_await with_timeout(read, TimerClock::now() + std::chrono::seconds(1)))
+ * {
+ *     process(read.get_result());
+ * }
+ * @endcode
+ * @note The task must not be started before. Resumption happens on the thread that completes the task, or on the
+ * scheduler of the timer service on timeout.
+ * @param task
+ * @param deadline
+ * @return An awaitable that produces true if the task completed in time.
+ */
+template<typename T>
+details::TimeoutAwaiter<T> with_timeout(Task<T>& task, TimerClock::time_point deadline)
+{
+    return details::TimeoutAwaiter<T>(task, deadline, nullptr);
+}
+
+template<typename T>
+details::TimeoutAwaiter<T> with_timeout(Task<T>& task, TimerClock::duration timeout)
+{
+    return details::TimeoutAwaiter<T>(task, TimerClock::now() + timeout, nullptr);
+}
+
+/**
+ * @brief Same as with_timeout, resumes the awaiting coroutine on the given scheduler on timeout.
+ * @param task
+ * @param deadline
+ * @param scheduler
+ * @return An awaitable that produces true if the task completed in time.
+ */
+template<typename T>
+details::TimeoutAwaiter<T> with_timeout(Task<T>& task, TimerClock::time_point deadline, ThreadPoolScheduler& scheduler)
+{
+    return details::TimeoutAwaiter<T>(task, deadline, &scheduler);
+}
+
+template<typename T>
+details::TimeoutAwaiter<T> with_timeout(Task<T>& task, TimerClock::duration timeout, ThreadPoolScheduler& scheduler)
+{
+    return details::TimeoutAwaiter<T>(task, TimerClock::now() + timeout, &scheduler);
+}
+
+}// namespace atlas
@@ -0,0 +1,219 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <variant>
+
+#include "async/task.hpp"
+#include "container/array.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+template<typename T>
+using WhenAllResultType = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/**
+ * @brief Counts down children of when_all, the last one to arrive resumes the awaiting coroutine.
+ * Starts with one extra count held by the awaiter while it is starting children, so the awaiting coroutine is never
+ * resumed before it has suspended.
+ */
+struct WhenAllCounter
+{
+    explicit WhenAllCounter(size_t count) : remaining(count + 1) {}
+
+    /**
+     * @brief Arrives at the counter.
+     * @return True if caller is the last one to arrive.
+     */
+    bool arrive()
+    {
+        return remaining.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    std::atomic<size_t> remaining;
+    std::coroutine_handle<> continuation{ nullptr };
+};
+
+struct WhenAllCompletionNode final : public TaskCompletionNode
+{
+    void on_completed() override
+    {
+        if (counter->arrive())
+        {
+            counter->continuation.resume();
+        }
+    }
+
+    WhenAllCounter* counter{ nullptr };
+};
+
+/**
+ * @brief Passes stop token of the awaiting coroutine to a child task, the same way TaskPromiseBase::await_transform does.
+ */
+template<typename Promise, typename T>
+void propagate_stop_token(std::coroutine_handle<Promise> awaiting, Task<T>& task)
+{
+    if constexpr (std::is_base_of_v<TaskPromiseBase, Promise>)
+    {
+        task.set_stop_token(awaiting.promise().get_stop_token());
+    }
+}
+
+template<typename Promise, typename T>
+void start_child(std::coroutine_handle<Promise> awaiting, Task<T>& task, TaskCompletionNode& node)
+{
+    propagate_stop_token(awaiting, task);
+    if (task.co_handle().promise().add_completion_node(&node))
+    {
+        task.start();
+    }
+    else
+    {
+        node.on_completed();
+    }
+}
+
+template<typename T>
+WhenAllResultType<T> take_result(Task<T>& task)
+{
+    if constexpr (std::is_void_v<T>)
+    {
+        return {};
+    }
+    else
+    {
+        return std::move(task.get_result());
+    }
+}
+
+template<typename... Ts>
+class WhenAllAwaiter
+{
+public:
+    using result_type = std::tuple<WhenAllResultType<Ts>...>;
+
+    explicit WhenAllAwaiter(Task<Ts>&&... tasks) : tasks_(std::move(tasks)...) {}
+
+    WhenAllAwaiter(WhenAllAwaiter&& rhs) noexcept : tasks_(std::move(rhs.tasks_)) {}
+
+    WhenAllAwaiter(const WhenAllAwaiter&) = delete;
+    WhenAllAwaiter& operator=(const WhenAllAwaiter&) = delete;
+
+    constexpr bool await_ready() const noexcept
+    {
+        return sizeof...(Ts) == 0;
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        counter_.continuation = handle;
+        [&]<size_t... Indices>(std::index_sequence<Indices...>) {
+            ((nodes_[Indices].counter = &counter_), ...);
+            (start_child(handle, std::get<Indices>(tasks_), nodes_[Indices]), ...);
+        }(std::index_sequence_for<Ts...>{});
+        // Resumes inline if all children have completed synchronously.
+        return !counter_.arrive();
+    }
+
+    result_type await_resume()
+    {
+        return std::apply([](auto&... tasks) { return result_type(take_result(tasks)...); }, tasks_);
+    }
+
+private:
+    std::tuple<Task<Ts>...> tasks_;
+    std::array<WhenAllCompletionNode, sizeof...(Ts)> nodes_;
+    WhenAllCounter counter_{ sizeof...(Ts) };
+};
+
+template<typename T>
+class WhenAllArrayAwaiter
+{
+public:
+    explicit WhenAllArrayAwaiter(Array<Task<T>>&& tasks) : tasks_(std::move(tasks)) {}
+
+    WhenAllArrayAwaiter(WhenAllArrayAwaiter&& rhs) noexcept : tasks_(std::move(rhs.tasks_)) {}
+
+    WhenAllArrayAwaiter(const WhenAllArrayAwaiter&) = delete;
+    WhenAllArrayAwaiter& operator=(const WhenAllArrayAwaiter&) = delete;
+
+    bool await_ready() const noexcept
+    {
+        return tasks_.is_empty();
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        counter_.remaining.store(tasks_.size() + 1, std::memory_order_relaxed);
+        counter_.continuation = handle;
+        nodes_.resize(tasks_.size());
+        for (size_t i = 0; i < tasks_.size(); ++i)
+        {
+            nodes_[i].counter = &counter_;
+            start_child(handle, tasks_[i], nodes_[i]);
+        }
+        return !counter_.arrive();
+    }
+
+    auto await_resume()
+    {
+        if constexpr (!std::is_void_v<T>)
+        {
+            Array<T> results;
+            results.reserve(tasks_.size());
+            for (auto&& task : tasks_)
+            {
+                results.emplace(take_result(task));
+            }
+            return results;
+        }
+    }
+
+private:
+    Array<Task<T>> tasks_;
+    Array<WhenAllCompletionNode> nodes_;
+    WhenAllCounter counter_{ 0 };
+};
+
+}// namespace details
+
+/**
+ * @brief Starts all tasks and resumes the awaiting coroutine once, on the thread that completes the last task.
+ * The stop token of the awaiting coroutine is passed to every task.
+ * Usage:
+ * @code
+ * auto [a, b] = co_await when_all(async_a(), async_b());
+ * @endcode
+ * @note Tasks must not be started before.
+ * @param tasks
+ * @return An awaitable that produces a tuple of results, void tasks produce std::monostate.
+ */
+template<typename... Ts>
+details::WhenAllAwaiter<Ts...> when_all(Task<Ts>&&... tasks)
+{
+    return details::WhenAllAwaiter<Ts...>(std::move(tasks)...);
+}
+
+/**
+ * @brief Starts all tasks and resumes the awaiting coroutine once, on the thread that completes the last task.
+ * The stop token of the awaiting coroutine is passed to every task.
+ * @note Tasks must not be started before.
+ * @param tasks
+ * @return An awaitable that produces an array of results in the same order as tasks, or nothing for void tasks.
+ */
+template<typename T>
+details::WhenAllArrayAwaiter<T> when_all(Array<Task<T>>&& tasks)
+{
+    return details::WhenAllArrayAwaiter<T>(std::move(tasks));
+}
+
+}// namespace atlas
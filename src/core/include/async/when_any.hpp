@@ -0,0 +1,194 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "async/when_all.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct WhenAnyState;
+
+struct WhenAnyCompletionNode final : public TaskCompletionNode
+{
+    void on_completed() override;
+
+    WhenAnyState* state{ nullptr };
+    size_t index{ 0 };
+};
+
+/**
+ * @brief Shared by when_any and its children. Children keep running after the first one completed, so the state
+ * outlives the awaiter and is released by whoever finishes last.
+ */
+struct WhenAnyState
+{
+    explicit WhenAnyState(size_t count) : uses(count + 1)
+    {
+        nodes.resize(count);
+    }
+
+    /**
+     * @brief Records the first completed child, resumes the awaiting coroutine if it has already suspended.
+     * @param index
+     */
+    void complete(size_t index)
+    {
+        size_t expected = INDEX_NONE_ZU;
+        if (winner.compare_exchange_strong(expected, index, std::memory_order_acq_rel) && arrive())
+        {
+            continuation.resume();
+        }
+    }
+
+    /**
+     * @brief Arrives once from the first completed child and once from the awaiter after all children started.
+     * @return True if caller is the last one to arrive.
+     */
+    bool arrive()
+    {
+        return arrivals.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+
+    void release()
+    {
+        if (uses.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+
+    std::atomic<size_t> uses;
+    std::atomic<uint32> arrivals{ 2 };
+    std::atomic<size_t> winner{ INDEX_NONE_ZU };
+    std::coroutine_handle<> continuation{ nullptr };
+    Array<WhenAnyCompletionNode> nodes;
+};
+
+inline void WhenAnyCompletionNode::on_completed()
+{
+    WhenAnyState* local = state;
+    local->complete(index);
+    local->release();
+}
+
+template<typename TaskRange>
+class WhenAnyAwaiter
+{
+public:
+    explicit WhenAnyAwaiter(TaskRange&& tasks) : tasks_(std::forward<TaskRange>(tasks)) {}
+
+    WhenAnyAwaiter(WhenAnyAwaiter&& rhs) noexcept
+        : tasks_(std::forward<TaskRange>(rhs.tasks_))
+        , state_(std::exchange(rhs.state_, nullptr))
+    {}
+
+    WhenAnyAwaiter(const WhenAnyAwaiter&) = delete;
+    WhenAnyAwaiter& operator=(const WhenAnyAwaiter&) = delete;
+
+    ~WhenAnyAwaiter()
+    {
+        if (state_)
+        {
+            state_->release();
+        }
+    }
+
+    bool await_ready() const noexcept
+    {
+        return task_count() == 0;
+    }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> handle)
+    {
+        state_ = new WhenAnyState(task_count());
+        state_->continuation = handle;
+        size_t index = 0;
+        for_each_task([&](auto& task) {
+            WhenAnyCompletionNode& node = state_->nodes[index];
+            node.state = state_;
+            node.index = index++;
+            start_child(handle, task, node);
+        });
+        // Resumes inline if a child has completed synchronously.
+        return !state_->arrive();
+    }
+
+    size_t await_resume() const
+    {
+        return state_ ? state_->winner.load(std::memory_order_acquire) : INDEX_NONE_ZU;
+    }
+
+private:
+    NODISCARD size_t task_count() const
+    {
+        if constexpr (requires { tasks_.size(); })
+        {
+            return tasks_.size();
+        }
+        else
+        {
+            return std::tuple_size_v<std::remove_cvref_t<TaskRange>>;
+        }
+    }
+
+    template<typename Fn>
+    void for_each_task(Fn&& fn)
+    {
+        if constexpr (requires { tasks_.size(); })
+        {
+            for (auto&& task : tasks_)
+            {
+                fn(task);
+            }
+        }
+        else
+        {
+            std::apply([&](auto&... tasks) { (fn(tasks), ...); }, tasks_);
+        }
+    }
+
+    TaskRange tasks_;
+    WhenAnyState* state_{ nullptr };
+};
+
+}// namespace details
+
+/**
+ * @brief Starts all tasks and resumes the awaiting coroutine once, on the thread that completes the first task.
+ * The stop token of the awaiting coroutine is passed to every task. Other tasks keep running, the caller still owns
+ * them and can get results of the finished ones.
+ * Usage:
+ * @code
+ * Task<int32> a = async_a(), b = async_b();
+ * size_t first = co_await when_any(a, b);
+ * @endcode
+ * @note Tasks must not be started before.
+ * @param tasks
+ * @return An awaitable that produces the index of the first completed task.
+ */
+template<typename... Ts>
+details::WhenAnyAwaiter<std::tuple<Task<Ts>&...>> when_any(Task<Ts>&... tasks)
+{
+    return details::WhenAnyAwaiter<std::tuple<Task<Ts>&...>>(std::tuple<Task<Ts>&...>(tasks...));
+}
+
+/**
+ * @brief Starts all tasks and resumes the awaiting coroutine once, on the thread that completes the first task.
+ * The stop token of the awaiting coroutine is passed to every task.
+ * @note Tasks must not be started before.
+ * @param tasks
+ * @return An awaitable that produces the index of the first completed task.
+ */
+template<typename T>
+details::WhenAnyAwaiter<Array<Task<T>>&> when_any(Array<Task<T>>& tasks)
+{
+    return details::WhenAnyAwaiter<Array<Task<T>>&>(tasks);
+}
+
+}// namespace atlas
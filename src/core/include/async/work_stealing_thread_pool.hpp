@@ -0,0 +1,265 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <memory>
+
+#include "async/static_thread_pool.hpp"
+#include "async/worker_parking.hpp"
+#include "concurrency/lock_free_list.hpp"
+#include "concurrency/work_stealing_queue.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief A thread pool with a Chase-Lev deque per worker and per priority.
+ * Tasks pushed from a worker thread of this pool go to the worker's own deque, tasks pushed from other threads go
+ * to a lock free injection queue. An idle worker pops its own deque first, then the injection queue, then steals from
+ * a random victim, always honoring priority (lower queue index first). Workers with nothing to do park on their own
+ * atomic and publish a bit in the parked mask, a producer claims one bit and signals only that worker.
+ * Shares the push_task interface with StaticThreadPool, so both can be used interchangeably.
+ * @tparam NumOfQueues Number of priorities.
+ * @tparam Policy
+ */
+template<uint32 NumOfQueues, typename Policy = ThreadPoolPolicy> requires(std::invocable<typename Policy::task_type>)
+class WorkStealingThreadPool
+{
+public:
+    using task_type = typename Policy::task_type;
+
+private:
+    struct Worker
+    {
+        WorkStealingQueue<task_type*> queues[NumOfQueues];
+        uint32 random_state{ 0 };
+    };
+
+public:
+    WorkStealingThreadPool() = default;
+
+    WorkStealingThreadPool(size_t size, StringView work_thread_name = "")
+        : WorkStealingThreadPool(size, ThreadAffinityPolicy{}, work_thread_name)
+    {}
+
+    /**
+     * @brief Creates the workers, each of them applies affinity and priority to itself before running any task.
+     * @param size
+     * @param affinity
+     * @param work_thread_name
+     */
+    WorkStealingThreadPool(size_t size, const ThreadAffinityPolicy& affinity, StringView work_thread_name = "")
+        : worker_count_(static_cast<uint32>(size))
+        , workers_(std::make_unique<Worker[]>(size))
+        , parking_(static_cast<uint32>(size))
+    {
+        threads_.reserve(size);
+        for (uint32 i = 0; i < size; ++i)
+        {
+            workers_[i].random_state = i + 1;
+            create_thread(work_thread_name, affinity);
+        }
+    }
+
+    // Workers hold a pointer to the pool, non copyable and non movable.
+    WorkStealingThreadPool(const WorkStealingThreadPool& rhs) = delete;
+    WorkStealingThreadPool(WorkStealingThreadPool&& rhs) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool& rhs) = delete;
+    WorkStealingThreadPool& operator=(WorkStealingThreadPool&& rhs) = delete;
+
+    ~WorkStealingThreadPool()
+    {
+        join();
+        release_pending_tasks();
+    }
+
+    void push_task(uint32 queue_index, const task_type& task)
+    {
+        emplace_task(queue_index, task);
+    }
+
+    void push_task(uint32 queue_index, task_type&& task)
+    {
+        emplace_task(queue_index, std::move(task));
+    }
+
+    void push_task(const task_type& task) requires (NumOfQueues == 1)
+    {
+        emplace_task(0, task);
+    }
+
+    void push_task(task_type&& task) requires (NumOfQueues == 1)
+    {
+        emplace_task(0, std::move(task));
+    }
+
+    template<typename... Args>
+    void emplace_task(uint32 queue_index, Args&&... args)
+    {
+        ASSERT(queue_index < NumOfQueues && !threads_.is_empty());
+        auto task = new task_type(std::forward<Args>(args)...);
+        if (current_pool_ == this)
+        {
+            workers_[current_worker_index_].queues[queue_index].push(task);
+        }
+        else
+        {
+            injection_queues_[queue_index].push(task);
+        }
+        parking_.wake_one();
+    }
+
+    bool request_stop()
+    {
+        if (!stop_source_.stop_possible())
+        {
+            return false;
+        }
+
+        stop_source_.request_stop();
+        parking_.wake_all();
+        return true;
+    }
+
+    void join()
+    {
+        request_stop();
+
+        for (auto&& thread : threads_)
+        {
+            if (thread.joinable())
+            {
+                thread.join();
+            }
+        }
+    }
+
+    /**
+     * @brief Gets number of worker threads.
+     * @return
+     */
+    NODISCARD uint32 worker_count() const
+    {
+        return worker_count_;
+    }
+
+private:
+    void create_thread(StringView work_thread_name, const ThreadAffinityPolicy& affinity)
+    {
+        static const char* default_name = "work stealing thread pool worker";
+        if (work_thread_name.empty())
+        {
+            work_thread_name = default_name;
+        }
+
+        const uint32 worker_index = static_cast<uint32>(threads_.size());
+        String thread_name = String::format("{}-{}", work_thread_name, worker_index);
+
+        threads_.emplace([this, worker_index, thread_name, affinity](StopToken stoken) {
+            affinity.apply(worker_index);
+            current_pool_ = this;
+            current_worker_index_ = worker_index;
+
+            while (!stoken.stop_requested())
+            {
+                if (task_type* task = find_task(worker_index))
+                {
+                    std::invoke(std::move(*task));
+                    delete task;
+                    continue;
+                }
+
+                parking_.park(worker_index, [this, &stoken] {
+                    return stoken.stop_requested() || has_pending_task();
+                });
+            }
+
+            current_pool_ = nullptr;
+            LOG_INFO(core, "{} terminated", thread_name)
+        }, stop_source_.get_token());
+
+        PlatformTraits::set_thread_name(threads_.last().native_handle(), thread_name);
+    }
+
+    task_type* find_task(uint32 worker_index)
+    {
+        Worker& self = workers_[worker_index];
+        for (uint32 priority = 0; priority < NumOfQueues; ++priority)
+        {
+            if (task_type* task = self.queues[priority].pop())
+            {
+                return task;
+            }
+
+            if (task_type* task = injection_queues_[priority].pop())
+            {
+                return task;
+            }
+
+            if (task_type* task = steal(self, worker_index, priority))
+            {
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    task_type* steal(Worker& self, uint32 worker_index, uint32 priority)
+    {
+        return steal_from_random_victim(self.random_state, worker_index, worker_count_, [this, priority](uint32 victim) {
+            return workers_[victim].queues[priority].steal();
+        });
+    }
+
+    NODISCARD bool has_pending_task() const
+    {
+        for (uint32 priority = 0; priority < NumOfQueues; ++priority)
+        {
+            if (!injection_queues_[priority].is_empty())
+            {
+                return true;
+            }
+
+            for (uint32 i = 0; i < worker_count_; ++i)
+            {
+                if (!workers_[i].queues[priority].is_empty())
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void release_pending_tasks()
+    {
+        for (uint32 priority = 0; priority < NumOfQueues; ++priority)
+        {
+            while (task_type* task = injection_queues_[priority].pop())
+            {
+                delete task;
+            }
+
+            for (uint32 i = 0; i < worker_count_; ++i)
+            {
+                while (task_type* task = workers_[i].queues[priority].pop())
+                {
+                    delete task;
+                }
+            }
+        }
+    }
+
+    static inline thread_local WorkStealingThreadPool* current_pool_{ nullptr };
+    static inline thread_local uint32 current_worker_index_{ 0 };
+
+    StopSource stop_source_;
+    uint32 worker_count_{ 0 };
+    std::unique_ptr<Worker[]> workers_;
+    WorkerParking parking_;
+    Array<std::thread> threads_;
+    LockFreePointerFIFOBase<task_type, PLATFORM_CACHE_LINE_SIZE> injection_queues_[NumOfQueues];
+};
+
+}// namespace atlas
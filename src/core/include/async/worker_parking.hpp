@@ -0,0 +1,161 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <memory>
+
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Parks the idle workers of a pool. A parked worker waits on its own atomic and publishes a bit in the parked
+ * mask, a producer claims one bit and signals only that worker.
+ */
+class WorkerParking
+{
+public:
+    WorkerParking() = default;
+
+    explicit WorkerParking(uint32 worker_count)
+        : worker_count_(worker_count)
+        , signals_(std::make_unique<Signal[]>(worker_count))
+        , parked_masks_(std::make_unique<std::atomic<uint64>[]>(get_mask_count()))
+    {}
+
+    /**
+     * @brief Parks the calling worker until it is signaled.
+     * @param worker_index
+     * @param has_work Checked after the worker announced parking, the worker does not park if it returns true.
+     */
+    template<typename Predicate>
+    void park(uint32 worker_index, Predicate&& has_work)
+    {
+        std::atomic<uint32>& wake_signal = signals_[worker_index].value;
+        std::atomic<uint64>& mask = parked_masks_[worker_index / bits_per_mask_];
+        const uint64 bit = uint64(1) << (worker_index % bits_per_mask_);
+
+        // Announce parking before the final check, so a producer either sees the parked bit or
+        // this worker sees the published work. A wake-up can never be lost.
+        wake_signal.store(0, std::memory_order_relaxed);
+        mask.fetch_or(bit, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (has_work())
+        {
+            // If the bit is already cleared, someone has claimed this worker and the signal is on the way.
+            mask.fetch_and(~bit, std::memory_order_relaxed);
+            return;
+        }
+
+        wake_signal.wait(0, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Signals one parked worker, if any. Call after the work is published.
+     */
+    void wake_one()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (uint32 i = 0; i < get_mask_count(); ++i)
+        {
+            std::atomic<uint64>& mask = parked_masks_[i];
+            uint64 parked = mask.load(std::memory_order_relaxed);
+            while (parked)
+            {
+                // Claims the parked worker by clearing its bit, only the winner signals it.
+                const uint64 bit = parked & (~parked + 1);
+                const uint64 old = mask.fetch_and(~bit, std::memory_order_acq_rel);
+                if (old & bit)
+                {
+                    signal(i * bits_per_mask_ + std::countr_zero(bit));
+                    return;
+                }
+                parked = old & ~bit;
+            }
+        }
+    }
+
+    /**
+     * @brief Signals every worker, parked or not, e.g. once stop is requested.
+     */
+    void wake_all()
+    {
+        for (uint32 i = 0; i < worker_count_; ++i)
+        {
+            signal(i);
+        }
+    }
+
+    void signal(uint32 worker_index)
+    {
+        std::atomic<uint32>& wake_signal = signals_[worker_index].value;
+        wake_signal.store(1, std::memory_order_release);
+        wake_signal.notify_one();
+    }
+
+private:
+    static constexpr uint32 bits_per_mask_ = 64;
+
+    struct Signal
+    {
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> value{ 0 };
+    };
+
+    NODISCARD uint32 get_mask_count() const
+    {
+        return (worker_count_ + bits_per_mask_ - 1) / bits_per_mask_;
+    }
+
+    uint32 worker_count_{ 0 };
+    std::unique_ptr<Signal[]> signals_;
+    // One bit per parked worker.
+    std::unique_ptr<std::atomic<uint64>[]> parked_masks_;
+};
+
+/**
+ * @brief Tries the other workers of a pool as victims, starting at a random one so thieves spread over victims.
+ * @param random_state Per worker state of the generator, must not be zero.
+ * @param worker_index The thief.
+ * @param worker_count
+ * @param try_steal Called with a victim index, returns what it stole or a null value.
+ * @return The first non null value returned by try_steal.
+ */
+template<typename TrySteal>
+auto steal_from_random_victim(uint32& random_state, uint32 worker_index, uint32 worker_count, TrySteal&& try_steal)
+    -> decltype(try_steal(worker_index))
+{
+    if (worker_count <= 1)
+    {
+        return nullptr;
+    }
+
+    // xorshift32, only need a cheap way to spread thieves over victims.
+    uint32 x = random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    random_state = x;
+
+    const uint32 start = x % worker_count;
+    for (uint32 i = 0; i < worker_count; ++i)
+    {
+        const uint32 victim = (start + i) % worker_count;
+        if (victim == worker_index)
+        {
+            continue;
+        }
+
+        if (auto stolen = try_steal(victim))
+        {
+            return stolen;
+        }
+    }
+    return nullptr;
+}
+
+}// namespace atlas
@@ -7,15 +7,32 @@
 
 #include "core_def.hpp"
 #include "container/array.hpp"
-#include "platform/windows/windows_platform_traits.hpp"
-
+#include "platform/platform_fwd.hpp"
+
+/**
+ * Links are addressed by raw pointers and swapped together with a 64 bit ABA counter by a 128 bit compare exchange
+ * (cmpxchg16b), instead of packing a 26 bit index and a 38 bit counter into 64 bits. This removes the index to link
+ * indirection and the limit of 2^26 links, but cmpxchg16b is slower than a 64 bit compare exchange, so it is opt in.
+ * Only available on x86-64.
+ */
+#ifndef LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+#   define LOCK_FREE_LINKS_USE_128BIT_ATOMICS 0
+#endif
+
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS && !(defined(__x86_64__) || defined(_M_X64))
+#   error "LOCK_FREE_LINKS_USE_128BIT_ATOMICS requires x86-64"
+#endif
 
 namespace atlas
 {
 
 #define MAX_LOCK_FREE_LINKS_AS_BITS (26)
 #define MAX_LOCK_FREE_LINKS (1 << 26)
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+#define MAX_TAG_BITS_VALUE (~uint64(0))
+#else
 #define MAX_TAG_BITS_VALUE (uint64(1) << (64 - MAX_LOCK_FREE_LINKS_AS_BITS))
+#endif
 
 #define checkLockFreePointerList(a)
 #define TestCriticalStall()
@@ -34,6 +51,25 @@ CORE_API int64 atomic_compare_exchange(volatile int64* dest, int64 exchange, int
 
 CORE_API int64 atomic_read(volatile const int64* src);
 
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+struct alignas(16) Int128
+{
+	uint64 low;
+	uint64 high;
+};
+
+/**
+ * @brief Compares dest with comparand and swaps in exchange if they are equal.
+ * @param dest
+ * @param exchange
+ * @param comparand Receives the value of dest before the operation.
+ * @return True if exchanged.
+ */
+CORE_API bool atomic_compare_exchange_128(volatile Int128* dest, const Int128& exchange, Int128* comparand);
+
+CORE_API void atomic_read_128(volatile const Int128* src, Int128* out_result);
+#endif
+
 template<typename T, uint32 MaxTotalItems, uint32 ItemsPerPage>
 class LockFreeAllocOnceIndexedAllocator
 {
@@ -103,6 +139,125 @@ private:
 	alignas(PLATFORM_CACHE_LINE_SIZE) pointer_type pages_[max_blocks_];
 };
 
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+struct DoublePointerLockFreeLink;
+
+class alignas(16) DoublePointer
+{
+public:
+	// no constructor, intentionally. We need to keep the ABA double counter in tact
+
+	// This should only be used for DoublePointer's with no outstanding concurrency.
+	// Not recycled links, for example.
+	void init()
+	{
+		ptrs_.low = 0;
+		ptrs_.high = 0;
+	}
+	void set_all(DoublePointerLockFreeLink* ptr, uint64 counter_and_state)
+	{
+		ptrs_.low = std::uintptr_t(ptr);
+		ptrs_.high = counter_and_state;
+	}
+
+	NODISCARD DoublePointerLockFreeLink* get_ptr() const
+	{
+		return (DoublePointerLockFreeLink*)std::uintptr_t(ptrs_.low);
+	}
+
+	void set_ptr(DoublePointerLockFreeLink* to)
+	{
+		ptrs_.low = std::uintptr_t(to);
+	}
+
+	NODISCARD uint64 get_counter_and_state() const
+	{
+		return ptrs_.high;
+	}
+
+	void set_counter_and_state(uint64 to)
+	{
+		ptrs_.high = to;
+	}
+
+	void advance_counter_and_state(const DoublePointer& from, uint64 inc)
+	{
+		set_counter_and_state(from.get_counter_and_state() + inc);
+		if (get_counter_and_state() < from.get_counter_and_state())
+		{
+			// this is not expected to be a problem and it is not expected to happen very often. When it does happen, we will sleep as an extra precaution.
+			lock_free_tag_counter_has_overflowed();
+		}
+	}
+
+	template<uint64 ABAInc>
+	NODISCARD uint64 get_state() const
+	{
+		return get_counter_and_state() & (ABAInc - 1);
+	}
+
+	template<uint64 ABAInc>
+	void set_state(uint64 value)
+	{
+		ASSERT(value < ABAInc);
+		set_counter_and_state((get_counter_and_state() & ~(ABAInc - 1)) | value);
+	}
+
+	void atomic_read(const DoublePointer& other)
+	{
+		ASSERT(math::is_aligned(&ptrs_, 16) && math::is_aligned(&other.ptrs_, 16));
+		atlas::atomic_read_128(&other.ptrs_, &ptrs_);
+		TestCriticalStall();
+	}
+
+	bool interlocked_compare_exchange(DoublePointer& exchange, const DoublePointer& comparand)
+	{
+		TestCriticalStall();
+		Int128 expected = comparand.ptrs_;
+		return atomic_compare_exchange_128(&ptrs_, exchange.ptrs_, &expected);
+	}
+
+	bool operator==(const DoublePointer& other) const
+	{
+		return ptrs_.low == other.ptrs_.low && ptrs_.high == other.ptrs_.high;
+	}
+	bool operator!=(const DoublePointer& other) const
+	{
+		return !(*this == other);
+	}
+
+private:
+	Int128 ptrs_;
+};
+
+struct DoublePointerLockFreeLink
+{
+    DoublePointer double_next;
+    void* payload;
+    DoublePointerLockFreeLink* single_next;
+};
+
+struct LockFreeLinkPolicy
+{
+    static constexpr int32 max_bits_in_link_ptr = 64;
+    using index_pointer     = DoublePointer;
+    using link_type         = DoublePointerLockFreeLink;
+    using link_ptr_type     = DoublePointerLockFreeLink*;
+
+    static DoublePointerLockFreeLink* deref_link(DoublePointerLockFreeLink* ptr)
+    {
+        return ptr;
+    }
+
+    CORE_API static link_ptr_type alloc_lock_free_link();
+    CORE_API static void free_lock_free_link(link_ptr_type item);
+    /**
+     * @brief Constructs the cache of links of the calling thread. A thread_local constructed after it is destroyed
+     * before it, so it can still allocate and free links in its destructor.
+     */
+    CORE_API static void ensure_thread_cache();
+};
+#else
 class alignas(8) IndexedPointer
 {
 public:
@@ -198,7 +353,7 @@ struct IndexedLockFreeLink
     uint32 single_next;
 };
 
-// there is a version of this code that uses 128 bit atomics to avoid the indirection, that is why we have this policy class at all.
+// LOCK_FREE_LINKS_USE_128BIT_ATOMICS switches to the version that uses 128 bit atomics to avoid the indirection, that is why we have this policy class at all.
 struct LockFreeLinkPolicy
 {
     static constexpr int32 max_bits_in_link_ptr = MAX_LOCK_FREE_LINKS_AS_BITS;
@@ -220,10 +375,16 @@ struct LockFreeLinkPolicy
         return index;
     }
 
-    CORE_API static uint32 alloc_lock_free_link();
-    CORE_API static void free_lock_free_link(uint32 item);
+    CORE_API static link_ptr_type alloc_lock_free_link();
+    CORE_API static void free_lock_free_link(link_ptr_type item);
+    /**
+     * @brief Constructs the cache of links of the calling thread. A thread_local constructed after it is destroyed
+     * before it, so it can still allocate and free links in its destructor.
+     */
+    CORE_API static void ensure_thread_cache();
     CORE_API static allocator_type link_allocator;
 };
+#endif
 
 template<int32 PaddingForCacheContention, uint64 ABAInc = 1>
 class LockFreePointerListLIFORoot
@@ -381,6 +542,98 @@ private:
 	alignas(PaddingForCacheContention) index_pointer head_;
 };
 
+/**
+ * @brief An unordered list that many threads push to and a single consumer closes once. Pushing to a closed list
+ * fails, so a producer learns the consumer has already gone through the list.
+ */
+template<typename T, int32 PaddingForCacheContention>
+class ClosableLockFreePointerListUnorderedSingleConsumer
+{
+    using pointer_type  = T*;
+    using link_ptr_type = LockFreeLinkPolicy::link_ptr_type;
+public:
+	ClosableLockFreePointerListUnorderedSingleConsumer() = default;
+
+	~ClosableLockFreePointerListUnorderedSingleConsumer()
+	{
+		free_links(root_list_.pop_all());
+	}
+
+	void reset()
+	{
+		free_links(root_list_.pop_all());
+		root_list_.reset();
+	}
+
+	/**
+	 * @brief Pushes an item unless the list was closed.
+	 * @param item
+	 * @return False if the list was closed, the item was not pushed.
+	 */
+	bool push_if_not_closed(pointer_type item)
+	{
+		link_ptr_type link = 0;
+		bool pushed = root_list_.push_if([&link, item](uint64 state) -> link_ptr_type {
+			if (state & 1)
+			{
+				return 0;
+			}
+			if (!link)
+			{
+				link = LockFreeLinkPolicy::alloc_lock_free_link();
+				LockFreeLinkPolicy::deref_link(link)->payload = item;
+			}
+			return link;
+		});
+
+		if (!pushed && link)
+		{
+			LockFreeLinkPolicy::free_lock_free_link(link);
+		}
+		return pushed;
+	}
+
+	/**
+	 * @brief Pops all items and closes the list. Only one thread is allowed to call this, only once until reset.
+	 * @param out_array
+	 */
+	void pop_all_and_close(Array<pointer_type>& out_array)
+	{
+		link_ptr_type link = root_list_.pop_all_and_change_state([](uint64 state) -> uint64 {
+			ASSERT(!(state & 1));
+			return state | 1;
+		});
+
+		while (link)
+		{
+			LockFreeLinkPolicy::link_type* link_ptr = LockFreeLinkPolicy::deref_link(link);
+			pointer_type item = static_cast<pointer_type>(link_ptr->payload);
+			out_array.add(item);
+			link_ptr_type next = link_ptr->single_next;
+			LockFreeLinkPolicy::free_lock_free_link(link);
+			link = next;
+		}
+	}
+
+	NODISCARD bool is_closed() const
+	{
+		return !!(root_list_.get_state() & 1);
+	}
+
+private:
+	static void free_links(link_ptr_type link)
+	{
+		while (link)
+		{
+			link_ptr_type next = LockFreeLinkPolicy::deref_link(link)->single_next;
+			LockFreeLinkPolicy::free_lock_free_link(link);
+			link = next;
+		}
+	}
+
+	LockFreePointerListLIFORoot<PaddingForCacheContention, 2> root_list_;
+};
+
 template<typename T, int32 PaddingForCacheContention, uint64 ABAInc = 1>
 class LockFreePointerFIFOBase
 {
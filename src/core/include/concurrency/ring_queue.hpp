@@ -0,0 +1,317 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+
+#include "core_def.hpp"
+#include "assertion.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Bounded lock free multi producer multi consumer queue.
+ * Every cell carries a sequence number which tells whether it is ready for the producer or the consumer of a given
+ * position, so producers and consumers only contend on their own position counter. Items are constructed in place
+ * and nothing is allocated after construction, a push to a full queue fails instead of growing.
+ * See "Bounded MPMC queue" (Dmitry Vyukov, 1024cores.net).
+ * @tparam T
+ * @tparam Capacity Must be a power of two.
+ */
+template<typename T, size_t Capacity>
+class MPMCRingQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* get()
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+public:
+    using value_type = T;
+
+    MPMCRingQueue() : cells_(new Cell[Capacity])
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        enqueue_pos_.store(0, std::memory_order_relaxed);
+        dequeue_pos_.store(0, std::memory_order_relaxed);
+    }
+
+    MPMCRingQueue(const MPMCRingQueue&) = delete;
+    MPMCRingQueue(MPMCRingQueue&&) = delete;
+    MPMCRingQueue& operator= (const MPMCRingQueue&) = delete;
+    MPMCRingQueue& operator= (MPMCRingQueue&&) = delete;
+
+    ~MPMCRingQueue()
+    {
+        const size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (size_t pos = dequeue_pos_.load(std::memory_order_relaxed); pos != enqueue_pos; ++pos)
+        {
+            cells_[pos & mask_].get()->~T();
+        }
+        delete[] cells_;
+    }
+
+    /**
+     * @brief Constructs an item at the tail. Any thread is allowed to call this.
+     * @param args
+     * @return False if queue is full, args are left untouched.
+     */
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        Cell* cell;
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                // the consumer of previous lap has not released this cell.
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new(cell->storage) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_emplace(std::move(item));
+    }
+
+    /**
+     * @brief Pops an item from the head. Any thread is allowed to call this.
+     * @param out_item
+     * @return False if queue is empty.
+     */
+    bool try_pop(T& out_item)
+    {
+        Cell* cell;
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            cell = &cells_[pos & mask_];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* item = cell->get();
+        out_item = std::move(*item);
+        item->~T();
+        // ready for the producer of next lap.
+        cell->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns approximate number of items in queue.
+     * @return
+     */
+    NODISCARD size_t size() const
+    {
+        const size_t dequeue_pos = dequeue_pos_.load(std::memory_order_relaxed);
+        const size_t enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+        return enqueue_pos > dequeue_pos ? enqueue_pos - dequeue_pos : 0;
+    }
+
+    NODISCARD bool is_empty() const
+    {
+        return size() == 0;
+    }
+
+    NODISCARD static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t mask_ = Capacity - 1;
+
+    Cell* const cells_;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_;
+};
+
+/**
+ * @brief Bounded lock free single producer single consumer queue.
+ * Each side keeps a cached copy of the other side's position, so it only touches the other side's cache line when
+ * the queue looks full or empty.
+ * @tparam T
+ * @tparam Capacity Must be a power of two.
+ */
+template<typename T, size_t Capacity>
+class SPSCRingQueue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    struct Slot
+    {
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* get()
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+public:
+    using value_type = T;
+
+    SPSCRingQueue() : slots_(new Slot[Capacity]) {}
+
+    SPSCRingQueue(const SPSCRingQueue&) = delete;
+    SPSCRingQueue(SPSCRingQueue&&) = delete;
+    SPSCRingQueue& operator= (const SPSCRingQueue&) = delete;
+    SPSCRingQueue& operator= (SPSCRingQueue&&) = delete;
+
+    ~SPSCRingQueue()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        for (size_t pos = head_.load(std::memory_order_relaxed); pos != tail; ++pos)
+        {
+            slots_[pos & mask_].get()->~T();
+        }
+        delete[] slots_;
+    }
+
+    /**
+     * @brief Constructs an item at the tail. Only the producer thread is allowed to call this.
+     * @param args
+     * @return False if queue is full, args are left untouched.
+     */
+    template<typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == Capacity)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ == Capacity)
+            {
+                return false;
+            }
+        }
+
+        new(slots_[tail & mask_].storage) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item)
+    {
+        return try_emplace(item);
+    }
+
+    bool try_push(T&& item)
+    {
+        return try_emplace(std::move(item));
+    }
+
+    /**
+     * @brief Pops an item from the head. Only the consumer thread is allowed to call this.
+     * @param out_item
+     * @return False if queue is empty.
+     */
+    bool try_pop(T& out_item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_)
+            {
+                return false;
+            }
+        }
+
+        T* item = slots_[head & mask_].get();
+        out_item = std::move(*item);
+        item->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Returns approximate number of items in queue.
+     * @return
+     */
+    NODISCARD size_t size() const
+    {
+        // head never passes tail, so reading head first never underflows.
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    NODISCARD bool is_empty() const
+    {
+        return size() == 0;
+    }
+
+    NODISCARD static constexpr size_t capacity()
+    {
+        return Capacity;
+    }
+
+private:
+    static constexpr size_t mask_ = Capacity - 1;
+
+    Slot* const slots_;
+    // consumer side
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_t> head_{ 0 };
+    size_t cached_tail_{ 0 };
+    // producer side
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<size_t> tail_{ 0 };
+    size_t cached_head_{ 0 };
+};
+
+}// namespace atlas
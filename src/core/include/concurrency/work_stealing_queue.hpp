@@ -0,0 +1,196 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+#include "core_def.hpp"
+#include "assertion.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Lock free Chase-Lev work stealing deque.
+ * The owner thread pushes and pops at the bottom in LIFO order, while any other thread can steal from the top in
+ * FIFO order. The ring buffer grows on demand, retired buffers are kept alive until the queue destructs since
+ * a concurrent thief may still read from them.
+ * See "Correct and Efficient Work-Stealing for Weak Memory Models" (Le, Pop, Cohen, Nardelli. PPoPP 2013).
+ * @tparam T Must be a pointer type.
+ */
+template<typename T> requires(std::is_pointer_v<T>)
+class WorkStealingQueue
+{
+    using pointer_type = T;
+
+    struct RingBuffer
+    {
+        explicit RingBuffer(int64 capacity, RingBuffer* previous)
+            : capacity(capacity)
+            , mask(capacity - 1)
+            , slots(new std::atomic<pointer_type>[capacity])
+            , previous(previous)
+        {}
+
+        ~RingBuffer()
+        {
+            delete[] slots;
+        }
+
+        NODISCARD pointer_type get(int64 index) const
+        {
+            return slots[index & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64 index, pointer_type item)
+        {
+            slots[index & mask].store(item, std::memory_order_relaxed);
+        }
+
+        RingBuffer* grow(int64 bottom, int64 top)
+        {
+            auto new_buffer = new RingBuffer(capacity << 1, this);
+            for (int64 i = top; i != bottom; ++i)
+            {
+                new_buffer->put(i, get(i));
+            }
+            return new_buffer;
+        }
+
+        int64 capacity;
+        int64 mask;
+        std::atomic<pointer_type>* slots;
+        RingBuffer* previous;
+    };
+
+public:
+    explicit WorkStealingQueue(int64 capacity = 1024)
+    {
+        ASSERT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+        top_.store(0, std::memory_order_relaxed);
+        bottom_.store(0, std::memory_order_relaxed);
+        buffer_.store(new RingBuffer(capacity, nullptr), std::memory_order_relaxed);
+    }
+
+    WorkStealingQueue(const WorkStealingQueue&) = delete;
+    WorkStealingQueue(WorkStealingQueue&&) = delete;
+    WorkStealingQueue& operator= (const WorkStealingQueue&) = delete;
+    WorkStealingQueue& operator= (WorkStealingQueue&&) = delete;
+
+    ~WorkStealingQueue()
+    {
+        RingBuffer* buffer = buffer_.load(std::memory_order_relaxed);
+        while (buffer)
+        {
+            RingBuffer* previous = buffer->previous;
+            delete buffer;
+            buffer = previous;
+        }
+    }
+
+    /**
+     * @brief Pushes an item at the bottom. Only the owner thread is allowed to call this.
+     * @param item
+     */
+    void push(pointer_type item)
+    {
+        const int64 bottom = bottom_.load(std::memory_order_relaxed);
+        const int64 top = top_.load(std::memory_order_acquire);
+        RingBuffer* buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1)
+        {
+            buffer = buffer->grow(bottom, top);
+            buffer_.store(buffer, std::memory_order_release);
+        }
+        buffer->put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Pops an item from the bottom. Only the owner thread is allowed to call this.
+     * @return The most recently pushed item, or nullptr if queue is empty.
+     */
+    pointer_type pop()
+    {
+        const int64 bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        RingBuffer* buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64 top = top_.load(std::memory_order_relaxed);
+
+        pointer_type item = nullptr;
+        if (top <= bottom)
+        {
+            item = buffer->get(bottom);
+            if (top == bottom)
+            {
+                // last item, race against thieves.
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = nullptr;
+                }
+                bottom_.store(bottom + 1, std::memory_order_relaxed);
+            }
+        }
+        else
+        {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Steals an item from the top. Any thread is allowed to call this.
+     * @return The oldest item, or nullptr if queue is empty or lost the race to another thread.
+     */
+    pointer_type steal()
+    {
+        int64 top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64 bottom = bottom_.load(std::memory_order_acquire);
+
+        if (top < bottom)
+        {
+            RingBuffer* buffer = buffer_.load(std::memory_order_acquire);
+            pointer_type item = buffer->get(top);
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr;
+            }
+            return item;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns true if queue looks empty. The result is only a snapshot while other threads are working.
+     * @return
+     */
+    NODISCARD bool is_empty() const
+    {
+        const int64 bottom = bottom_.load(std::memory_order_relaxed);
+        const int64 top = top_.load(std::memory_order_relaxed);
+        return bottom <= top;
+    }
+
+    /**
+     * @brief Returns approximate number of items in queue.
+     * @return
+     */
+    NODISCARD int64 size() const
+    {
+        const int64 bottom = bottom_.load(std::memory_order_relaxed);
+        const int64 top = top_.load(std::memory_order_relaxed);
+        return bottom >= top ? bottom - top : 0;
+    }
+
+private:
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> top_;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> bottom_;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<RingBuffer*> buffer_;
+};
+
+}// namespace atlas
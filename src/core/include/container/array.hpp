@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <type_traits>
 #if PLATFORM_APPLE
 #include <__bit_reference>
@@ -12,6 +13,7 @@
 #include "core_macro.hpp"
 #include "utility/iterator.hpp"
 #include "utility/compression_pair.hpp"
+#include "utility/simd.hpp"
 
 
 namespace atlas
@@ -272,7 +274,7 @@ public:
      * @param elem
      * @return Index to the new element
      */
-    size_type add(value_type&& elem) { return emplace(elem); }
+    size_type add(value_type&& elem) requires std::is_reference_v<param_type> { return emplace(std::move(elem)); }
     /**
      * @brief Copies unique element to array if it doesn't exist.
      * @param elem
@@ -288,10 +290,10 @@ public:
      * @param elem
      * @return Index to the element
      */
-    size_type add_unique(value_type&& elem)
+    size_type add_unique(value_type&& elem) requires std::is_reference_v<param_type>
     {
         size_type index = find(elem);
-        return index != INDEX_NONE ? index : emplace(std::forward<value_type>(elem));
+        return index != INDEX_NONE ? index : emplace(std::move(elem));
     }
     /**
      * @brief Constructs a new item at the end of the array, possibly reallocating the whole array to fit.
@@ -348,22 +350,44 @@ public:
     {
         size_type increase_size = others.size();
         size_type index = add_uninitialized(increase_size);
-        if constexpr (std::is_trivially_copyable_v<value_type>)
+        relocate_to_uninitialized(others.data(), others.data() + increase_size, data() + index);
+        auto&& other_val = others.get_val();
+        other_val.size = 0;
+
+        return index;
+    }
+    /**
+     * @brief Appends count elements written in place by a callable, so a reader or decoder fills the tail of the array
+     * without an intermediate buffer.
+     * Usage:
+     * @code
+     * buffer.append_with(size, [&](byte* dst) { return std::fread(dst, 1, size, stream); });
+     * @endcode
+     * @tparam Writer Invoked with a pointer to count uninitialized elements, it constructs them. It may return the number
+     * of elements it constructed from the front, the rest are dropped.
+     * @param count
+     * @param writer
+     * @return Index to the first append element
+     */
+    template<typename Writer>
+    size_type append_with(size_type count, Writer&& writer)
+    {
+        size_type index = add_uninitialized(count);
+        if (index == INDEX_NONE)
         {
-            std::memmove(data() + index, others.data(), increase_size * sizeof(value_type));
+            return index;
+        }
+
+        if constexpr (std::is_void_v<std::invoke_result_t<Writer, pointer>>)
+        {
+            std::invoke(std::forward<Writer>(writer), data() + index);
         }
         else
         {
-            pointer ptr = data() + index;
-            const_pointer source = others.data();
-            for (size_type i = 0; i < increase_size; ++i)
-            {
-                new (ptr + i) value_type(std::move(source[i]));
-            }
+            const auto written = static_cast<size_type>(std::invoke(std::forward<Writer>(writer), data() + index));
+            ASSERT(written >= 0 && written <= count);
+            get_val().size = index + written;
         }
-        auto&& other_val = others.get_val();
-        other_val.size = 0;
-
         return index;
     }
     /**
@@ -380,7 +404,7 @@ public:
      * @param where
      * @param elem
      */
-    iterator insert(const_iterator where, value_type&& elem)
+    iterator insert(const_iterator where, value_type&& elem) requires std::is_reference_v<param_type>
     {
         return insert_counted_range(where, &elem, 1, true);
     }
@@ -473,7 +497,18 @@ public:
      */
     size_type remove_all(const param_type elem)
     {
-        return remove_all([&elem](const param_type value) { return value == elem; });
+        if constexpr (simd::is_searchable_v<value_type>)
+        {
+            auto&& my_val = get_val();
+            const size_type new_size = static_cast<size_type>(simd::remove(my_val.ptr, my_val.size, elem));
+            const size_type num_of_matches = my_val.size - new_size;
+            my_val.size = new_size;
+            return num_of_matches;
+        }
+        else
+        {
+            return remove_all([&elem](const param_type value) { return value == elem; });
+        }
     }
     /**
      * @brief Removes all instances in the array that matched element.
@@ -503,12 +538,24 @@ public:
                 {
                     if (write != start)
                     {
-                        std::move(start, read, write);
+                        if constexpr (is_trivially_relocatable_v<value_type>)
+                        {
+                            std::memmove(static_cast<void*>(write), static_cast<const void*>(start), (read - start) * sizeof(value_type));
+                        }
+                        else
+                        {
+                            std::move(start, read, write);
+                        }
                     }
                     write += (read - start);
                 }
                 else
                 {
+                    if constexpr (is_trivially_relocatable_v<value_type>)
+                    {
+                        // matches are destroyed in place, the elements after them are relocated over their storage.
+                        std::destroy(start, read);
+                    }
                     num_of_matches += read - start;
                 }
                 not_match = !not_match;
@@ -517,7 +564,10 @@ public:
 
             if (num_of_matches > 0)
             {
-                std::destroy(last - num_of_matches, last);
+                if constexpr (!is_trivially_relocatable_v<value_type>)
+                {
+                    std::destroy(last - num_of_matches, last);
+                }
                 my_val.size -= num_of_matches;
             }
         }
@@ -610,8 +660,16 @@ public:
         size_type offset = where - cbegin();
         pointer location = data + offset;
         pointer end = data + my_val.size;
-        std::move(location + count, end, location);
-        std::destroy(end - count, end);
+        if constexpr (is_trivially_relocatable_v<value_type>)
+        {
+            std::destroy(location, location + count);
+            std::memmove(static_cast<void*>(location), static_cast<const void*>(location + count), (end - location - count) * sizeof(value_type));
+        }
+        else
+        {
+            std::move(location + count, end, location);
+            std::destroy(end - count, end);
+        }
         my_val.size -= count;
         return iterator(location);
     }
@@ -658,25 +716,38 @@ public:
         pointer location = data + offset;
         pointer end = data + my_val.size;
         size_type remain = end - location - count;
-        if (remain <= count)
+        if constexpr (is_trivially_relocatable_v<value_type>)
         {
-            std::move(location + count, end, location);
+            std::destroy(location, location + count);
+            pointer source = remain <= count ? location + count : end - count;
+            std::memmove(static_cast<void*>(location), static_cast<const void*>(source), math::min(remain, count) * sizeof(value_type));
         }
         else
         {
-            std::move(end - count, end, location);
+            if (remain <= count)
+            {
+                std::move(location + count, end, location);
+            }
+            else
+            {
+                std::move(end - count, end, location);
+            }
+            std::destroy(end - count, end);
         }
-        std::destroy(end - count, end);
         my_val.size -= count;
         return iterator(location);
     }
     /**
-     * @brief Finds element within the array.
+     * @brief Finds element within the array, arrays of bitwise comparable types are searched with SIMD instructions.
      * @param search
      * @return Index of the found element. INDEX_NONE otherwise.
      */
     NODISCARD size_type find(const param_type search) const
     {
+        if constexpr (simd::is_searchable_v<value_type>)
+        {
+            return static_cast<size_type>(simd::find(data(), size(), search));
+        }
         for (auto it = cbegin(); it < cend(); ++it)
         {
             if (*it == search)
@@ -704,12 +775,17 @@ public:
         return INDEX_NONE;
     }
     /**
-     * @brief Finds last element within the array.
+     * @brief Finds last element within the array, arrays of bitwise comparable types are searched with SIMD
+     * instructions.
      * @param search
      * @return Index of the found element. INDEX_NONE otherwise.
      */
     NODISCARD size_type find_last(const param_type search) const
     {
+        if constexpr (simd::is_searchable_v<value_type>)
+        {
+            return static_cast<size_type>(simd::find_last(data(), size(), search));
+        }
         for (auto it = crbegin(); it < crend(); ++it)
         {
             if (*it == search)
@@ -749,7 +825,7 @@ public:
             if (my_val.capacity <= 0)
             {
                 my_val.ptr = allocator_traits::allocate(get_alloc(), new_capacity);
-                my_val.capacity = new_capacity;
+                my_val.capacity = get_usable_capacity(my_val.ptr, new_capacity);
             }
             else
             {
@@ -813,6 +889,26 @@ public:
 
         my_val.size = count;
     }
+    /**
+     * @brief Resizes the container to contain count elements, added elements are left uninitialized to be overwritten
+     * right after, which saves a pass of zero filling over large buffers.
+     * @param count
+     */
+    void resize_uninitialized(size_type count) requires (std::is_trivially_default_constructible_v<value_type>
+                                                         && std::is_trivially_destructible_v<value_type>)
+    {
+        if (count < 0)
+        {
+            return;
+        }
+
+        auto&& my_val = get_val();
+        if (count > my_val.capacity)
+        {
+            reallocate(my_val, calculate_growth(count));
+        }
+        my_val.size = count;
+    }
     /**
      * @brief Clear the array
      * @param reset_capacity Deallocate the remain capacity. Default is false.
@@ -907,6 +1003,23 @@ private:
         }
     }
 
+    /**
+     * @brief Moves elements to uninitialized memory and destroys the sources, a single memmove for trivially relocatable
+     * types. The ranges may overlap for those.
+     */
+    void relocate_to_uninitialized(pointer first, pointer last, pointer dest)
+    {
+        if constexpr (is_trivially_relocatable_v<value_type>)
+        {
+            std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(value_type));
+        }
+        else
+        {
+            move_to_uninitialized(first, last, dest);
+            std::destroy(first, last);
+        }
+    }
+
     template<typename Iter>
     iterator insert_counted_range(const_iterator where, Iter first, size_type count, bool move_assign = false)
     {
@@ -924,7 +1037,11 @@ private:
             size_type offset = where - cbegin();
             size_type move_count = end - where;
             pointer data = my_val.ptr;
-            if (move_count > 0)
+            if constexpr (is_trivially_relocatable_v<value_type>)
+            {
+                relocate_to_uninitialized(data + offset, data + my_val.size, data + offset + count);
+            }
+            else if (move_count > 0)
             {
                 if (move_count <= count)
                 {
@@ -958,26 +1075,17 @@ private:
             auto&& alloc = get_alloc();
 
             pointer new_ptr = allocator_traits::allocate(alloc, new_capacity);
-            const_iterator begin = cbegin();
-            const_iterator end = cend();
-            size_type offset = where - begin;
+            pointer old_ptr = my_val.ptr;
+            size_type offset = where - cbegin();
             move_assign ?
             move_to_uninitialized(first, first + count, new_ptr + offset) :
             copy_to_uninitialized(first, first + count, new_ptr + offset);
-            if (where == end)
-            {
-                move_to_uninitialized(begin, end, new_ptr);
-            }
-            else
-            {
-                move_to_uninitialized(begin, where, new_ptr);
-                move_to_uninitialized(where, end, new_ptr + offset + count);
-            }
-            std::destroy(begin, end);
+            relocate_to_uninitialized(old_ptr, old_ptr + offset, new_ptr);
+            relocate_to_uninitialized(old_ptr + offset, old_ptr + my_val.size, new_ptr + offset + count);
             allocator_traits::deallocate(alloc, my_val.ptr, my_val.capacity);
             my_val.ptr = new_ptr;
             my_val.size = new_size;
-            my_val.capacity = new_capacity;
+            my_val.capacity = get_usable_capacity(new_ptr, new_capacity);
             return iterator(new_ptr + offset);
         }
     }
@@ -1141,7 +1249,18 @@ private:
             return max_size();
         }
 
-        size_type old = get_val().capacity;
+        const val_type& val = get_val();
+        // the block may hold more than the capacity, growing into its slack moves nothing.
+        if (val.ptr)
+        {
+            const size_type usable = get_usable_capacity(val.ptr, val.capacity);
+            if (requested <= usable)
+            {
+                return usable;
+            }
+        }
+
+        size_type old = val.capacity;
         if (old > max_size() - old)
         {
             return max_size();
@@ -1150,9 +1269,24 @@ private:
         return math::max(requested, 2 * old);
     }
 
+    /**
+     * @brief Gets the elements a block can hold, which is at least the capacity it was allocated with.
+     */
+    size_type get_usable_capacity(const_pointer ptr, size_type capacity) const
+    {
+        return math::min(allocator_traits::usable_size(pair_.first(), const_cast<pointer>(ptr), capacity), max_size());
+    }
+
     void reallocate(val_type& val, size_type new_capacity)
     {
-        if constexpr (std::is_trivially_copyable_v<value_type>)
+        if (val.ptr && new_capacity > val.capacity
+            && allocator_traits::try_expand_in_place(get_alloc(), val.ptr, val.capacity, new_capacity))
+        {
+            val.capacity = get_usable_capacity(val.ptr, new_capacity);
+            return;
+        }
+
+        if constexpr (is_trivially_relocatable_v<value_type>)
         {
             val.ptr = allocator_traits::reallocate(get_alloc(), val.ptr, val.capacity, new_capacity);
         }
@@ -1163,14 +1297,13 @@ private:
             pointer old_ptr = val.ptr;
             if (old_ptr && new_ptr != old_ptr)
             {
-                move_to_uninitialized(old_ptr, old_ptr + val.size, new_ptr);
-                std::destroy(old_ptr, old_ptr + val.size);
+                relocate_to_uninitialized(old_ptr, old_ptr + val.size, new_ptr);
                 allocator_traits::deallocate(get_alloc(), old_ptr, val.capacity);
             }
             val.ptr = new_ptr;
         }
 
-        val.capacity = new_capacity;
+        val.capacity = val.ptr ? get_usable_capacity(val.ptr, new_capacity) : new_capacity;
     }
 
     size_type add_uninitialized(size_type& increase_size)
@@ -1198,7 +1331,7 @@ private:
                 if (my_val.capacity <= 0)
                 {
                     my_val.ptr = allocator_traits::allocate(alloc, new_capacity);
-                    my_val.capacity = new_capacity;
+                    my_val.capacity = get_usable_capacity(my_val.ptr, new_capacity);
                 }
                 else
                 {
@@ -1225,6 +1358,10 @@ private:
     CompressionPair<allocator_type, val_type> pair_;
 };
 
+/** An array only points to its elements, it relocates as long as its allocator does. */
+template<typename T, typename Allocator>
+struct IsTriviallyRelocatable<Array<T, Allocator>> : IsTriviallyRelocatable<typename Array<T, Allocator>::allocator_type> {};
+
 template<typename T, uint32 N>
 using InlineArray = Array<T, InlineAllocator<T, N>>;
 
@@ -0,0 +1,462 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+#include "core_def.hpp"
+#include "container/unordered_map.hpp"
+#include "math/wyhash.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Hash map shared by many threads. Elements are spread over a fixed number of shards by hash and every shard
+ * owns a reader writer lock, so lookups only contend with writes to the same shard and lookups from different threads
+ * run in parallel. There are no iterators, elements are reached through visitation functions which run while the
+ * shard is locked; they must not call back into the same map.
+ * @code
+ * ConcurrentUnorderedMap<StringName, Asset*> assets;
+ * assets.cvisit(name, [](const auto& pair) { use(pair.second); });
+ * assets.insert_or_visit(name, asset, [](auto& pair) { ++pair.second->ref_count; });
+ * @endcode
+ * @tparam ShardCount Must be a power of two. Every shard takes at least a cache line, keep it small for maps embedded in
+ * many objects.
+ */
+template <typename Key, typename Value, typename Hasher = Hash<Key>, typename KeyEqual = EqualTo<Key>,
+          typename Allocator = HeapAllocator<void>, size_t ShardCount = 16>
+class ConcurrentUnorderedMap
+{
+    static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "shard count must be a power of two");
+
+    using map_type = UnorderedMap<Key, Value, Hasher, KeyEqual, Allocator>;
+
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) Shard
+    {
+        mutable std::shared_mutex mutex;
+        map_type map;
+    };
+
+public:
+    using key_type          = typename map_type::key_type;
+    using value_type        = typename map_type::value_type;
+    using size_type         = typename map_type::size_type;
+    using hasher            = typename map_type::hasher;
+    using key_equal         = typename map_type::key_equal;
+    using allocator_type    = typename map_type::allocator_type;
+    using reference         = typename map_type::reference;
+    using const_reference   = typename map_type::const_reference;
+
+private:
+    template<typename K>
+    static constexpr bool is_lookup_key_v = TransparentHash<hasher, key_equal> || std::is_convertible_v<const K&, key_type>;
+
+    /** Keys of other types are converted once here, so the shard and the table hash the same object. */
+    template<typename K>
+    static decltype(auto) to_lookup_key(const K& key)
+    {
+        if constexpr (TransparentHash<hasher, key_equal> || std::is_same_v<K, key_type>)
+        {
+            return (key);
+        }
+        else
+        {
+            return key_type(key);
+        }
+    }
+
+public:
+    static constexpr size_type shard_count = ShardCount;
+
+    /**
+     * @brief Constructor, initialize allocator.
+     * @param alloc
+     */
+    explicit ConcurrentUnorderedMap(const allocator_type& alloc = allocator_type())
+        : ConcurrentUnorderedMap(0, hasher(), key_equal(), alloc) {}
+    /**
+     * @brief Constructor, initialize hash bucket size, hasher, key comparison and allocator.
+     * @param bucket_size Bucket size of the whole map, split evenly between shards.
+     * @param hash
+     * @param equal
+     * @param alloc
+     */
+    explicit ConcurrentUnorderedMap(size_type bucket_size, const hasher& hash = hasher(), const key_equal& equal = key_equal(),
+                                    const allocator_type& alloc = allocator_type())
+        : hash_(hash)
+    {
+        for (Shard& shard : shards_)
+        {
+            shard.map = map_type(bucket_size / ShardCount, hash, equal, alloc);
+        }
+    }
+
+    ConcurrentUnorderedMap(const ConcurrentUnorderedMap&) = delete;
+    ConcurrentUnorderedMap(ConcurrentUnorderedMap&&) = delete;
+    ConcurrentUnorderedMap& operator= (const ConcurrentUnorderedMap&) = delete;
+    ConcurrentUnorderedMap& operator= (ConcurrentUnorderedMap&&) = delete;
+    ~ConcurrentUnorderedMap() = default;
+
+    /**
+     * @brief Get number of elements in map, only exact while no other thread is writing.
+     * @return
+     */
+    NODISCARD size_type size() const
+    {
+        size_type size = 0;
+        for (const Shard& shard : shards_)
+        {
+            std::shared_lock lock(shard.mutex);
+            size += shard.map.size();
+        }
+        return size;
+    }
+    /**
+     * @brief Whether map is empty, only exact while no other thread is writing.
+     * @return
+     */
+    NODISCARD bool is_empty() const
+    {
+        return size() == 0;
+    }
+    /**
+     * @brief Removes all elements, shard by shard.
+     */
+    void clear()
+    {
+        for (Shard& shard : shards_)
+        {
+            std::unique_lock lock(shard.mutex);
+            shard.map.clear();
+        }
+    }
+    /**
+     * @brief Reserves capacity for at least the specified number of elements, split evenly between shards.
+     * @param new_capacity
+     */
+    void reserve(size_type new_capacity)
+    {
+        const size_type shard_capacity = (new_capacity + ShardCount - 1) / ShardCount;
+        for (Shard& shard : shards_)
+        {
+            std::unique_lock lock(shard.mutex);
+            shard.map.reserve(shard_capacity);
+        }
+    }
+    NODISCARD hasher hash_function() const
+    {
+        return hash_;
+    }
+    /**
+     * @brief Inserts value only if there is no key equivalently.
+     * @param key
+     * @param value
+     * @return True if value was inserted.
+     */
+    template<typename K, typename V>
+    bool insert(K&& key, V&& value) requires (std::is_constructible_v<key_type, K&&> && std::is_constructible_v<value_type, V&&>)
+    {
+        return insert_or_visit(std::forward<K>(key), std::forward<V>(value), [](reference) {});
+    }
+    /**
+     * @brief Inserts value, or assigns it to the element if key is already in map.
+     * @param key
+     * @param value
+     * @return True if value was inserted, false if assigned.
+     */
+    template<typename K, typename V>
+    bool insert_or_assign(K&& key, V&& value) requires (std::is_constructible_v<key_type, K&&> && std::is_constructible_v<value_type, V&&>)
+    {
+        if constexpr (!std::is_same_v<std::remove_cvref_t<K>, key_type>)
+        {
+            return insert_or_assign(key_type(std::forward<K>(key)), std::forward<V>(value));
+        }
+        else
+        {
+            Shard& shard = get_shard(key);
+            std::unique_lock lock(shard.mutex);
+            if (value_type* found = shard.map.find_value(key))
+            {
+                *found = std::forward<V>(value);
+                return false;
+            }
+            shard.map.insert(key_type(std::forward<K>(key)), value_type(std::forward<V>(value)));
+            return true;
+        }
+    }
+    /**
+     * @brief Inserts value if there is no key equivalently, otherwise visits the element with exclusive access.
+     * @param key
+     * @param value Left untouched if key is already in map.
+     * @param f Invoked with a pair of key and mutable value.
+     * @return True if value was inserted.
+     */
+    template<typename K, typename V, typename F>
+    bool insert_or_visit(K&& key, V&& value, F&& f) requires (std::is_constructible_v<key_type, K&&> && std::is_constructible_v<value_type, V&&>)
+    {
+        if constexpr (!std::is_same_v<std::remove_cvref_t<K>, key_type>)
+        {
+            return insert_or_visit(key_type(std::forward<K>(key)), std::forward<V>(value), std::forward<F>(f));
+        }
+        else
+        {
+            Shard& shard = get_shard(key);
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end())
+            {
+                f(*it);
+                return false;
+            }
+            shard.map.insert(key_type(std::forward<K>(key)), value_type(std::forward<V>(value)));
+            return true;
+        }
+    }
+    /**
+     * @brief Inserts value if there is no key equivalently, otherwise visits the element with read only access.
+     * @param key
+     * @param value Left untouched if key is already in map.
+     * @param f Invoked with a pair of key and const value.
+     * @return True if value was inserted.
+     */
+    template<typename K, typename V, typename F>
+    bool insert_or_cvisit(K&& key, V&& value, F&& f) requires (std::is_constructible_v<key_type, K&&> && std::is_constructible_v<value_type, V&&>)
+    {
+        return insert_or_visit(std::forward<K>(key), std::forward<V>(value), [&f](const_reference pair) { f(pair); });
+    }
+    /**
+     * @brief Constructs value from args only if there is no key equivalently.
+     * @param key
+     * @param args
+     * @return True if value was inserted.
+     */
+    template<typename K, typename... Args>
+    bool try_emplace(K&& key, Args&&... args) requires std::is_constructible_v<key_type, K&&>
+    {
+        return try_emplace_or_visit(std::forward<K>(key), [](reference) {}, std::forward<Args>(args)...);
+    }
+    /**
+     * @brief Constructs value from args if there is no key equivalently, otherwise visits the element with exclusive
+     * access. Value is only constructed when it is inserted.
+     * @param key
+     * @param f Invoked with a pair of key and mutable value.
+     * @param args
+     * @return True if value was inserted.
+     */
+    template<typename K, typename F, typename... Args>
+    bool try_emplace_or_visit(K&& key, F&& f, Args&&... args) requires std::is_constructible_v<key_type, K&&>
+    {
+        if constexpr (!std::is_same_v<std::remove_cvref_t<K>, key_type>)
+        {
+            return try_emplace_or_visit(key_type(std::forward<K>(key)), std::forward<F>(f), std::forward<Args>(args)...);
+        }
+        else
+        {
+            Shard& shard = get_shard(key);
+            std::unique_lock lock(shard.mutex);
+            auto it = shard.map.find(key);
+            if (it != shard.map.end())
+            {
+                f(*it);
+                return false;
+            }
+            shard.map.insert(key_type(std::forward<K>(key)), value_type(std::forward<Args>(args)...));
+            return true;
+        }
+    }
+    /**
+     * @brief Visits the element of key with exclusive access.
+     * @param key
+     * @param f Invoked with a pair of key and mutable value.
+     * @return Number of elements visited, 0 or 1.
+     */
+    template<typename K, typename F>
+    size_type visit(const K& key, F&& f) requires is_lookup_key_v<K>
+    {
+        decltype(auto) lookup_key = to_lookup_key(key);
+        Shard& shard = get_shard(lookup_key);
+        std::unique_lock lock(shard.mutex);
+        auto it = shard.map.find(lookup_key);
+        if (it == shard.map.end())
+        {
+            return 0;
+        }
+        f(*it);
+        return 1;
+    }
+    /**
+     * @brief Visits the element of key with read only access, other readers of the same shard are not blocked.
+     * @param key
+     * @param f Invoked with a pair of key and const value.
+     * @return Number of elements visited, 0 or 1.
+     */
+    template<typename K, typename F>
+    size_type cvisit(const K& key, F&& f) const requires is_lookup_key_v<K>
+    {
+        decltype(auto) lookup_key = to_lookup_key(key);
+        const Shard& shard = get_shard(lookup_key);
+        std::shared_lock lock(shard.mutex);
+        auto it = shard.map.find(lookup_key);
+        if (it == shard.map.end())
+        {
+            return 0;
+        }
+        f(*it);
+        return 1;
+    }
+    template<typename K, typename F>
+    size_type visit(const K& key, F&& f) const requires is_lookup_key_v<K>
+    {
+        return cvisit(key, std::forward<F>(f));
+    }
+    /**
+     * @brief Visits every element with exclusive access, one shard at a time.
+     * @param f Invoked with a pair of key and mutable value.
+     * @return Number of elements visited.
+     */
+    template<typename F>
+    size_type visit_all(F&& f)
+    {
+        size_type count = 0;
+        for (Shard& shard : shards_)
+        {
+            std::unique_lock lock(shard.mutex);
+            for (auto&& pair : shard.map)
+            {
+                f(pair);
+            }
+            count += shard.map.size();
+        }
+        return count;
+    }
+    /**
+     * @brief Visits every element with read only access, one shard at a time.
+     * @param f Invoked with a pair of key and const value.
+     * @return Number of elements visited.
+     */
+    template<typename F>
+    size_type cvisit_all(F&& f) const
+    {
+        size_type count = 0;
+        for (const Shard& shard : shards_)
+        {
+            std::shared_lock lock(shard.mutex);
+            for (auto&& pair : shard.map)
+            {
+                f(pair);
+            }
+            count += shard.map.size();
+        }
+        return count;
+    }
+    template<typename F>
+    size_type visit_all(F&& f) const
+    {
+        return cvisit_all(std::forward<F>(f));
+    }
+    /**
+     * @brief Copies the value of key out of map. The element may be changed or removed by another thread as soon as
+     * this returns, use visit to act on it atomically.
+     * @param key
+     * @return Empty if key is not in map.
+     */
+    template<typename K>
+    NODISCARD std::optional<value_type> find_value(const K& key) const requires is_lookup_key_v<K>
+    {
+        std::optional<value_type> value;
+        cvisit(key, [&value](const_reference pair) { value.emplace(pair.second); });
+        return value;
+    }
+    template<typename K>
+    NODISCARD bool contains(const K& key) const requires is_lookup_key_v<K>
+    {
+        decltype(auto) lookup_key = to_lookup_key(key);
+        const Shard& shard = get_shard(lookup_key);
+        std::shared_lock lock(shard.mutex);
+        return shard.map.contains(lookup_key);
+    }
+    /**
+     * @brief Removes the element of key.
+     * @param key
+     * @return True if an element was removed.
+     */
+    template<typename K>
+    bool remove(const K& key) requires is_lookup_key_v<K>
+    {
+        return remove_if(key, [](const_reference) { return true; });
+    }
+    /**
+     * @brief Removes the element of key if predicate returns true for it.
+     * @param key
+     * @param predicate Invoked with a pair of key and mutable value.
+     * @return True if an element was removed.
+     */
+    template<typename K, typename F>
+    bool remove_if(const K& key, F&& predicate) requires is_lookup_key_v<K>
+    {
+        decltype(auto) lookup_key = to_lookup_key(key);
+        Shard& shard = get_shard(lookup_key);
+        std::unique_lock lock(shard.mutex);
+        auto it = shard.map.find(lookup_key);
+        if (it == shard.map.end() || !predicate(*it))
+        {
+            return false;
+        }
+        shard.map.remove(it);
+        return true;
+    }
+    /**
+     * @brief Removes every element predicate returns true for, one shard at a time.
+     * @param predicate Invoked with a pair of key and mutable value.
+     * @return Number of elements removed.
+     */
+    template<typename F>
+    size_type remove_all(F&& predicate)
+    {
+        size_type count = 0;
+        for (Shard& shard : shards_)
+        {
+            std::unique_lock lock(shard.mutex);
+            for (auto it = shard.map.begin(); it != shard.map.end();)
+            {
+                if (predicate(*it))
+                {
+                    it = shard.map.remove(it);
+                    ++count;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+        return count;
+    }
+
+private:
+    /**
+     * The hash is mixed again, so the shard index does not take the bits the table of the shard uses.
+     * The table of the shard hashes the key once more, it takes no precomputed hash. Keys with costly hashes should
+     * cache them, StringName hashes its ids.
+     */
+    template<typename K>
+    Shard& get_shard(const K& key)
+    {
+        return shards_[wyhash::hash64(static_cast<uint64>(hash_(key))) & (ShardCount - 1)];
+    }
+
+    template<typename K>
+    const Shard& get_shard(const K& key) const
+    {
+        return shards_[wyhash::hash64(static_cast<uint64>(hash_(key))) & (ShardCount - 1)];
+    }
+
+    hasher hash_;
+    Shard shards_[ShardCount];
+};
+
+} // namespace atlas
@@ -7,15 +7,25 @@
 #include "boost/unordered/detail/foa/flat_map_types.hpp"
 
 #include "memory/allocator.hpp"
+#include "utility/hash.hpp"
 
 namespace atlas
 {
 
-template <typename Key, typename Value, typename Allocator = HeapAllocator<void>>
+/**
+ * @brief Open addressing hash map. When Hasher and KeyEqual are transparent, as they are for String keys, lookups take
+ * any type they accept without constructing a key:
+ * @code
+ * UnorderedMap<String, Asset*> assets;
+ * Asset** asset = assets.find_value(StringView(path));
+ * @endcode
+ */
+template <typename Key, typename Value, typename Hasher = Hash<Key>, typename KeyEqual = EqualTo<Key>,
+          typename Allocator = HeapAllocator<void>>
 class UnorderedMap
 {
     using map_types = boost::unordered::detail::foa::flat_map_types<Key, Value>;
-    using table_type = boost::unordered::detail::foa::table<map_types, std::hash<Key>, std::equal_to<Key>,
+    using table_type = boost::unordered::detail::foa::table<map_types, Hasher, KeyEqual,
         typename AllocatorRebind<Allocator, typename map_types::value_type>::type>;
 public:
     using key_type          = typename map_types::key_type;
@@ -47,6 +57,15 @@ public:
      */
     explicit UnorderedMap(size_type bucket_size, const allocator_type& alloc = allocator_type())
         : table_(bucket_size, hasher(), key_equal(), alloc) {}
+    /**
+     * @brief Constructor, initialize hash bucket size, hasher, key comparison and allocator.
+     * @param bucket_size
+     * @param hash
+     * @param equal
+     * @param alloc
+     */
+    UnorderedMap(size_type bucket_size, const hasher& hash, const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+        : table_(bucket_size, hash, equal, alloc) {}
     /**
      * @brief Constructor from an initializer
      * @param initializer
@@ -123,6 +142,41 @@ public:
     {
         table_.reserve(new_capacity);
     }
+    /**
+     * @brief Resizes the table to hold at least bucket_size buckets and no fewer than the elements need, a bucket size
+     * of 0 shrinks it to fit.
+     * @param bucket_size
+     */
+    void rehash(size_type bucket_size)
+    {
+        table_.rehash(bucket_size);
+    }
+    /**
+     * @brief Gets the average number of elements per bucket.
+     * @return
+     */
+    NODISCARD float load_factor() const
+    {
+        return table_.load_factor();
+    }
+    /**
+     * @brief Gets the load factor the table grows at, it is fixed by the table.
+     * @return
+     */
+    NODISCARD float max_load_factor() const
+    {
+        return table_.max_load_factor();
+    }
+
+    NODISCARD hasher hash_function() const
+    {
+        return table_.hash_function();
+    }
+
+    NODISCARD key_equal key_eq() const
+    {
+        return table_.key_eq();
+    }
     /**
      * @brief Inserts value only if there is no key equivalently.
      * @param key
@@ -207,7 +261,7 @@ public:
         iterator it = table_.find(key);
         if (it == end())
         {
-            it = table_.insert({key, value_type()});
+            it = table_.insert({key, value_type()}).first;
         }
         return it;
     }
@@ -221,7 +275,23 @@ public:
         iterator it = table_.find(key);
         if (it == end())
         {
-            it = table_.insert({std::forward<key_type>(key), value_type()});
+            it = table_.insert({std::forward<key_type>(key), value_type()}).first;
+        }
+        return it;
+    }
+    /**
+     * @brief Finds the element associated with given key, or if none exists, adds a value using the default constructor.
+     * The key is only constructed when inserting.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    iterator find_or_insert(const K& key) requires TransparentHash<hasher, key_equal>
+    {
+        iterator it = table_.find(key);
+        if (it == end())
+        {
+            it = table_.insert({key_type(key), value_type()}).first;
         }
         return it;
     }
@@ -234,6 +304,16 @@ public:
     {
         return table_.find(key) != end();
     }
+    /**
+     * @brief Returns whether map contains equivalently element.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    NODISCARD bool contains(const K& key) const requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(key) != end();
+    }
     /**
      * @brief Finds the element associated with given key.
      * @param key
@@ -252,6 +332,26 @@ public:
     {
         return table_.find(key);
     }
+    /**
+     * @brief Finds the element associated with given key.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    NODISCARD iterator find(const K& key) requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(key);
+    }
+    /**
+     * @brief Finds the element associated with given key.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    NODISCARD const_iterator find(const K& key) const requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(key);
+    }
     /**
      * @brief Finds the value associated with given key.
      * @param key
@@ -272,6 +372,28 @@ public:
         const_iterator it = table_.find(key);
         return it == end() ? nullptr : &it->second;
     }
+    /**
+     * @brief Finds the value associated with given key.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    NODISCARD value_type* find_value(const K& key) requires TransparentHash<hasher, key_equal>
+    {
+        iterator it = table_.find(key);
+        return it == end() ? nullptr : &it->second;
+    }
+    /**
+     * @brief Finds the value associated with given key.
+     * @param key
+     * @return
+     */
+    template<typename K>
+    NODISCARD const value_type* find_value(const K& key) const requires TransparentHash<hasher, key_equal>
+    {
+        const_iterator it = table_.find(key);
+        return it == end() ? nullptr : &it->second;
+    }
     /**
      * @brief Finds the value associated with given key.
      * @param key
@@ -280,7 +402,7 @@ public:
     NODISCARD value_type& find_value_ref(const key_param_type key)
     {
         iterator it = table_.find(key);
-        ASSERT(it == end());
+        ASSERT(it != end());
         return it->second;
     }
     /**
@@ -290,8 +412,8 @@ public:
      */
     NODISCARD const value_type& find_value_ref(const key_param_type key) const
     {
-        iterator it = table_.find(key);
-        ASSERT(it == end());
+        const_iterator it = table_.find(key);
+        ASSERT(it != end());
         return it->second;
     }
     /**
@@ -303,6 +425,16 @@ public:
     {
         return table_.erase(value);
     }
+    /**
+     * @brief Removes element associated with given key.
+     * @param value
+     * @return
+     */
+    template<typename K>
+    bool remove(const K& value) requires (TransparentHash<hasher, key_equal> && !std::is_convertible_v<const K&, const_iterator> && !std::is_convertible_v<const K&, iterator>)
+    {
+        return table_.erase(value);
+    }
     /**
      * @brief Removes element at given position.
      * @param where
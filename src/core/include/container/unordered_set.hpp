@@ -7,15 +7,19 @@
 #include "boost/unordered/detail/foa/flat_set_types.hpp"
 
 #include "memory/allocator.hpp"
+#include "utility/hash.hpp"
 
 namespace atlas
 {
 
-template <typename Key, typename Allocator = HeapAllocator<Key>>
+/**
+ * @brief Open addressing hash set, see UnorderedMap for lookups with other types than the key.
+ */
+template <typename Key, typename Hasher = Hash<Key>, typename KeyEqual = EqualTo<Key>, typename Allocator = HeapAllocator<Key>>
 class UnorderedSet
 {
     using set_types = boost::unordered::detail::foa::flat_set_types<Key>;
-    using table_type = boost::unordered::detail::foa::table<set_types, std::hash<Key>, std::equal_to<Key>, Allocator>;
+    using table_type = boost::unordered::detail::foa::table<set_types, Hasher, KeyEqual, Allocator>;
 
 public:
     using key_type              = typename set_types::key_type;
@@ -48,6 +52,15 @@ public:
      */
     explicit UnorderedSet(size_type bucket_size, const allocator_type& alloc = allocator_type())
         : table_(bucket_size, hasher(), key_equal(), alloc) {}
+    /**
+     * @brief Constructor, initialize hash bucket size, hasher, key comparison and allocator.
+     * @param bucket_size
+     * @param hash
+     * @param equal
+     * @param alloc
+     */
+    UnorderedSet(size_type bucket_size, const hasher& hash, const key_equal& equal = key_equal(), const allocator_type& alloc = allocator_type())
+        : table_(bucket_size, hash, equal, alloc) {}
     /**
      * @brief Constructor from an initializer
      * @param initializer
@@ -128,6 +141,31 @@ public:
     {
         table_.reserve(new_capacity);
     }
+    /**
+     * @brief Resizes the table to hold at least bucket_size buckets and no fewer than the elements need, a bucket size
+     * of 0 shrinks it to fit.
+     * @param bucket_size
+     */
+    void rehash(size_type bucket_size)
+    {
+        table_.rehash(bucket_size);
+    }
+    /**
+     * @brief Gets the average number of elements per bucket.
+     * @return
+     */
+    NODISCARD float load_factor() const
+    {
+        return table_.load_factor();
+    }
+    /**
+     * @brief Gets the load factor the table grows at, it is fixed by the table.
+     * @return
+     */
+    NODISCARD float max_load_factor() const
+    {
+        return table_.max_load_factor();
+    }
     void clear()
     {
         table_.clear();
@@ -181,6 +219,16 @@ public:
     {
         return table_.find(value) != end();
     }
+    /**
+     * @brief Returns whether set contains equivalently element.
+     * @param value
+     * @return
+     */
+    template<typename K>
+    NODISCARD bool contains(const K& value) const requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(value) != end();
+    }
     /**
      * @brief Finds element equivalent to the given one.
      * @param value
@@ -199,6 +247,26 @@ public:
     {
         return table_.find(value);
     }
+    /**
+     * @brief Finds element equivalent to the given one.
+     * @param value
+     * @return
+     */
+    template<typename K>
+    NODISCARD iterator find(const K& value) requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(value);
+    }
+    /**
+     * @brief Finds element equivalent to the given one.
+     * @param value
+     * @return
+     */
+    template<typename K>
+    NODISCARD const_iterator find(const K& value) const requires TransparentHash<hasher, key_equal>
+    {
+        return table_.find(value);
+    }
     /**
      * @brief Removes element equivalent to the given one.
      * @param value
@@ -208,6 +276,17 @@ public:
     {
         return table_.erase(value);
     }
+    /**
+     * @brief Removes element equivalent to the given one.
+     * @param value
+     * @return
+     */
+    template<typename K>
+    bool remove(const K& value) requires (TransparentHash<hasher, key_equal> && !std::is_convertible_v<const K&, const_iterator>
+                                          && !std::is_convertible_v<const K&, iterator>)
+    {
+        return table_.erase(value);
+    }
     /**
      * @brief Removes element at given position.
      * @param where
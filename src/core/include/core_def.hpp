@@ -64,7 +64,7 @@ __GNUC_PATCHLEVEL__)
 #elif PLATFORM_APPLE
 #include "platform/mac/mac_platform.hpp"
 #elif PLATFORM_LINUX
-
+#include "platform/linux/linux_platform.hpp"
 #endif
 
 
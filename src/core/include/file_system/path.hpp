@@ -657,6 +657,9 @@ private:
     String text_;
 };
 
+template<>
+struct IsTriviallyRelocatable<Path> : IsTriviallyRelocatable<String> {};
+
 } // namespace atlas
 
 template<>
@@ -3,17 +3,77 @@
 
 #pragma once
 
+#include <optional>
+
 #include "async/schedule_on.hpp"
 #include "async/static_thread_pool.hpp"
+#include "async/work_stealing_thread_pool.hpp"
 #include "io_backend_interface.hpp"
+#include "utility/stop_token.hpp"
+
+/** Capacity of every io priority queue. Non zero backs io with bounded MPMC ring queues instead of work stealing. */
+#ifndef IO_BOUNDED_QUEUE_CAPACITY
+#define IO_BOUNDED_QUEUE_CAPACITY 0
+#endif
 
 namespace atlas
 {
 
 class FilesystemIOBackend : public IIOBackend
 {
+    /**
+     * @brief A read queued on the io pool. The pool task and a stop request race to claim it, the winner resumes the
+     * read, so a cancelled read does not wait for its turn in the queue.
+     */
+    struct QueuedRead
+    {
+        /**
+         * @brief Arrives once from await_suspend and once from the stop callback if it has claimed the read.
+         * @return True if caller is the last one to arrive.
+         */
+        bool arrive()
+        {
+            return arrivals.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        }
+
+        void release()
+        {
+            if (uses.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        std::coroutine_handle<> handle{ nullptr };
+        // held by the awaiter, the pool task and await_suspend until it returns.
+        std::atomic<uint32> uses{ 3 };
+        std::atomic<uint32> arrivals{ 2 };
+        std::atomic<bool> claimed{ false };
+        bool cancelled{ false };
+    };
+
+    struct QueuedReadStopHandler
+    {
+        void operator()() const
+        {
+            if (!read->claimed.exchange(true, std::memory_order_acq_rel))
+            {
+                read->cancelled = true;
+                if (read->arrive())
+                {
+                    read->handle.resume();
+                }
+            }
+        }
+
+        QueuedRead* read;
+    };
+
 public:
     using awaiter_type = ScheduleAwaiter<FilesystemIOBackend, EIOPriority>;
+    using thread_pool_type = std::conditional_t<(IO_BOUNDED_QUEUE_CAPACITY > 0),
+        StaticThreadPool<g_io_priority_count, BoundedThreadPoolPolicy<IO_BOUNDED_QUEUE_CAPACITY>>,
+        WorkStealingThreadPool<g_io_priority_count>>;
 
     FilesystemIOBackend()
         : thread_pool_(get_io_worker_count(), "io thread")
@@ -26,6 +86,91 @@ public:
         thread_pool_.push_task(static_cast<uint32>(priority), [=] { handle.resume(); });
     }
 
+    /**
+     * @brief Moves the awaiting read onto the io pool. A stop request resumes the read as cancelled at once, on the
+     * requesting thread, its entry in the queue does nothing once it runs.
+     */
+    class ReadScheduleAwaiter
+    {
+    public:
+        ReadScheduleAwaiter(FilesystemIOBackend& backend, EIOPriority priority, StopToken stop_token) noexcept
+            : backend_(backend)
+            , priority_(priority)
+            , stop_token_(std::move(stop_token))
+        {}
+
+        ReadScheduleAwaiter(ReadScheduleAwaiter&& rhs) noexcept
+            : backend_(rhs.backend_)
+            , priority_(rhs.priority_)
+            , stop_token_(std::move(rhs.stop_token_))
+        {}
+
+        ReadScheduleAwaiter(const ReadScheduleAwaiter&) = delete;
+        ReadScheduleAwaiter& operator=(const ReadScheduleAwaiter&) = delete;
+
+        ~ReadScheduleAwaiter()
+        {
+            // waits for a stop callback that lost the race, before the read is released.
+            stop_callback_.reset();
+            if (read_)
+            {
+                read_->release();
+            }
+        }
+
+        bool await_ready() const noexcept
+        {
+            return stop_token_.stop_requested();
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            if (!stop_token_.stop_possible())
+            {
+                backend_.schedule(handle, priority_);
+                return true;
+            }
+
+            QueuedRead* read = new QueuedRead();
+            read->handle = handle;
+            read_ = read;
+            stop_callback_.emplace(stop_token_, QueuedReadStopHandler{ read });
+            // the read may be resumed on the pool as soon as it is pushed, only the local pointer is safe afterwards.
+            backend_.thread_pool_.push_task(static_cast<uint32>(priority_), [read] {
+                if (!read->claimed.exchange(true, std::memory_order_acq_rel))
+                {
+                    read->handle.resume();
+                }
+                read->release();
+            });
+
+            // a stop callback that claimed the read before this arrived leaves the resumption to this thread.
+            const bool suspend = !read->arrive();
+            read->release();
+            return suspend;
+        }
+
+        /**
+         * @return False if the read was cancelled before it ran.
+         */
+        bool await_resume() const noexcept
+        {
+            return !stop_token_.stop_requested() && !(read_ && read_->cancelled);
+        }
+
+    private:
+        FilesystemIOBackend& backend_;
+        EIOPriority priority_;
+        StopToken stop_token_;
+        QueuedRead* read_{ nullptr };
+        std::optional<StopCallback<QueuedReadStopHandler>> stop_callback_;
+    };
+
+    ReadScheduleAwaiter co_schedule_read(EIOPriority priority, StopToken stop_token)
+    {
+        return ReadScheduleAwaiter(*this, priority, std::move(stop_token));
+    }
+
     Task<size_t> async_read(Path file, IOBuffer& buffer, size_t read_size, size_t offset, EIOPriority priority) override;
 
     Task<size_t> async_write(Path file, IOBuffer buffer, bool append, EIOPriority priority) override;
@@ -33,7 +178,7 @@ public:
     static uint32 get_io_worker_count();
 
 private:
-    StaticThreadPool<g_io_priority_count> thread_pool_;
+    thread_pool_type thread_pool_;
 };
 
 }// namespace atlas
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "async/async_generator.hpp"
 #include "io/io_backend_interface.hpp"
 #include "utility/delegate_fwd.hpp"
 
@@ -11,6 +12,7 @@ namespace atlas
 
 /**
  * @brief LowLevelIO provides fast asynchronous file read and write interfaces.
+ * A read takes the stop token of the awaiting coroutine, a stop request cancels it while it waits for an io worker.
  */
 class CORE_API LowLevelIO
 {
@@ -107,6 +109,35 @@ public:
         ASSERT(io_backend_);
         return io_backend_->async_read(std::move(file), buffer, read_size, offset, priority);
     }
+    /**
+     * @brief Asynchronously reads the given file chunk by chunk. The next chunk is read only when the consumer asks
+     * for it, so a large file can be streamed through later stages without being loaded as a whole.
+     * @param file
+     * @param chunk_size
+     * @param priority
+     * @return
+     */
+    AsyncGenerator<IOBuffer> async_read_chunks(Path file, size_t chunk_size, EIOPriority priority = EIOPriority::Normal)
+    {
+        ASSERT(io_backend_ && chunk_size > 0);
+        std::error_code error;
+        const size_t file_size = std::filesystem::file_size(file.to_string().data(), error);
+        if (error)
+        {
+            co_return;
+        }
+
+        for (size_t offset = 0; offset < file_size; offset += chunk_size)
+        {
+            IOBuffer buffer;
+            if (co_await io_backend_->async_read(file, buffer, chunk_size, offset, priority) == 0)
+            {
+                co_return;
+            }
+            co_yield buffer;
+        }
+    }
+
     /** Asynchronously writes the given buffer to file.
      * @brief
      * @param file
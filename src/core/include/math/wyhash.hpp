@@ -0,0 +1,155 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstring>
+
+#include "core_def.hpp"
+
+#if defined(COMPILER_MSVC) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+/**
+ * wyhash final version 4.2 by Wang Yi, released to the public domain. It is among the fastest hashes for the short
+ * keys of hash maps and its output is well distributed, so tables need no extra mixing.
+ * https://github.com/wangyi-fudan/wyhash
+ */
+namespace atlas::wyhash
+{
+
+namespace details
+{
+
+inline constexpr uint64 secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+/** 128 bit product of a and b, low half in a and high half in b. */
+inline void multiply(uint64& a, uint64& b)
+{
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    a = static_cast<uint64>(product);
+    b = static_cast<uint64>(product >> 64);
+#elif defined(COMPILER_MSVC) && defined(_M_X64)
+    a = _umul128(a, b, &b);
+#elif defined(COMPILER_MSVC) && defined(_M_ARM64)
+    const uint64 low = a * b;
+    b = __umulh(a, b);
+    a = low;
+#else
+    const uint64 ha = a >> 32, hb = b >> 32, la = static_cast<uint32>(a), lb = static_cast<uint32>(b);
+    const uint64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    const uint64 t = rl + (rm0 << 32);
+    uint64 c = t < rl;
+    const uint64 low = t + (rm1 << 32);
+    c += low < t;
+    a = low;
+    b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64 mix(uint64 a, uint64 b)
+{
+    multiply(a, b);
+    return a ^ b;
+}
+
+inline uint64 read8(const uint8* p)
+{
+    uint64 value;
+    std::memcpy(&value, p, 8);
+    return value;
+}
+
+inline uint64 read4(const uint8* p)
+{
+    uint32 value;
+    std::memcpy(&value, p, 4);
+    return value;
+}
+
+inline uint64 read3(const uint8* p, size_t size)
+{
+    return (static_cast<uint64>(p[0]) << 16) | (static_cast<uint64>(p[size >> 1]) << 8) | p[size - 1];
+}
+
+}// namespace details
+
+/**
+ * @brief Hashes a byte array.
+ * @param data
+ * @param size
+ * @param seed
+ * @return
+ */
+NODISCARD inline uint64 hash64(const void* data, size_t size, uint64 seed = 0)
+{
+    using namespace details;
+
+    const uint8* p = static_cast<const uint8*>(data);
+    seed ^= mix(seed ^ secret[0], secret[1]);
+    uint64 a, b;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            a = (read4(p) << 32) | read4(p + ((size >> 3) << 2));
+            b = (read4(p + size - 4) << 32) | read4(p + size - 4 - ((size >> 3) << 2));
+        }
+        else if (size > 0)
+        {
+            a = read3(p, size);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = size;
+        if (i > 48)
+        {
+            uint64 see1 = seed, see2 = seed;
+            do
+            {
+                seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+                see1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ see1);
+                see2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            }
+            while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    multiply(a, b);
+    return mix(a ^ secret[0] ^ size, b ^ secret[1]);
+}
+
+/**
+ * @brief Hashes a 64 bit integer.
+ * @param value
+ * @return
+ */
+NODISCARD inline uint64 hash64(uint64 value)
+{
+    return details::mix(value ^ details::secret[0], value ^ details::secret[1]);
+}
+
+}// namespace atlas::wyhash
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 
 #include "assertion.hpp"
@@ -14,6 +15,18 @@
 namespace atlas
 {
 
+/**
+ * @brief Whether moving a value to a new address and destroying the source is the same as copying its bytes, containers
+ * move such types with memmove when they grow, insert or erase. Types that hold no pointer into themselves and are not
+ * registered anywhere by address may opt in.
+ * @tparam T
+ */
+template<typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_trivially_relocatable_v = IsTriviallyRelocatable<T>::value;
+
 namespace details
 {
 
@@ -34,6 +47,23 @@ struct HasReallocate<AllocatorType, PointerType, SizeType,
                                                                                    std::declval<SizeType>(),
                                                                                    std::declval<SizeType>()))>> : std::true_type {};
 
+template <typename AllocatorType, typename PointerType, typename SizeType, typename = void>
+struct HasUsableSize : std::false_type {};
+
+template <typename AllocatorType, typename PointerType, typename SizeType>
+struct HasUsableSize<AllocatorType, PointerType, SizeType,
+                     std::void_t<decltype(std::declval<const AllocatorType>().usable_size(std::declval<PointerType>(),
+                                                                                          std::declval<SizeType>()))>> : std::true_type {};
+
+template <typename AllocatorType, typename PointerType, typename SizeType, typename = void>
+struct HasTryExpandInPlace : std::false_type {};
+
+template <typename AllocatorType, typename PointerType, typename SizeType>
+struct HasTryExpandInPlace<AllocatorType, PointerType, SizeType,
+                           std::void_t<decltype(std::declval<AllocatorType>().try_expand_in_place(std::declval<PointerType>(),
+                                                                                                   std::declval<SizeType>(),
+                                                                                                   std::declval<SizeType>()))>> : std::true_type {};
+
 template <typename AllocatorType, typename = void>
 struct HasInitializeSize : std::false_type {};
 
@@ -66,11 +96,45 @@ public:
         else
         {
             typename base::pointer new_ptr = base::allocate(allocator, new_count);
-            std::memmove(new_ptr, ptr, details::get_byte_size<sizeof(base::value_type)>(math::min(old_count, new_count)));
+            std::memmove(static_cast<void*>(new_ptr), static_cast<const void*>(ptr),
+                         details::get_byte_size<sizeof(base::value_type)>(math::min(old_count, new_count)));
             base::deallocate(allocator, ptr, old_count);
             return new_ptr;
         }
     }
+
+    /**
+     * @brief Gets the elements a block can hold, which may be more than it was allocated with.
+     * @param allocator
+     * @param ptr
+     * @param count Elements the block was allocated with.
+     * @return
+     */
+    static constexpr base::size_type usable_size(const AllocatorType& allocator, base::pointer ptr, base::size_type count)
+    {
+        if constexpr (details::HasUsableSize<AllocatorType, typename base::pointer, typename base::size_type>::value)
+        {
+            return allocator.usable_size(ptr, count);
+        }
+        return count;
+    }
+
+    /**
+     * @brief Resizes a block without moving it.
+     * @param allocator
+     * @param ptr
+     * @param old_count
+     * @param new_count
+     * @return False if the block has to be reallocated.
+     */
+    static constexpr bool try_expand_in_place(AllocatorType& allocator, base::pointer ptr, base::size_type old_count, base::size_type new_count)
+    {
+        if constexpr (details::HasTryExpandInPlace<AllocatorType, typename base::pointer, typename base::size_type>::value)
+        {
+            return allocator.try_expand_in_place(ptr, old_count, new_count);
+        }
+        return false;
+    }
 };
 
 /**
@@ -121,6 +185,26 @@ public:
         deallocate_impl<alignof(T)>(ptr);
     }
 
+    NODISCARD size_type usable_size(value_type* ptr, const size_type size) const
+    {
+        if constexpr (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            const size_t usable = Memory::usable_size(ptr) / sizeof(T);
+            constexpr size_t max_count = static_cast<size_t>(std::numeric_limits<size_type>::max());
+            return usable > static_cast<size_t>(size) ? static_cast<size_type>(math::min(usable, max_count)) : size;
+        }
+        return size;
+    }
+
+    bool try_expand_in_place(value_type* ptr, const size_type old_size, const size_type size)
+    {
+        if constexpr (alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            return Memory::try_expand_in_place(ptr, details::get_byte_size<sizeof(T)>(size));
+        }
+        return false;
+    }
+
 private:
     template<size_t Align, std::enable_if_t<(Align <= __STDCPP_DEFAULT_NEW_ALIGNMENT__), int> = 0>
     constexpr void* allocate_impl(size_t byte_size)
@@ -293,4 +377,106 @@ private:
     CompressionPair<secondary_allocator, InlineBuffer> pair_;
 };
 
+/**
+ * @brief Allocates every buffer from a range of virtual memory of its own, for large buffers like asset data that
+ * suffer from TLB misses with regular pages. Ranges are rounded up to 64KB, or 2MB with huge pages, so keep it to
+ * buffers of megabytes.
+ * @tparam HugePages
+ */
+template<typename T, EHugePages HugePages = EHugePages::Transparent, typename SizeType = size_t>
+class VirtualMemoryAllocator
+{
+public:
+    using value_type = T;
+    using size_type = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = VirtualMemoryAllocator<Other, HugePages, size_type>;
+    };
+
+    constexpr VirtualMemoryAllocator() noexcept = default;
+
+    /**
+     * @brief Constructs an allocator that places buffers on a NUMA node.
+     * @param numa_node Node physical pages are preferably taken from, or PlatformMemory::any_numa_node.
+     * @param prefault Faults pages in at allocation, instead of at first touch.
+     */
+    constexpr explicit VirtualMemoryAllocator(uint32 numa_node, bool prefault = false) noexcept
+        : numa_node_(numa_node), prefault_(prefault) {}
+
+    constexpr VirtualMemoryAllocator(const VirtualMemoryAllocator&) noexcept = default;
+
+    template<typename Other>
+    constexpr VirtualMemoryAllocator(const VirtualMemoryAllocator<Other, HugePages, SizeType>& right) noexcept
+        : numa_node_(right.get_numa_node()), prefault_(right.get_prefault()) {}
+
+    constexpr ~VirtualMemoryAllocator() noexcept = default;
+
+    template<typename Other>
+    bool operator==(const VirtualMemoryAllocator<Other, HugePages, SizeType>&) const
+    {
+        return true;
+    }
+
+    NODISCARD value_type* allocate(const size_type size)
+    {
+        const size_t reserve_size = get_reserve_size(size);
+        void* ptr = PlatformMemory::reserve(reserve_size, HugePages, numa_node_);
+        ASSERT(ptr);
+        PlatformMemory::commit(ptr, reserve_size, prefault_);
+        return static_cast<value_type*>(ptr);
+    }
+
+    NODISCARD value_type* reallocate(value_type* ptr, const size_type old_size, const size_type size)
+    {
+        // the whole range is committed, so the buffer grows in place until it is full.
+        if (ptr && get_reserve_size(old_size) == get_reserve_size(size))
+        {
+            return ptr;
+        }
+
+        value_type* new_ptr = allocate(size);
+        if (ptr)
+        {
+            std::memcpy(new_ptr, ptr, details::get_byte_size<sizeof(T)>(math::min(old_size, size)));
+            deallocate(ptr, old_size);
+        }
+        return new_ptr;
+    }
+
+    void deallocate(value_type* const ptr, const size_type size)
+    {
+        PlatformMemory::release(ptr, get_reserve_size(size));
+    }
+
+    NODISCARD size_type usable_size(value_type* ptr, const size_type size) const
+    {
+        const size_t usable = get_reserve_size(size) / sizeof(T);
+        constexpr size_t max_count = static_cast<size_t>(std::numeric_limits<size_type>::max());
+        return static_cast<size_type>(math::min(usable, max_count));
+    }
+
+    NODISCARD uint32 get_numa_node() const
+    {
+        return numa_node_;
+    }
+
+    NODISCARD bool get_prefault() const
+    {
+        return prefault_;
+    }
+
+private:
+    static size_t get_reserve_size(const size_type size)
+    {
+        return PlatformMemory::get_reserve_size(details::get_byte_size<sizeof(T)>(math::max(size, size_type(1))), HugePages);
+    }
+
+    uint32 numa_node_{ PlatformMemory::any_numa_node };
+    bool prefault_{ false };
+};
+
 }
@@ -23,5 +23,26 @@ public:
     virtual void free(void* ptr) = 0;
 
     virtual void aligned_free(void* ptr) = 0;
+
+    /**
+     * @brief Gets the bytes a block of malloc or realloc can hold, which is often more than requested.
+     * @param ptr
+     * @return 0 if the allocator doesn't know.
+     */
+    virtual size_t usable_size(void*)
+    {
+        return 0;
+    }
+
+    /**
+     * @brief Resizes a block of malloc or realloc without moving it.
+     * @param ptr
+     * @param new_size
+     * @return False if the block stays as it is, it has to be reallocated then.
+     */
+    virtual bool try_expand_in_place(void* ptr, size_t new_size)
+    {
+        return ptr && new_size <= usable_size(ptr);
+    }
 };
 }
\ No newline at end of file
@@ -12,6 +12,7 @@
 #elif PLATFORM_APPLE
 #include "platform/mac/mac_memory.hpp"
 #elif PLATFORM_LINUX
+#include "platform/linux/linux_memory.hpp"
 #endif
 
 namespace atlas
@@ -49,20 +50,47 @@ public:
         get_malloc_instance()->aligned_free(ptr);
     }
 
-    Memory() = delete;
-    ~Memory() = delete;
+    static size_t usable_size(void* ptr)
+    {
+        return get_malloc_instance()->usable_size(ptr);
+    }
+
+    static bool try_expand_in_place(void* ptr, size_t new_size)
+    {
+        return get_malloc_instance()->try_expand_in_place(ptr, new_size);
+    }
 
-private:
     static MallocBase* get_malloc_instance()
     {
         if (!malloc_instance_)
         {
-            malloc_instance_ = PlatformMemory::GetDefaultMalloc();
+            malloc_instance_ = create_default_malloc();
         }
 
-        return malloc_instance_.get();
+        return malloc_instance_;
     }
 
-    static inline std::unique_ptr<MallocBase> malloc_instance_;
+    /**
+     * @brief Replaces the allocator, this is meant to be done once at startup before other threads allocate.
+     * Blocks allocated before are still freed through the new allocator, so it has to forward blocks it does not own
+     * to the previous one, see ThreadCachingMalloc.
+     * @param instance Never destroyed, blocks may still be freed by static destructors.
+     */
+    static void set_malloc_instance(MallocBase* instance)
+    {
+        malloc_instance_ = instance;
+    }
+
+    Memory() = delete;
+    ~Memory() = delete;
+
+private:
+    /**
+     * @brief Creates the platform allocator, wrapped in a TrackingMalloc when built with WITH_MEMORY_TRACKING.
+     * @return
+     */
+    static MallocBase* create_default_malloc();
+
+    static inline MallocBase* malloc_instance_{ nullptr };
 };
 }
\ No newline at end of file
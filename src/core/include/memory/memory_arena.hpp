@@ -0,0 +1,241 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "memory/allocator.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct ArenaChunk;
+
+}// namespace details
+
+/**
+ * @brief A bump allocator over a list of chunks. Allocating moves a cursor forward, single blocks are never freed,
+ * instead the arena is rewound to a marker or reset as a whole. Chunks are kept for reuse until the arena is destroyed.
+ * Usage:
+ * @code
+ * MemoryArena::Marker marker = arena.get_marker();
+ * Array<int32, ArenaAllocator<int32>> temp(ArenaAllocator<int32>(arena));
+ * // ...
+ * temp.clear();
+ * arena.rewind(marker);
+ * @endcode
+ * @note Not thread safe.
+ */
+class CORE_API MemoryArena
+{
+public:
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    /**
+     * @brief Position of an arena, allocations after it are released by rewind.
+     */
+    struct Marker
+    {
+        details::ArenaChunk* chunk{ nullptr };
+        size_t offset{ 0 };
+    };
+
+    /**
+     * @brief Constructs an empty arena, no memory is allocated until the first allocation.
+     * @param chunk_size Size of every chunk, larger allocations get a chunk of their own.
+     */
+    explicit MemoryArena(size_t chunk_size = default_chunk_size);
+
+    ~MemoryArena();
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    NODISCARD void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        char* ptr = align_up(cursor_, alignment);
+        if (ptr && ptr + size <= end_)
+        {
+            cursor_ = ptr + size;
+            return ptr;
+        }
+        return allocate_slow(size, alignment);
+    }
+
+    /**
+     * @brief Grows or shrinks a block in place if it is the last allocation and fits, otherwise allocates a new block
+     * and copies the content.
+     * @param ptr
+     * @param old_size
+     * @param new_size
+     * @param alignment
+     * @return
+     */
+    NODISCARD void* reallocate(void* ptr, size_t old_size, size_t new_size, size_t alignment = alignof(std::max_align_t));
+
+    /**
+     * @brief Releases a block if it is the last allocation, otherwise does nothing.
+     * @param ptr
+     * @param size
+     */
+    void deallocate(void* ptr, size_t size)
+    {
+        if (ptr && static_cast<char*>(ptr) + size == cursor_)
+        {
+            cursor_ = static_cast<char*>(ptr);
+        }
+    }
+
+    NODISCARD Marker get_marker() const;
+
+    /**
+     * @brief Releases every allocation made after the marker was taken.
+     * @param marker
+     */
+    void rewind(Marker marker);
+
+    /**
+     * @brief Releases every allocation.
+     */
+    void reset()
+    {
+        rewind(Marker());
+    }
+
+    /**
+     * @brief Gets the bytes in use, including alignment padding.
+     * @return
+     */
+    NODISCARD size_t get_used_size() const;
+
+    /**
+     * @brief Gets the bytes of every chunk held by the arena.
+     * @return
+     */
+    NODISCARD size_t get_reserved_size() const
+    {
+        return reserved_size_;
+    }
+
+private:
+    static char* align_up(char* ptr, size_t alignment)
+    {
+        return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~(alignment - 1));
+    }
+
+    void* allocate_slow(size_t size, size_t alignment);
+
+    void release_chunks_after(details::ArenaChunk* chunk);
+
+    size_t chunk_size_;
+    size_t reserved_size_{ 0 };
+    /** Chunk allocations are made from, it links to the chunks filled before. */
+    details::ArenaChunk* current_{ nullptr };
+    /** Chunks released by rewind. */
+    details::ArenaChunk* free_chunks_{ nullptr };
+    char* cursor_{ nullptr };
+    char* end_{ nullptr };
+};
+
+/**
+ * @brief Double buffered arenas for temporary allocations of a frame. The engine calls begin_frame at the start of every
+ * loop, which resets the arena of the frame before last, so a block lives for the frame it was allocated in and the
+ * next one.
+ * @note Only used from the game thread, tasks that may run across frames or threads should use a MemoryArena of their
+ * own.
+ */
+class CORE_API FrameAllocator
+{
+public:
+    static FrameAllocator& get();
+
+    void begin_frame()
+    {
+        current_ ^= 1;
+        arenas_[current_].reset();
+    }
+
+    NODISCARD void* allocate(size_t size, size_t alignment = alignof(std::max_align_t))
+    {
+        return arenas_[current_].allocate(size, alignment);
+    }
+
+    NODISCARD MemoryArena& get_arena()
+    {
+        return arenas_[current_];
+    }
+
+private:
+    MemoryArena arenas_[2];
+    uint32 current_{ 0 };
+};
+
+/**
+ * @brief Allocator adapter of MemoryArena for containers, deallocate only gives back the last allocation so building a
+ * temporary container costs pointer bumps and no frees. Defaults to the arena of the current frame.
+ * Usage:
+ * @code
+ * Array<Entity*, ArenaAllocator<Entity*>> visible;
+ * UnorderedMap<int32, float, Hash<int32>, EqualTo<int32>, ArenaAllocator<void>> weights;
+ * @endcode
+ * @note The container must not outlive the arena, or the frame after next for the frame arena.
+ */
+template<typename T, typename SizeType = size_t>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+    using size_type = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = ArenaAllocator<Other, size_type>;
+    };
+
+    ArenaAllocator() noexcept : arena_(&FrameAllocator::get().get_arena()) {}
+
+    explicit ArenaAllocator(MemoryArena& arena) noexcept : arena_(&arena) {}
+
+    constexpr ArenaAllocator(const ArenaAllocator&) noexcept = default;
+
+    template<typename Other>
+    constexpr ArenaAllocator(const ArenaAllocator<Other, SizeType>& right) noexcept : arena_(right.get_arena()) {}
+
+    constexpr ~ArenaAllocator() noexcept = default;
+
+    template<typename Other>
+    bool operator==(const ArenaAllocator<Other, SizeType>& right) const
+    {
+        return arena_ == right.get_arena();
+    }
+
+    NODISCARD value_type* allocate(const size_type size)
+    {
+        return static_cast<value_type*>(arena_->allocate(details::get_byte_size<sizeof(T)>(size), alignof(T)));
+    }
+
+    NODISCARD value_type* reallocate(value_type* ptr, const size_type old_size, const size_type size)
+    {
+        return static_cast<value_type*>(arena_->reallocate(ptr, details::get_byte_size<sizeof(T)>(old_size),
+                                                           details::get_byte_size<sizeof(T)>(size), alignof(T)));
+    }
+
+    void deallocate(value_type* const ptr, const size_type size)
+    {
+        arena_->deallocate(ptr, details::get_byte_size<sizeof(T)>(size));
+    }
+
+    NODISCARD MemoryArena* get_arena() const
+    {
+        return arena_;
+    }
+
+private:
+    MemoryArena* arena_;
+};
+
+}// namespace atlas
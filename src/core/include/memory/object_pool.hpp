@@ -0,0 +1,291 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <mutex>
+
+#include "concurrency/lock_free_list.hpp"
+#include "container/array.hpp"
+#include "memory/allocator.hpp"
+#include "memory/thread_slot_registry.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct FixedSizeFreeBlock
+{
+    FixedSizeFreeBlock* next;
+};
+
+/**
+ * @brief Free blocks a thread holds for an allocator, blocks is consumed first and spare is a whole bundle.
+ */
+struct FixedSizeThreadCache
+{
+    FixedSizeFreeBlock* blocks;
+    FixedSizeFreeBlock* spare;
+    /** Blocks in the list, an upper bound after a refill since bundles handed back by a cache may be partial. */
+    uint32 count;
+};
+
+}// namespace details
+
+/**
+ * @brief Serves blocks of a single size from pages, a freed block is linked into an intrusive free list and handed
+ * out by the next allocation. Pages are only released when the allocator is destroyed.
+ * @note Not thread safe, see ConcurrentFixedSizeAllocator.
+ */
+class CORE_API FixedSizeAllocator
+{
+    using block_type = details::FixedSizeFreeBlock;
+public:
+    static constexpr size_t default_page_size = 64 * 1024;
+
+    /**
+     * @brief Constructs an empty allocator, no page is allocated until the first allocation.
+     * @param block_size
+     * @param block_alignment Must be a power of two.
+     * @param page_size Pages hold at least one block.
+     */
+    FixedSizeAllocator(size_t block_size, size_t block_alignment, size_t page_size = default_page_size);
+
+    ~FixedSizeAllocator();
+
+    FixedSizeAllocator(const FixedSizeAllocator&) = delete;
+    FixedSizeAllocator& operator=(const FixedSizeAllocator&) = delete;
+
+    NODISCARD void* allocate()
+    {
+        if (block_type* block = free_list_)
+        {
+            free_list_ = block->next;
+            return block;
+        }
+        if (cursor_ != end_)
+        {
+            void* ptr = cursor_;
+            cursor_ += block_size_;
+            return ptr;
+        }
+        return allocate_page();
+    }
+
+    void deallocate(void* ptr)
+    {
+        ASSERT(ptr);
+        block_type* block = static_cast<block_type*>(ptr);
+        block->next = free_list_;
+        free_list_ = block;
+    }
+
+    NODISCARD size_t get_block_size() const
+    {
+        return block_size_;
+    }
+
+    NODISCARD size_t get_page_count() const
+    {
+        return pages_.size();
+    }
+
+private:
+    void* allocate_page();
+
+    size_t block_size_;
+    size_t block_alignment_;
+    size_t page_size_;
+    block_type* free_list_{ nullptr };
+    char* cursor_{ nullptr };
+    char* end_{ nullptr };
+    Array<void*> pages_;
+};
+
+/**
+ * @brief Thread safe FixedSizeAllocator. Every thread caches up to two bundles of free blocks per allocator, and full
+ * bundles are exchanged through a lock free list, so a block costs a thread local pointer swap most of the time. Only
+ * carving blocks out of a new page takes a lock. Threads using more allocators than they have cache slots evict the
+ * oldest slot, and a thread returns its cached blocks when it exits.
+ */
+class CORE_API ConcurrentFixedSizeAllocator
+{
+    using link_ptr_type = LockFreeLinkPolicy::link_ptr_type;
+    using block_type = details::FixedSizeFreeBlock;
+public:
+    static constexpr size_t default_page_size = FixedSizeAllocator::default_page_size;
+    /** Blocks a thread frees before handing them back as a bundle. */
+    static constexpr uint32 bundle_size = 32;
+
+    ConcurrentFixedSizeAllocator(size_t block_size, size_t block_alignment, size_t page_size = default_page_size);
+
+    /**
+     * @brief Releases every page, all threads that allocated from this allocator must have stopped using it.
+     */
+    ~ConcurrentFixedSizeAllocator();
+
+    ConcurrentFixedSizeAllocator(const ConcurrentFixedSizeAllocator&) = delete;
+    ConcurrentFixedSizeAllocator& operator=(const ConcurrentFixedSizeAllocator&) = delete;
+
+    NODISCARD void* allocate();
+
+    void deallocate(void* ptr);
+
+    NODISCARD size_t get_block_size() const
+    {
+        return pages_.get_block_size();
+    }
+
+private:
+    using cache_type = details::FixedSizeThreadCache;
+    using thread_caches_type = details::ThreadSlotRegistry<ConcurrentFixedSizeAllocator, cache_type, 8>;
+
+    friend thread_caches_type;
+
+    NODISCARD cache_type* get_cache();
+
+    /**
+     * @brief Pops a bundle, or carves a new one out of the pages.
+     * @return A null terminated list of blocks.
+     */
+    block_type* acquire_bundle();
+
+    void push_bundle(block_type* bundle);
+
+    /**
+     * @brief Pushes the blocks of an evicted or exiting cache as bundles.
+     * @param cache
+     */
+    void release_thread_slot(cache_type& cache);
+
+    LockFreePointerListLIFORoot<PLATFORM_CACHE_LINE_SIZE> bundles_;
+    std::mutex mutex_;
+    /** Only allocated from under the mutex, blocks are never given back to it. */
+    FixedSizeAllocator pages_;
+    thread_caches_type thread_caches_;
+};
+
+/**
+ * @brief A pool of objects of a single type for objects created and destroyed at a high rate.
+ * Usage:
+ * @code
+ * ObjectPool<TickTask> pool;
+ * TickTask* task = pool.create(args...);
+ * pool.destroy(task);
+ * @endcode
+ * @tparam T
+ * @tparam ThreadSafe Uses ConcurrentFixedSizeAllocator, so objects may be created and destroyed on any thread.
+ */
+template<typename T, bool ThreadSafe = false>
+class ObjectPool
+{
+    using allocator_type = std::conditional_t<ThreadSafe, ConcurrentFixedSizeAllocator, FixedSizeAllocator>;
+public:
+    static constexpr size_t block_size = sizeof(T) < sizeof(void*) ? sizeof(void*) : sizeof(T);
+    static constexpr size_t block_alignment = alignof(T) < alignof(void*) ? alignof(void*) : alignof(T);
+
+    explicit ObjectPool(size_t page_size = allocator_type::default_page_size)
+        : allocator_(block_size, block_alignment, page_size) {}
+
+    template<typename... Args>
+    NODISCARD T* create(Args&&... args)
+    {
+        return new(allocator_.allocate()) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* object)
+    {
+        if (object)
+        {
+            object->~T();
+            allocator_.deallocate(object);
+        }
+    }
+
+    /**
+     * @brief Allocates uninitialized storage of a T.
+     * @return
+     */
+    NODISCARD T* allocate()
+    {
+        return static_cast<T*>(allocator_.allocate());
+    }
+
+    void deallocate(T* ptr)
+    {
+        allocator_.deallocate(ptr);
+    }
+
+    /**
+     * @brief Gets a pool of the type shared by the whole process, never destroyed so blocks may outlive static
+     * destructors.
+     * @return
+     */
+    static ObjectPool& get_shared()
+    {
+        static_assert(ThreadSafe, "shared pools must be thread safe");
+        static ObjectPool* instance = new ObjectPool();
+        return *instance;
+    }
+
+private:
+    allocator_type allocator_;
+};
+
+/**
+ * @brief Node allocator for containers, allocations of a single element come from the shared ObjectPool of the type
+ * and larger ones from the heap. It suits containers that allocate an element at a time, like linked lists and trees,
+ * while Array and UnorderedMap allocate contiguous buffers so they gain nothing from it.
+ */
+template<typename T, typename SizeType = size_t>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+    using size_type = SizeType;
+    using difference_type = std::make_signed_t<size_type>;
+
+    template<typename Other>
+    struct rebind
+    {
+        using other = PoolAllocator<Other, size_type>;
+    };
+
+    constexpr PoolAllocator() noexcept = default;
+
+    constexpr PoolAllocator(const PoolAllocator&) noexcept = default;
+
+    template<typename Other>
+    constexpr PoolAllocator(const PoolAllocator<Other, SizeType>&) noexcept {}
+
+    constexpr ~PoolAllocator() noexcept = default;
+
+    template<typename Other>
+    bool operator==(const PoolAllocator<Other, SizeType>&) const
+    {
+        return true;
+    }
+
+    NODISCARD value_type* allocate(const size_type size)
+    {
+        if (size == 1)
+        {
+            return ObjectPool<T, true>::get_shared().allocate();
+        }
+        return HeapAllocator<T, SizeType>().allocate(size);
+    }
+
+    void deallocate(value_type* const ptr, const size_type size)
+    {
+        if (size == 1)
+        {
+            ObjectPool<T, true>::get_shared().deallocate(ptr);
+            return;
+        }
+        HeapAllocator<T, SizeType>().deallocate(ptr, size);
+    }
+};
+
+}// namespace atlas
@@ -3,13 +3,17 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 #include "memory/malloc_base.hpp"
 #include "assertion.hpp"
 
 #if PLATFORM_APPLE
 #include <malloc/malloc.h>
+#elif PLATFORM_LINUX || PLATFORM_WINDOWS
+#include <malloc.h>
 #endif
 
 namespace atlas
@@ -79,6 +83,29 @@ public:
         // free the old block
         aligned_free(ptr);
 
+        return new_ptr;
+#else
+        if (ptr == nullptr)
+        {
+            return aligned_malloc(new_size, alignment);
+        }
+
+        if (new_size == 0)
+        {
+            aligned_free(ptr);
+            return nullptr;
+        }
+
+        // glibc has no aligned realloc, moves the block to a new one with the desired alignment.
+        void* new_ptr = aligned_malloc(new_size, alignment);
+        if (new_ptr == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::memcpy(new_ptr, ptr, std::min(new_size, ::malloc_usable_size(ptr)));
+        aligned_free(ptr);
+
         return new_ptr;
 #endif
     }
@@ -94,6 +121,31 @@ public:
         ::_aligned_free(ptr);
 #else
         return std::free(ptr);
+#endif
+    }
+
+    size_t usable_size(void* ptr) override
+    {
+        if (!ptr)
+        {
+            return 0;
+        }
+#if PLATFORM_WINDOWS
+        return ::_msize(ptr);
+#elif PLATFORM_APPLE
+        return ::malloc_size(ptr);
+#else
+        return ::malloc_usable_size(ptr);
+#endif
+    }
+
+    bool try_expand_in_place(void* ptr, size_t new_size) override
+    {
+#if PLATFORM_WINDOWS
+        // _expand resizes the block without moving it, or fails.
+        return ptr && ::_expand(ptr, new_size) != nullptr;
+#else
+        return MallocBase::try_expand_in_place(ptr, new_size);
 #endif
     }
 };
@@ -0,0 +1,133 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "memory/malloc_base.hpp"
+#include "memory/thread_slot_registry.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct ThreadCachingPage;
+struct ThreadCachingSegment;
+struct ThreadCachingHeap;
+
+}// namespace details
+
+/**
+ * @brief A thread caching allocator for small blocks, in the spirit of mimalloc.
+ * Memory is reserved in segments of 4MB, split into pages of 64KB that each serve blocks of a single size class.
+ * Every thread owns a heap and allocates from the pages of its heap without synchronization. A block freed by another
+ * thread is pushed onto a lock free list of its page and collected by the owner once the page runs out of blocks.
+ * Pages of an exited thread are abandoned and adopted by the next thread that needs a page of the same size class.
+ * Blocks larger than max_small_size, and any block this allocator does not own, go through the fallback allocator. So
+ * it may replace the allocator of Memory at runtime, blocks allocated before are still freed by their allocator.
+ * @note Blocks with a power of two size are aligned to their size up to the page size, which serves aligned_malloc.
+ */
+class CORE_API ThreadCachingMalloc : public MallocBase
+{
+public:
+    static constexpr size_t max_small_size = 16 * 1024;
+    static constexpr size_t page_size = 64 * 1024;
+    static constexpr size_t segment_size = 4 * 1024 * 1024;
+    static constexpr uint32 size_class_count = 36;
+
+    /**
+     * @brief Constructs the allocator.
+     * @param fallback Serves large blocks and segments, must outlive this allocator.
+     */
+    explicit ThreadCachingMalloc(MallocBase* fallback);
+
+    /**
+     * @brief Releases every segment, all threads that allocated from this allocator must have stopped using it.
+     */
+    ~ThreadCachingMalloc() override;
+
+    ThreadCachingMalloc(const ThreadCachingMalloc&) = delete;
+    ThreadCachingMalloc& operator=(const ThreadCachingMalloc&) = delete;
+
+    void* malloc(size_t size) override;
+
+    void* aligned_malloc(size_t size, size_t alignment) override;
+
+    void* realloc(void* ptr, size_t new_size) override;
+
+    void* aligned_realloc(void* ptr, size_t new_size, size_t alignment) override;
+
+    void free(void* ptr) override;
+
+    void aligned_free(void* ptr) override;
+
+    size_t usable_size(void* ptr) override;
+
+    bool try_expand_in_place(void* ptr, size_t new_size) override;
+
+    /**
+     * @brief Returns true if the block was allocated from the segments of this allocator, not by the fallback.
+     * @param ptr
+     * @return
+     */
+    NODISCARD bool owns(const void* ptr) const;
+
+private:
+    using page_type = details::ThreadCachingPage;
+    using segment_type = details::ThreadCachingSegment;
+    using heap_type = details::ThreadCachingHeap;
+    using thread_heaps_type = details::ThreadSlotRegistry<ThreadCachingMalloc, heap_type*, 4>;
+
+    friend thread_heaps_type;
+
+    static constexpr uint32 max_segment_count = 2048;
+    static constexpr uint32 segment_table_size = max_segment_count * 2;
+
+    NODISCARD heap_type* find_heap() const;
+
+    NODISCARD heap_type* get_heap();
+
+    void* malloc_small(heap_type* heap, uint32 size_class);
+
+    void* malloc_slow(heap_type* heap, uint32 size_class);
+
+    page_type* acquire_page(heap_type* heap, uint32 size_class);
+
+    void release_page(heap_type* heap, page_type* page);
+
+    void free_small(segment_type* segment, void* ptr);
+
+    NODISCARD segment_type* find_segment(const void* ptr) const;
+
+    page_type* allocate_segment();
+
+    void abandon_heap(heap_type* heap);
+
+    /**
+     * @brief Abandons the heap of an exiting thread.
+     * @param heap
+     */
+    void release_thread_slot(heap_type*& heap)
+    {
+        abandon_heap(heap);
+    }
+
+    MallocBase* fallback_;
+    std::mutex mutex_;
+    /** Open addressing set of segment addresses, segments are only added until the allocator is destroyed. */
+    std::atomic<uintptr_t> segment_table_[segment_table_size]{};
+    uint32 segment_count_{ 0 };
+    /** Pages not assigned to any size class. */
+    page_type* free_pages_{ nullptr };
+    /** Pages of exited threads that still have blocks in use. */
+    page_type* abandoned_pages_[size_class_count]{};
+    heap_type* heaps_{ nullptr };
+    /** Heap of each thread allocating from this allocator. */
+    thread_heaps_type thread_heaps_;
+};
+
+}// namespace atlas
@@ -0,0 +1,206 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+#include "core_def.hpp"
+
+namespace atlas::details
+{
+
+/**
+ * @brief Gives every thread a slot per instance of Owner, e.g. the heap a thread allocates from for each allocator.
+ * The slots of a thread are zero initialized and trivially destructible, so they can be used until the very end of
+ * the thread. When the thread exits, each slot is handed to Owner::release_thread_slot if its owner is still alive,
+ * which is called with the registry locked.
+ * Owner holds a registry as a member and calls unregister() before it tears down what its slots refer to.
+ * @tparam Owner
+ * @tparam Slot Zeroed when unused.
+ * @tparam SlotCount Instances a thread can hold a slot for at the same time.
+ */
+template<typename Owner, typename Slot, uint32 SlotCount>
+class ThreadSlotRegistry
+{
+    static_assert(std::is_trivially_destructible_v<Slot> && std::is_trivially_default_constructible_v<Slot>);
+public:
+    explicit ThreadSlotRegistry(Owner* owner)
+        : owner_(owner)
+        , id_(next_id_.fetch_add(1, std::memory_order_relaxed))
+    {
+        std::lock_guard lock(mutex_);
+        next_ = instances_;
+        instances_ = this;
+    }
+
+    ~ThreadSlotRegistry()
+    {
+        unregister();
+    }
+
+    ThreadSlotRegistry(const ThreadSlotRegistry&) = delete;
+    ThreadSlotRegistry& operator=(const ThreadSlotRegistry&) = delete;
+
+    /**
+     * @brief Stops exiting threads from releasing their slots to the owner and drops the slot of the calling thread.
+     * Slots of other threads are dropped once they find the owner gone.
+     */
+    void unregister()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            if (!registered_)
+            {
+                return;
+            }
+            registered_ = false;
+            ThreadSlotRegistry** link = &instances_;
+            while (*link != this)
+            {
+                link = &(*link)->next_;
+            }
+            *link = next_;
+        }
+
+        for (Entry& entry : thread_slots_.entries)
+        {
+            if (entry.owner_id == id_)
+            {
+                entry = Entry();
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the slot of the calling thread.
+     * @return Nullptr if the thread has no slot for this owner.
+     */
+    NODISCARD Slot* find() const
+    {
+        for (Entry& entry : thread_slots_.entries)
+        {
+            if (entry.owner_id == id_)
+            {
+                return &entry.slot;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Returns true once the calling thread has released its slots on exit, it gets no slot afterwards.
+     * @return
+     */
+    NODISCARD static bool is_thread_exited()
+    {
+        return thread_slots_.exited;
+    }
+
+    /**
+     * @brief Takes a zeroed slot for the calling thread, which must not have one yet.
+     * @param evict Releases the oldest slot when every slot is taken, instead of failing.
+     * @return Nullptr if the thread is exiting, or if every slot is taken and evict is false.
+     */
+    NODISCARD Slot* claim(bool evict)
+    {
+        ThreadSlots& slots = thread_slots_;
+        if (slots.exited)
+        {
+            return nullptr;
+        }
+        // registers the destructor of the guard for this thread.
+        thread_exit_guard_.armed = true;
+
+        Entry* free_entry = nullptr;
+        for (Entry& entry : slots.entries)
+        {
+            if (entry.owner_id == 0)
+            {
+                free_entry = &entry;
+                break;
+            }
+        }
+        if (!free_entry)
+        {
+            if (!evict)
+            {
+                return nullptr;
+            }
+            free_entry = &slots.entries[slots.next_victim];
+            slots.next_victim = (slots.next_victim + 1) % SlotCount;
+            std::lock_guard lock(mutex_);
+            release(*free_entry);
+        }
+        free_entry->owner_id = id_;
+        return &free_entry->slot;
+    }
+
+private:
+    struct Entry
+    {
+        uint64 owner_id;
+        Slot slot;
+    };
+
+    struct ThreadSlots
+    {
+        Entry entries[SlotCount];
+        uint32 next_victim;
+        bool exited;
+    };
+
+    /**
+     * @brief Releases the slots of a thread when it exits.
+     */
+    struct ThreadExitGuard
+    {
+        ~ThreadExitGuard()
+        {
+            std::lock_guard lock(mutex_);
+            thread_slots_.exited = true;
+            for (Entry& entry : thread_slots_.entries)
+            {
+                release(entry);
+            }
+        }
+
+        bool armed{ false };
+    };
+
+    /**
+     * @brief Hands a slot to its owner if the owner is alive and clears it, mutex_ must be locked.
+     * @param entry
+     */
+    static void release(Entry& entry)
+    {
+        if (entry.owner_id != 0)
+        {
+            for (ThreadSlotRegistry* instance = instances_; instance; instance = instance->next_)
+            {
+                if (instance->id_ == entry.owner_id)
+                {
+                    instance->owner_->release_thread_slot(entry.slot);
+                    break;
+                }
+            }
+        }
+        entry = Entry();
+    }
+
+    static inline thread_local ThreadSlots thread_slots_{};
+    static inline thread_local ThreadExitGuard thread_exit_guard_;
+    /** Live owners, so an exiting thread only releases slots of owners not destroyed yet. */
+    static inline std::mutex mutex_;
+    static inline ThreadSlotRegistry* instances_{ nullptr };
+    static inline std::atomic<uint64> next_id_{ 1 };
+
+    Owner* owner_;
+    const uint64 id_;
+    ThreadSlotRegistry* next_{ nullptr };
+    bool registered_{ true };
+};
+
+}// namespace atlas::details
@@ -0,0 +1,204 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "container/array.hpp"
+#include "memory/malloc_base.hpp"
+#include "memory/thread_slot_registry.hpp"
+#include "string/string.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct TrackingShard;
+
+}// namespace details
+
+/**
+ * @brief Tags allocations of the calling thread until the scope ends, scopes nest.
+ * Usage:
+ * @code
+ * {
+ *     MemoryScope scope("io");
+ *     buffer.resize(size); // counted as io
+ * }
+ * @endcode
+ */
+class CORE_API MemoryScope
+{
+public:
+    static constexpr uint32 max_tag_count = 32;
+    /** Tag of allocations outside of any scope, and of scopes beyond max_tag_count. */
+    static constexpr uint32 untagged = 0;
+
+    /**
+     * @brief Enters a scope.
+     * @param name Must outlive the program, like a string literal. Scopes of the same name share a tag.
+     */
+    explicit MemoryScope(const char* name);
+
+    ~MemoryScope();
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+
+    /**
+     * @brief Gets the tag of the innermost scope of the calling thread.
+     * @return
+     */
+    static uint32 get_current_tag();
+
+    /**
+     * @brief Gets the tag of a name, registers it the first time.
+     * @param name
+     * @return untagged if all tags are in use.
+     */
+    static uint32 get_tag(const char* name);
+
+    static const char* get_tag_name(uint32 tag);
+
+    static uint32 get_tag_count();
+
+private:
+    uint32 previous_tag_;
+};
+
+struct MemoryTagStats
+{
+    /** Size buckets are powers of two from 16 bytes, the last one counts everything beyond. */
+    static constexpr uint32 histogram_bucket_count = 16;
+
+    const char* name{ nullptr };
+    int64 live_bytes{ 0 };
+    /** Accurate to the flush granularity of TrackingMalloc per thread. */
+    int64 peak_bytes{ 0 };
+    uint64 allocation_count{ 0 };
+    uint64 free_count{ 0 };
+    uint64 size_histogram[histogram_bucket_count]{};
+
+    NODISCARD static uint64 get_bucket_size(uint32 bucket)
+    {
+        return uint64(16) << bucket;
+    }
+};
+
+struct CORE_API MemoryStats
+{
+    MemoryTagStats total;
+    /** Stats of every tag that has been allocated with, indexed by tag. */
+    Array<MemoryTagStats> tags;
+
+    /**
+     * @brief Formats the stats as a json object with the total and an array of tags.
+     * @return
+     */
+    NODISCARD String to_json() const;
+};
+
+/**
+ * @brief Records live bytes, peak bytes, allocation counts and a size histogram of every allocation through the
+ * wrapped allocator, per MemoryScope tag.
+ * Counters are sharded per thread, each thread only writes its own shard and the stats sum them up. Every block gets
+ * a small header holding its size and tag, so the tracker must see every block it frees: wrap the allocator before it
+ * is used, or build with WITH_MEMORY_TRACKING to track Memory from the first allocation.
+ */
+class CORE_API TrackingMalloc : public MallocBase
+{
+public:
+    /** Bytes a thread allocates or frees before the change is applied to the peaks. */
+    static constexpr int64 flush_threshold = 64 * 1024;
+
+    /**
+     * @brief Constructs a tracker.
+     * @param inner Must outlive the tracker.
+     */
+    explicit TrackingMalloc(MallocBase* inner);
+
+    ~TrackingMalloc() override;
+
+    TrackingMalloc(const TrackingMalloc&) = delete;
+    TrackingMalloc& operator=(const TrackingMalloc&) = delete;
+
+    void* malloc(size_t size) override;
+
+    void* aligned_malloc(size_t size, size_t alignment) override;
+
+    void* realloc(void* ptr, size_t new_size) override;
+
+    void* aligned_realloc(void* ptr, size_t new_size, size_t alignment) override;
+
+    void free(void* ptr) override;
+
+    void aligned_free(void* ptr) override;
+
+    size_t usable_size(void* ptr) override;
+
+    bool try_expand_in_place(void* ptr, size_t new_size) override;
+
+    NODISCARD MallocBase* get_inner() const
+    {
+        return inner_;
+    }
+
+    /**
+     * @brief Replaces the wrapped allocator, it must free blocks of the previous one, see ThreadCachingMalloc.
+     * @param inner
+     */
+    void set_inner(MallocBase* inner)
+    {
+        inner_ = inner;
+    }
+
+    /**
+     * @brief Takes a snapshot of the counters, allocations of other threads in the meantime may be partially counted.
+     * @return
+     */
+    NODISCARD MemoryStats get_stats() const;
+
+    /**
+     * @brief Gets the tracker of Memory.
+     * @return Nullptr unless built with WITH_MEMORY_TRACKING.
+     */
+    static TrackingMalloc* get();
+
+private:
+    using shard_type = details::TrackingShard;
+    using thread_shards_type = details::ThreadSlotRegistry<TrackingMalloc, shard_type*, 4>;
+
+    friend thread_shards_type;
+
+    NODISCARD shard_type* get_shard();
+
+    /**
+     * @brief Flushes the shard of an exiting thread and hands it to the next thread.
+     * @param shard
+     */
+    void release_thread_slot(shard_type*& shard);
+
+    void on_allocated(size_t size, uint32 tag);
+
+    void on_freed(size_t size, uint32 tag);
+
+    void flush(shard_type* shard, uint32 tag);
+
+    MallocBase* inner_;
+    mutable std::mutex mutex_;
+    shard_type* shards_{ nullptr };
+    /** Counts allocations of threads without a shard with atomic additions. */
+    shard_type* shared_shard_{ nullptr };
+    std::atomic<int64> flushed_bytes_[MemoryScope::max_tag_count]{};
+    std::atomic<int64> peak_bytes_[MemoryScope::max_tag_count]{};
+    std::atomic<int64> flushed_total_bytes_{ 0 };
+    std::atomic<int64> peak_total_bytes_{ 0 };
+    /** Shard of each thread counting through this tracker. */
+    thread_shards_type thread_shards_;
+};
+
+}// namespace atlas
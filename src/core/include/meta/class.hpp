@@ -4,6 +4,7 @@
 #pragma once
 
 #include "constructor.hpp"
+#include "container/concurrent_unordered_map.hpp"
 #include "container/unordered_set.hpp"
 #include "meta/method.hpp"
 #include "meta/property.hpp"
@@ -415,10 +416,12 @@ private:
     UnorderedSet<MetaClass*>* children_{ nullptr };
     Constructor* constructor_{ nullptr };
     Array<Property*> properties_{};
+    /** Names of properties_ at the same indices, searched instead of dereferencing every property. */
+    Array<StringName> property_names_{};
     UnorderedMap<StringName, Method*> methods_{};
-    /** Stores methods in a base class or interfaces for quick searching. */
-    mutable UnorderedMap<StringName, Method*> methods_cache_{};
-    mutable std::shared_mutex method_mutex_{};
+    /** Stores methods in a base class or interfaces for quick searching. Few threads look methods up at once, so a
+     * few shards keep every class small. */
+    mutable ConcurrentUnorderedMap<StringName, Method*, Hash<StringName>, EqualTo<StringName>, HeapAllocator<void>, 4> methods_cache_{};
 };
 
 /**
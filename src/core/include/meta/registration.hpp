@@ -40,6 +40,7 @@ class CORE_API Registration
         {
             ASSERT(prop);
             class_->properties_.add(prop);
+            class_->property_names_.add(prop->name());
             return *this;
         }
 
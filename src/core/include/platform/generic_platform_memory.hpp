@@ -0,0 +1,59 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include "core_def.hpp"
+
+namespace atlas
+{
+
+enum class EHugePages : uint8
+{
+    /** Regular pages. */
+    None,
+    /** Aligns the range to huge pages and asks the kernel to back it with transparent huge pages when it can. */
+    Transparent,
+    /** Takes pages from the preallocated huge page pool of the system, falls back to Transparent if it is empty. */
+    Explicit,
+};
+
+/**
+ * @brief Virtual memory of the platform for large buffers. A range is reserved first, which only takes address space,
+ * and committed before it is touched. Platforms without huge pages or NUMA ignore those requests.
+ * Usage:
+ * @code
+ * const size_t size = PlatformMemory::get_reserve_size(bytes, EHugePages::Transparent);
+ * void* ptr = PlatformMemory::reserve(size, EHugePages::Transparent, numa_node);
+ * PlatformMemory::commit(ptr, size, true);
+ * // ...
+ * PlatformMemory::release(ptr, size);
+ * @endcode
+ */
+class CORE_API GenericPlatformMemory
+{
+public:
+    static constexpr size_t huge_page_size = 2 * 1024 * 1024;
+    static constexpr uint32 any_numa_node = ~0u;
+
+    GenericPlatformMemory() = delete;
+
+    /**
+     * @brief Rounds a size up to the granularity of reserve.
+     * @param size
+     * @param huge_pages
+     * @return
+     */
+    NODISCARD static size_t get_reserve_size(size_t size, EHugePages huge_pages)
+    {
+        const size_t granularity = huge_pages == EHugePages::None ? 64 * 1024 : huge_page_size;
+        return (size + granularity - 1) & ~(granularity - 1);
+    }
+
+    NODISCARD static uint32 get_current_numa_node()
+    {
+        return 0;
+    }
+};
+
+}// namespace atlas
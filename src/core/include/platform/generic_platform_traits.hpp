@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <span>
+
+#include "container/array.hpp"
 #include "core_log.hpp"
 #include "file_system/path.hpp"
 #include "string/string_name.hpp"
@@ -23,6 +26,58 @@ enum class ESystemMsgBoxReturnType
     No,
 };
 
+enum class EThreadPriority : uint8
+{
+    Lowest,
+    BelowNormal,
+    Normal,
+    AboveNormal,
+    Highest,
+};
+
+/**
+ * @brief Describes a logical processor. Ids are only meaningful for comparing processors with each other.
+ */
+struct ProcessorInfo
+{
+    /** Index used by thread affinity. */
+    uint32 index{ 0 };
+    /** Logical processors sharing a physical core (SMT siblings) have the same core id. */
+    uint32 core_id{ 0 };
+    uint32 package_id{ 0 };
+    uint32 numa_node{ 0 };
+    /** Logical processors sharing a last level cache have the same l3 id. */
+    uint32 l3_cache_id{ 0 };
+};
+
+struct CpuTopology
+{
+    Array<ProcessorInfo> processors;
+    uint32 physical_core_count{ 0 };
+    uint32 numa_node_count{ 0 };
+    uint32 l3_cache_count{ 0 };
+
+    /**
+     * @brief Gets the first logical processor of every physical core, ordered by core.
+     * @return
+     */
+    NODISCARD Array<uint32> get_physical_core_processors() const
+    {
+        Array<uint32> result;
+        Array<uint64> seen_cores;
+        for (auto&& processor : processors)
+        {
+            const uint64 key = (static_cast<uint64>(processor.package_id) << 32) | processor.core_id;
+            if (std::find(seen_cores.begin(), seen_cores.end(), key) == seen_cores.end())
+            {
+                seen_cores.add(key);
+                result.add(processor.index);
+            }
+        }
+        return result;
+    }
+};
+
 /**
  * @class GenericPlatformTraits
  * @brief Provides platform-specific traits and utility functions.
@@ -84,6 +139,29 @@ public:
      */
     static void* get_this_thread_handle() VIRTUAL_IMPL(core, return nullptr;)
 
+    /**
+     * @brief Restricts a thread to run only on the given logical processors.
+     * @param thread_handle The handle to the thread.
+     * @param processors Indices of logical processors, see ProcessorInfo::index.
+     * @return True if the affinity has been applied.
+     */
+    static bool set_thread_affinity(void* thread_handle, std::span<const uint32> processors) VIRTUAL_IMPL(core, return false;)
+
+    /**
+     * @brief Sets the scheduling priority of a thread.
+     * @param thread_handle The handle to the thread.
+     * @param priority
+     * @return True if the priority has been applied, raising priority may need extra privileges.
+     */
+    static bool set_thread_priority(void* thread_handle, EThreadPriority priority) VIRTUAL_IMPL(core, return false;)
+
+    /**
+     * @brief Queries the processor topology once and caches it.
+     * The generic version reports every hardware thread as its own core on a single node and cache.
+     * @return
+     */
+    static const CpuTopology& get_cpu_topology();
+
     /**
      * @brief Displays a message box with the specified type, caption, and message.
      * @param type The type of the message box.
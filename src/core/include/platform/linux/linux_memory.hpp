@@ -0,0 +1,75 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <memory>
+
+#include "memory/standard_malloc.hpp"
+#include "platform/generic_platform_memory.hpp"
+
+namespace atlas
+{
+class CORE_API LinuxMemory : public GenericPlatformMemory
+{
+public:
+    static std::unique_ptr<MallocBase> GetDefaultMalloc()
+    {
+        return std::make_unique<StandardMalloc>();
+    }
+
+    LinuxMemory() = delete;
+
+    /**
+     * @brief Gets the size of a regular page.
+     * @return
+     */
+    NODISCARD static size_t get_page_size();
+
+    /**
+     * @brief Reserves a range of address space, it must be committed before it is accessed.
+     * @param size A result of get_reserve_size with the same huge pages.
+     * @param huge_pages
+     * @param numa_node The node physical pages are preferably taken from, or any_numa_node.
+     * @return Aligned to the granularity of get_reserve_size, or nullptr on failure.
+     */
+    NODISCARD static void* reserve(size_t size, EHugePages huge_pages = EHugePages::None, uint32 numa_node = any_numa_node);
+
+    /**
+     * @brief Makes a range of reserved pages readable and writable, they read as zero the first time.
+     * @param ptr
+     * @param size
+     * @param prefault Faults the pages in now, instead of at first touch.
+     * @return
+     */
+    static bool commit(void* ptr, size_t size, bool prefault = false);
+
+    /**
+     * @brief Gives the physical pages of a committed range back to the system, the range stays reserved.
+     * @param ptr
+     * @param size
+     */
+    static void decommit(void* ptr, size_t size);
+
+    /**
+     * @brief Releases a whole range returned by reserve.
+     * @param ptr
+     * @param size The size passed to reserve.
+     */
+    static void release(void* ptr, size_t size);
+
+    /**
+     * @brief Sets the preferred NUMA node of a range, it applies to pages faulted in afterwards.
+     * @param ptr
+     * @param size
+     * @param numa_node
+     * @return
+     */
+    static bool bind_numa_node(void* ptr, size_t size, uint32 numa_node);
+
+    NODISCARD static uint32 get_current_numa_node();
+};
+
+typedef LinuxMemory PlatformMemory;
+
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <pthread.h>
+
+#include "platform/generic_platform_traits.hpp"
+
+namespace atlas
+{
+
+class CORE_API LinuxPlatformTraits : public GenericPlatformTraits
+{
+public:
+    LinuxPlatformTraits() = delete;
+
+    static void* load_library(const Path& path);
+
+    static void free_library(void* module_handle);
+
+    static void* get_exported_symbol(void* handle, const String& symbol_name);
+
+    static Path get_library_path(const Path& module_dir, StringName lib_name);
+
+    /**
+     * @brief Sets the name of the specified thread, truncated to 15 characters.
+     * @param thread_handle The handle to the thread.
+     * @param name The name to set for the thread.
+     */
+    static void set_thread_name(void* thread_handle, const String& name);
+
+    static void set_thread_name(pthread_t thread, const String& name)
+    {
+        set_thread_name(reinterpret_cast<void*>(thread), name);
+    }
+
+    static void* get_this_thread_handle();
+
+    static bool set_thread_affinity(void* thread_handle, std::span<const uint32> processors);
+
+    static bool set_thread_affinity(pthread_t thread, std::span<const uint32> processors)
+    {
+        return set_thread_affinity(reinterpret_cast<void*>(thread), processors);
+    }
+
+    /**
+     * @brief Maps the priority to a nice value, Lowest to Highest are 19, 10, 0, -5 and -10. The thread keeps its
+     * scheduling policy. Only the calling thread can be changed, other handles fail, and a negative nice value fails
+     * without CAP_SYS_NICE or a raised RLIMIT_NICE.
+     * @param thread_handle
+     * @param priority
+     * @return
+     */
+    static bool set_thread_priority(void* thread_handle, EThreadPriority priority);
+
+    static bool set_thread_priority(pthread_t thread, EThreadPriority priority)
+    {
+        return set_thread_priority(reinterpret_cast<void*>(thread), priority);
+    }
+
+    /**
+     * @brief Reads the topology of online processors from sysfs.
+     * @return
+     */
+    static const CpuTopology& get_cpu_topology();
+
+    static inline const char* alias_name_ = "linux";
+};
+
+using PlatformTraits = LinuxPlatformTraits;
+
+} // namespace atlas
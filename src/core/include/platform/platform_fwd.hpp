@@ -9,4 +9,6 @@
 #include "platform/windows/windows_platform_traits.hpp"
 #elif PLATFORM_APPLE
 #include "platform/mac/mac_platform_traits.hpp"
+#elif PLATFORM_LINUX
+#include "platform/linux/linux_platform_traits.hpp"
 #endif
@@ -7,10 +7,11 @@
 
 #include "memory/malloc_base.hpp"
 #include "memory/standard_malloc.hpp"
+#include "platform/generic_platform_memory.hpp"
 
 namespace atlas
 {
-    class CORE_API WindowsMemory
+    class CORE_API WindowsMemory : public GenericPlatformMemory
     {
     public:
         static std::unique_ptr<MallocBase> GetDefaultMalloc()
@@ -19,6 +20,46 @@ namespace atlas
         }
 
         WindowsMemory() = delete;
+
+        /**
+         * @brief Gets the size of a regular page.
+         * @return
+         */
+        NODISCARD static size_t get_page_size();
+
+        /**
+         * @brief Reserves a range of address space, it must be committed before it is accessed.
+         * @param size A result of get_reserve_size with the same huge pages.
+         * @param huge_pages
+         * @param numa_node The node physical pages are preferably taken from, or any_numa_node.
+         * @return Aligned to the granularity of get_reserve_size, or nullptr on failure.
+         */
+        NODISCARD static void* reserve(size_t size, EHugePages huge_pages = EHugePages::None, uint32 numa_node = any_numa_node);
+
+        /**
+         * @brief Makes a range of reserved pages readable and writable, they read as zero the first time.
+         * @param ptr
+         * @param size
+         * @param prefault Faults the pages in now, instead of at first touch.
+         * @return
+         */
+        static bool commit(void* ptr, size_t size, bool prefault = false);
+
+        /**
+         * @brief Gives the physical pages of a committed range back to the system, the range stays reserved.
+         * @param ptr
+         * @param size
+         */
+        static void decommit(void* ptr, size_t size);
+
+        /**
+         * @brief Releases a whole range returned by reserve.
+         * @param ptr
+         * @param size The size passed to reserve.
+         */
+        static void release(void* ptr, size_t size);
+
+        NODISCARD static uint32 get_current_numa_node();
     };
 
     typedef WindowsMemory PlatformMemory;
@@ -47,6 +47,29 @@ public:
      */
     static void* get_this_thread_handle();
 
+    /**
+     * @brief Restricts a thread to the given logical processors, processor index is group * 64 + number in group.
+     * A thread belongs to a single processor group, processors outside the group of the first one are ignored.
+     * @param thread_handle The handle to the thread.
+     * @param processors Indices of logical processors.
+     * @return True if the affinity has been applied.
+     */
+    static bool set_thread_affinity(void* thread_handle, std::span<const uint32> processors);
+
+    /**
+     * @brief Sets the scheduling priority of a thread.
+     * @param thread_handle The handle to the thread.
+     * @param priority
+     * @return True if the priority has been applied.
+     */
+    static bool set_thread_priority(void* thread_handle, EThreadPriority priority);
+
+    /**
+     * @brief Queries the processor topology with GetLogicalProcessorInformationEx.
+     * @return
+     */
+    static const CpuTopology& get_cpu_topology();
+
     /**
      * @brief Displays a message box with the specified type, caption, and message.
      * @param type The type of the message box.
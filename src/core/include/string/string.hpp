@@ -17,6 +17,7 @@
 #include "string/locale.hpp"
 #include "string/unicode.hpp"
 #include "utility/iterator.hpp"
+#include "utility/hash.hpp"
 #include "math/atlas_math.hpp"
 #include "core_macro.hpp"
 
@@ -1063,6 +1064,34 @@ protected:
 
 using StringView = BasicStringView<String::value_type>;
 
+/** The inline buffer is told apart by the capacity rather than a pointer to it, so a string may be moved as bytes. */
+template<>
+struct IsTriviallyRelocatable<String> : std::true_type {};
+
+/** Hashes the content with wyhash, transparent so containers keyed by String are searched with a StringView or a C string. */
+template<>
+struct Hash<String>
+{
+    using is_transparent = void;
+    using is_avalanching = void;
+
+    NODISCARD size_t operator()(StringView view) const noexcept
+    {
+        return static_cast<size_t>(wyhash::hash64(view.data(), view.size()));
+    }
+};
+
+template<>
+struct EqualTo<String>
+{
+    using is_transparent = void;
+
+    NODISCARD bool operator()(StringView left, StringView right) const noexcept
+    {
+        return left == right;
+    }
+};
+
 }
 
 template<>
@@ -5,6 +5,7 @@
 
 #include "string/string_name_pool.hpp"
 #include "string/string.hpp"
+#include "utility/simd.hpp"
 
 namespace atlas
 {
@@ -207,6 +208,12 @@ private:
     static inline String name_none_ = String("none");
 };
 
+#if !NAME_PRESERVING_CASE_SENSITIVE
+/** The display id is not compared when names preserve case, so only ids without it compare as bytes. */
+template<>
+struct IsBitwiseComparable<StringName> : std::bool_constant<sizeof(StringName) == sizeof(uint32) * 2> {};
+#endif
+
 } // namespace atlas
 
 template<>
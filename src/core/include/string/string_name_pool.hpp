@@ -3,12 +3,10 @@
 
 #pragma once
 
-#include <shared_mutex>
-
 #include "core_def.hpp"
 #include "string/string.hpp"
 #include "string/string_utility.hpp"
-#include "container/unordered_map.hpp"
+#include "container/concurrent_unordered_map.hpp"
 #include "math/city_hash.hpp"
 
 #ifndef NAME_PRESERVING_CASE_SENSITIVE
@@ -114,27 +112,20 @@ public:
 
     String get_entry(const NameEntryID& entry_id) const
     {
-        std::shared_lock lock(mutex_);
-        if (const String* val = entry_map_.find_value(entry_id.display_id()))
-        {
-            return *val;
-        }
-        return {};
+        String entry;
+        entry_map_.cvisit(entry_id.display_id(), [&entry](const auto& pair) { entry = pair.second; });
+        return entry;
     }
 
     StringView get_entry_view(const NameEntryID& entry_id) const
     {
-        std::shared_lock lock(mutex_);
-        if (const String* val = entry_map_.find_value(entry_id.display_id()))
-        {
-            return StringView(*val);
-        }
-        return {};
+        StringView entry;
+        entry_map_.cvisit(entry_id.display_id(), [&entry](const auto& pair) { entry = StringView(pair.second); });
+        return entry;
     }
 
     bool contains_entry(const NameEntryID& entry_id) const
     {
-        std::shared_lock lock(mutex_);
         return entry_map_.contains(entry_id.display_id());
     }
 
@@ -144,11 +135,7 @@ private:
     template<typename ViewType>
     void store_entry(const NameEntryID& entry_id, const ViewType& view)
     {
-        std::unique_lock lock(mutex_);
-        if (!entry_map_.contains(entry_id.display_id()))
-        {
-            entry_map_.insert(entry_id.display_id(), String(view.data(), view.length()));
-        }
+        entry_map_.try_emplace(entry_id.display_id(), view.data(), view.length());
     }
 
     template<typename ViewType>
@@ -178,8 +165,7 @@ private:
         return 0;
     }
 
-    mutable std::shared_mutex mutex_;
-    UnorderedMap<uint32, String> entry_map_;
+    ConcurrentUnorderedMap<uint32, String> entry_map_;
 };
 
 } // namespace details
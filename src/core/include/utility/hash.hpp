@@ -0,0 +1,39 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <functional>
+
+#include "math/wyhash.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Default hasher of the unordered containers, std::hash unless the type has a better one.
+ * A specialization may declare is_transparent together with EqualTo to let containers be searched with other types
+ * that compare equal to the key, and is_avalanching if every bit of its result is well mixed.
+ * @tparam T
+ */
+template<typename T>
+struct Hash : std::hash<T> {};
+
+/**
+ * @brief Default key comparison of the unordered containers.
+ * @tparam T
+ */
+template<typename T>
+struct EqualTo : std::equal_to<T> {};
+
+/**
+ * @brief Hasher and key comparison that accept keys of other types.
+ */
+template<typename Hasher, typename KeyEqual>
+concept TransparentHash = requires
+{
+    typename Hasher::is_transparent;
+    typename KeyEqual::is_transparent;
+};
+
+}// namespace atlas
@@ -0,0 +1,165 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#pragma once
+
+#include <cstring>
+#include <type_traits>
+
+#include "core_def.hpp"
+#include "core_macro.hpp"
+
+namespace atlas
+{
+
+/**
+ * @brief Whether comparing two values with == gives the same result as comparing their bytes, containers search such
+ * types with SIMD instructions. Specialize it for types whose members are all compared and have no padding.
+ * @tparam T
+ */
+template<typename T>
+struct IsBitwiseComparable : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+template<typename T>
+inline constexpr bool is_bitwise_comparable_v = IsBitwiseComparable<T>::value;
+
+namespace simd
+{
+
+enum class EInstructionSet : uint8
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
+};
+
+/**
+ * @brief Gets the widest instruction set the searches use on this CPU, detected once on first use.
+ * @return
+ */
+NODISCARD CORE_API EInstructionSet get_instruction_set();
+
+/**
+ * @brief Finds the first value in a range.
+ * @param data
+ * @param count
+ * @param value
+ * @return Index of the value, INDEX_NONE_ZU if not found.
+ */
+NODISCARD CORE_API size_t find(const uint8* data, size_t count, uint8 value);
+NODISCARD CORE_API size_t find(const uint16* data, size_t count, uint16 value);
+NODISCARD CORE_API size_t find(const uint32* data, size_t count, uint32 value);
+NODISCARD CORE_API size_t find(const uint64* data, size_t count, uint64 value);
+
+/**
+ * @brief Finds the last value in a range.
+ * @param data
+ * @param count
+ * @param value
+ * @return Index of the value, INDEX_NONE_ZU if not found.
+ */
+NODISCARD CORE_API size_t find_last(const uint8* data, size_t count, uint8 value);
+NODISCARD CORE_API size_t find_last(const uint16* data, size_t count, uint16 value);
+NODISCARD CORE_API size_t find_last(const uint32* data, size_t count, uint32 value);
+NODISCARD CORE_API size_t find_last(const uint64* data, size_t count, uint64 value);
+
+namespace details
+{
+
+template<size_t Size> struct LaneType {};
+template<> struct LaneType<1> { using type = uint8; };
+template<> struct LaneType<2> { using type = uint16; };
+template<> struct LaneType<4> { using type = uint32; };
+template<> struct LaneType<8> { using type = uint64; };
+
+/** Ranges shorter than a vector are searched inline, a call would cost more than the loop. */
+inline constexpr size_t inline_search_bytes = 16;
+
+}// namespace details
+
+/**
+ * @brief Whether a type can be searched with find.
+ * @tparam T
+ */
+template<typename T>
+inline constexpr bool is_searchable_v = is_bitwise_comparable_v<T> && std::is_trivially_copyable_v<T> &&
+                                        (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+template<typename T>
+NODISCARD size_t find(const T* data, size_t count, const T& value) requires is_searchable_v<T>
+{
+    if (count * sizeof(T) < details::inline_search_bytes)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (data[i] == value)
+            {
+                return i;
+            }
+        }
+        return INDEX_NONE_ZU;
+    }
+
+    using lane_type = typename details::LaneType<sizeof(T)>::type;
+    lane_type lane;
+    std::memcpy(&lane, &value, sizeof(T));
+    return find(reinterpret_cast<const lane_type*>(data), count, lane);
+}
+
+template<typename T>
+NODISCARD size_t find_last(const T* data, size_t count, const T& value) requires is_searchable_v<T>
+{
+    if (count * sizeof(T) < details::inline_search_bytes)
+    {
+        for (size_t i = count; i > 0; --i)
+        {
+            if (data[i - 1] == value)
+            {
+                return i - 1;
+            }
+        }
+        return INDEX_NONE_ZU;
+    }
+
+    using lane_type = typename details::LaneType<sizeof(T)>::type;
+    lane_type lane;
+    std::memcpy(&lane, &value, sizeof(T));
+    return find_last(reinterpret_cast<const lane_type*>(data), count, lane);
+}
+
+/**
+ * @brief Removes every occurrence of a value and keeps the order of the rest, runs between matches are found with
+ * find and moved as a whole.
+ * @param data
+ * @param count
+ * @param value
+ * @return Number of values left.
+ */
+template<typename T>
+NODISCARD size_t remove(T* data, size_t count, const T& value) requires is_searchable_v<T>
+{
+    size_t write = find(data, count, value);
+    if (write == INDEX_NONE_ZU)
+    {
+        return count;
+    }
+
+    size_t read = write + 1;
+    while (read < count)
+    {
+        size_t next = find(data + read, count - read, value);
+        next = next == INDEX_NONE_ZU ? count : read + next;
+        if (next > read)
+        {
+            std::memmove(data + write, data + read, (next - read) * sizeof(T));
+            write += next - read;
+        }
+        read = next + 1;
+    }
+    return write;
+}
+
+}// namespace simd
+
+}// namespace atlas
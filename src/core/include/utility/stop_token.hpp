@@ -4,6 +4,9 @@
 #pragma once
 
 #include <atomic>
+#include <functional>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
 #include "../core_def.hpp"
@@ -14,10 +17,33 @@ namespace atlas
 namespace details
 {
 
+/**
+ * @brief Intrusive node of the callback list of a stop state, embedded in StopCallback.
+ */
+struct StopCallbackNode
+{
+    using callback_type = void(*)(StopCallbackNode*);
+
+    explicit StopCallbackNode(callback_type callback) noexcept : callback(callback) {}
+
+    callback_type callback;
+    StopCallbackNode* prev{ nullptr };
+    StopCallbackNode* next{ nullptr };
+    /** Set while the callback runs, tells the requesting thread that the callback deregistered itself. */
+    bool* destroyed{ nullptr };
+};
+
 struct StopState
 {
     std::atomic<uint32> stop_tokens = 1;
     std::atomic<uint32> stop_sources = 2;
+    /** Guards the callback list. Held only to link or unlink a node, never while a callback runs. */
+    std::atomic<bool> callbacks_locked{ false };
+    StopCallbackNode* callbacks{ nullptr };
+    /** The callback running on the requesting thread. Lives in the state rather than the node, so the requesting
+     * thread never touches a node whose remover stopped waiting. */
+    std::atomic<StopCallbackNode*> executing{ nullptr };
+    std::thread::id requesting_thread;
 
     NODISCARD bool stop_requested() const noexcept
     {
@@ -38,16 +64,145 @@ struct StopState
             return false;
         }
 
+        requesting_thread = std::this_thread::get_id();
+        lock_callbacks();
+        // Callbacks run one by one without the lock, so they may deregister themselves or others.
+        while (StopCallbackNode* node = callbacks)
+        {
+            callbacks = node->next;
+            if (callbacks)
+            {
+                callbacks->prev = nullptr;
+            }
+            node->next = nullptr;
+            executing.store(node, std::memory_order_relaxed);
+            unlock_callbacks();
+
+            bool destroyed = false;
+            node->destroyed = &destroyed;
+            node->callback(node);
+            if (!destroyed)
+            {
+                node->destroyed = nullptr;
+            }
+
+            lock_callbacks();
+            executing.store(nullptr, std::memory_order_release);
+            executing.notify_all();
+        }
+        unlock_callbacks();
         return true;
     }
+
+    /**
+     * @brief Links a callback, or runs it on the calling thread if stop has already been requested.
+     * @param node
+     * @return True if the callback has been linked and must be removed later.
+     */
+    bool add_callback(StopCallbackNode* node)
+    {
+        if (stop_requested())
+        {
+            node->callback(node);
+            return false;
+        }
+
+        lock_callbacks();
+        // A concurrent request sets the stop bit before it takes the list, so checking under the lock never misses
+        // the callback.
+        if (stop_requested())
+        {
+            unlock_callbacks();
+            node->callback(node);
+            return false;
+        }
+
+        node->prev = nullptr;
+        node->next = callbacks;
+        if (callbacks)
+        {
+            callbacks->prev = node;
+        }
+        callbacks = node;
+        unlock_callbacks();
+        return true;
+    }
+
+    /**
+     * @brief Unlinks a callback. If it is running on another thread, blocks until it returns.
+     * @param node
+     */
+    void remove_callback(StopCallbackNode* node)
+    {
+        lock_callbacks();
+        if (node->prev || callbacks == node)
+        {
+            if (node->prev)
+            {
+                node->prev->next = node->next;
+            }
+            else
+            {
+                callbacks = node->next;
+            }
+            if (node->next)
+            {
+                node->next->prev = node->prev;
+            }
+            unlock_callbacks();
+            return;
+        }
+
+        const bool is_executing = executing.load(std::memory_order_relaxed) == node;
+        unlock_callbacks();
+
+        if (is_executing)
+        {
+            if (requesting_thread == std::this_thread::get_id())
+            {
+                // deregistered from inside the callback, the node is gone once the callback returns.
+                if (node->destroyed)
+                {
+                    *node->destroyed = true;
+                }
+            }
+            else
+            {
+                // the state outlives the node, so the requesting thread may notify after this returns.
+                executing.wait(node, std::memory_order_acquire);
+            }
+        }
+    }
+
+private:
+    void lock_callbacks()
+    {
+        while (callbacks_locked.exchange(true, std::memory_order_acquire))
+        {
+            while (callbacks_locked.load(std::memory_order_relaxed))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void unlock_callbacks()
+    {
+        callbacks_locked.store(false, std::memory_order_release);
+    }
 };
 
 }// namespace details
 
+template<typename Callback>
+class StopCallback;
+
 class StopToken
 {
     using stop_state = details::StopState;
     friend class StopSource;
+    template<typename Callback>
+    friend class StopCallback;
 public:
     StopToken() = default;
     StopToken(const StopToken& rhs) : state_(rhs.state_)
@@ -108,7 +263,13 @@ public:
     }
 
 private:
-    explicit StopToken(stop_state* state) noexcept : state_(state) {}
+    explicit StopToken(stop_state* state) noexcept : state_(state)
+    {
+        if (const auto local = state_)
+        {
+            local->stop_tokens.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
 
     stop_state* state_{ nullptr };
 };
@@ -195,4 +356,70 @@ private:
     stop_state* state_{ nullptr };
 };
 
+/**
+ * @brief Runs a callback once stop is requested on the token, on the thread that requests it. If stop has already
+ * been requested, the callback runs in the constructor.
+ * Nothing is allocated: the callback is linked intrusively into the stop state and unlinked by the destructor, so it
+ * can live in an awaiter. The destructor blocks while the callback is running on another thread.
+ * Usage:
+ * @code
+ * StopCallback callback(token, [this]() { cancel(); });
+ * @endcode
+ * @tparam Callback Invocable without arguments, must not throw.
+ */
+template<typename Callback>
+class StopCallback : private details::StopCallbackNode
+{
+public:
+    using callback_type = Callback;
+
+    template<typename C> requires std::is_constructible_v<Callback, C>
+    explicit StopCallback(const StopToken& token, C&& callback)
+        : StopCallbackNode(&invoke)
+        , callback_(std::forward<C>(callback))
+    {
+        if (token.state_ && token.state_->add_callback(this))
+        {
+            token_ = token;
+        }
+    }
+
+    template<typename C> requires std::is_constructible_v<Callback, C>
+    explicit StopCallback(StopToken&& token, C&& callback)
+        : StopCallbackNode(&invoke)
+        , callback_(std::forward<C>(callback))
+    {
+        if (token.state_ && token.state_->add_callback(this))
+        {
+            token_ = std::move(token);
+        }
+    }
+
+    ~StopCallback()
+    {
+        if (token_.state_)
+        {
+            token_.state_->remove_callback(this);
+        }
+    }
+
+    StopCallback(const StopCallback&) = delete;
+    StopCallback(StopCallback&&) = delete;
+    StopCallback& operator=(const StopCallback&) = delete;
+    StopCallback& operator=(StopCallback&&) = delete;
+
+private:
+    static void invoke(StopCallbackNode* node)
+    {
+        std::invoke(static_cast<StopCallback*>(node)->callback_);
+    }
+
+    Callback callback_;
+    /** Keeps the stop state alive while the callback is linked. */
+    StopToken token_;
+};
+
+template<typename Callback>
+StopCallback(StopToken, Callback) -> StopCallback<Callback>;
+
 }// namespace atlas
\ No newline at end of file
@@ -0,0 +1,254 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <atomic>
+#include <mutex>
+#include <tuple>
+#include <utility>
+
+#include "async/coroutine_frame_allocator.hpp"
+
+#include "memory/memory.hpp"
+
+namespace atlas
+{
+
+namespace
+{
+
+constexpr size_t size_class_count = CoroutineFrameAllocator::max_pooled_size / CoroutineFrameAllocator::size_class_granularity;
+
+struct FreeFrame
+{
+    FreeFrame* next;
+};
+
+struct FrameCache
+{
+    struct SizeClass
+    {
+        FreeFrame* local{ nullptr };
+        uint32 local_count{ 0 };
+        // Frames freed by other threads. Only the owner detaches the whole list, so there is no ABA.
+        alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<FreeFrame*> remote{ nullptr };
+        // Reserved before a frame is pushed to remote, so it never undercounts the list.
+        std::atomic<uint32> remote_count{ 0 };
+    };
+
+    SizeClass size_classes[size_class_count];
+    FrameCache* next_orphan{ nullptr };
+};
+
+// Keeps the frame payload aligned to the default new alignment.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameHeader
+{
+    FrameCache* owner;
+    size_t size_class;
+};
+
+void free_frames(FreeFrame* frame)
+{
+    while (frame)
+    {
+        FreeFrame* next = frame->next;
+        Memory::free(reinterpret_cast<FrameHeader*>(frame) - 1);
+        frame = next;
+    }
+}
+
+/**
+ * @brief Takes the frames other threads returned to a size class, only the owner of the cache may call it.
+ * @param size_class
+ * @return The list of frames and its length.
+ */
+std::pair<FreeFrame*, uint32> take_remote_frames(FrameCache::SizeClass& size_class)
+{
+    if (!size_class.remote.load(std::memory_order_relaxed))
+    {
+        return { nullptr, 0 };
+    }
+
+    FreeFrame* frames = size_class.remote.exchange(nullptr, std::memory_order_acquire);
+    uint32 count = 0;
+    for (FreeFrame* frame = frames; frame; frame = frame->next)
+    {
+        ++count;
+    }
+    size_class.remote_count.fetch_sub(count, std::memory_order_relaxed);
+    return { frames, count };
+}
+
+/**
+ * Frames may still be alive on other threads when a thread exits, so a cache is never destroyed. The cache of an
+ * exited thread is orphaned and adopted by the next thread which needs a cache. Frames returned to an orphan are
+ * released whenever another thread exits, the registry owns the orphans until then.
+ */
+class FrameCacheRegistry
+{
+public:
+    static FrameCache* acquire()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            if (FrameCache* cache = orphans_)
+            {
+                orphans_ = cache->next_orphan;
+                cache->next_orphan = nullptr;
+                return cache;
+            }
+        }
+        return new FrameCache();
+    }
+
+    static void release(FrameCache* cache)
+    {
+        for (auto&& size_class : cache->size_classes)
+        {
+            free_frames(std::exchange(size_class.local, nullptr));
+            size_class.local_count = 0;
+        }
+
+        std::lock_guard lock(mutex_);
+        cache->next_orphan = orphans_;
+        orphans_ = cache;
+        for (FrameCache* orphan = orphans_; orphan; orphan = orphan->next_orphan)
+        {
+            for (auto&& size_class : orphan->size_classes)
+            {
+                free_frames(take_remote_frames(size_class).first);
+            }
+        }
+    }
+
+private:
+    static inline std::mutex mutex_;
+    static inline FrameCache* orphans_{ nullptr };
+};
+
+/** Cache of a thread, plain data so deallocate can still read it while the thread local objects are destroyed. */
+struct ThreadFrameCacheSlot
+{
+    FrameCache* cache;
+    bool exited;
+};
+
+thread_local ThreadFrameCacheSlot thread_frame_cache;
+
+/**
+ * @brief Orphans the cache of a thread when it exits.
+ */
+struct ThreadFrameCacheExitGuard
+{
+    ~ThreadFrameCacheExitGuard()
+    {
+        thread_frame_cache.exited = true;
+        if (FrameCache* cache = std::exchange(thread_frame_cache.cache, nullptr))
+        {
+            FrameCacheRegistry::release(cache);
+        }
+    }
+
+    bool armed{ false };
+};
+
+thread_local ThreadFrameCacheExitGuard thread_frame_cache_exit_guard;
+
+FrameCache* get_thread_frame_cache()
+{
+    if (FrameCache* cache = thread_frame_cache.cache)
+    {
+        return cache;
+    }
+    // frames of an exited thread are not pooled.
+    if (thread_frame_cache.exited)
+    {
+        return nullptr;
+    }
+    // registers the destructor of the guard for this thread.
+    thread_frame_cache_exit_guard.armed = true;
+    thread_frame_cache.cache = FrameCacheRegistry::acquire();
+    return thread_frame_cache.cache;
+}
+
+}// namespace
+
+void* CoroutineFrameAllocator::allocate(size_t size)
+{
+    FrameCache* cache = size <= max_pooled_size ? get_thread_frame_cache() : nullptr;
+    if (!cache)
+    {
+        auto header = static_cast<FrameHeader*>(Memory::malloc(sizeof(FrameHeader) + size));
+        header->owner = nullptr;
+        header->size_class = 0;
+        return header + 1;
+    }
+
+    const size_t size_class_index = (size + size_class_granularity - 1) / size_class_granularity - 1;
+    FrameCache::SizeClass& size_class = cache->size_classes[size_class_index];
+
+    if (!size_class.local)
+    {
+        std::tie(size_class.local, size_class.local_count) = take_remote_frames(size_class);
+    }
+
+    if (FreeFrame* frame = size_class.local)
+    {
+        size_class.local = frame->next;
+        --size_class.local_count;
+        return frame;
+    }
+
+    auto header = static_cast<FrameHeader*>(Memory::malloc(sizeof(FrameHeader) + (size_class_index + 1) * size_class_granularity));
+    header->owner = cache;
+    header->size_class = size_class_index;
+    return header + 1;
+}
+
+void CoroutineFrameAllocator::deallocate(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    FrameHeader* header = static_cast<FrameHeader*>(ptr) - 1;
+    FrameCache* owner = header->owner;
+    if (!owner)
+    {
+        Memory::free(header);
+        return;
+    }
+
+    auto frame = static_cast<FreeFrame*>(ptr);
+    FrameCache::SizeClass& size_class = owner->size_classes[header->size_class];
+    if (owner == thread_frame_cache.cache)
+    {
+        if (size_class.local_count >= max_cached_frames)
+        {
+            Memory::free(header);
+            return;
+        }
+
+        frame->next = size_class.local;
+        size_class.local = frame;
+        ++size_class.local_count;
+        return;
+    }
+
+    // a thread that only frees frames of another thread must not grow its return list without bound.
+    if (size_class.remote_count.fetch_add(1, std::memory_order_relaxed) >= max_cached_frames)
+    {
+        size_class.remote_count.fetch_sub(1, std::memory_order_relaxed);
+        Memory::free(header);
+        return;
+    }
+
+    FreeFrame* head = size_class.remote.load(std::memory_order_relaxed);
+    do
+    {
+        frame->next = head;
+    }
+    while (!size_class.remote.compare_exchange_weak(head, frame, std::memory_order_release, std::memory_order_relaxed));
+}
+
+}// namespace atlas
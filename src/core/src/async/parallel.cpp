@@ -0,0 +1,23 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "async/parallel.hpp"
+
+#include "configuration/config_manager.hpp"
+
+namespace atlas
+{
+
+/** Num of parallel worker, 0 uses one worker per hardware thread besides the calling thread. */
+uint32 g_parallel_worker_count = 0;
+ConfigVariableRefRegister parallel_worker_count_register("async", "parallel_worker_count", g_parallel_worker_count);
+
+ParallelWorkerPool::thread_pool_type& ParallelWorkerPool::get()
+{
+    static thread_pool_type pool(g_parallel_worker_count > 0
+        ? g_parallel_worker_count
+        : std::max<uint32>(Thread::hardware_concurrency(), 2) - 1, "parallel worker");
+    return pool;
+}
+
+}// namespace atlas
@@ -0,0 +1,239 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "async/task_graph.hpp"
+
+#include "log/logger.hpp"
+#include "platform/platform_fwd.hpp"
+
+namespace atlas
+{
+
+void GraphEvent::wait() const
+{
+    while (!is_completed())
+    {
+        completed_.wait(0, std::memory_order_acquire);
+    }
+}
+
+void GraphEvent::dispatch_subsequents()
+{
+    Array<GraphTask*> subsequents;
+    subsequents_.pop_all_and_close(subsequents);
+
+    completed_.store(1, std::memory_order_release);
+    completed_.notify_all();
+
+    for (GraphTask* task : subsequents)
+    {
+        task->prerequisites_completed(1);
+    }
+}
+
+void GraphEventRef::reset()
+{
+    GraphEvent* event = std::exchange(event_, nullptr);
+    if (event && event->uses_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        delete event;
+    }
+}
+
+void GraphTask::prerequisites_completed(int32 count)
+{
+    if (prerequisites_remaining_.fetch_sub(count, std::memory_order_acq_rel) == count)
+    {
+        graph_.queue_task(this);
+    }
+}
+
+TaskGraph::TaskGraph(uint32 named_thread_count, uint32 worker_count, StringView work_thread_name)
+    : TaskGraph(named_thread_count, worker_count, ThreadAffinityPolicy{}, work_thread_name)
+{}
+
+TaskGraph::TaskGraph(uint32 named_thread_count, uint32 worker_count, const ThreadAffinityPolicy& affinity, StringView work_thread_name)
+    : named_thread_count_(named_thread_count)
+    , named_threads_(std::make_unique<NamedThread[]>(named_thread_count))
+    , worker_signals_(std::make_unique<WakeSignal[]>(worker_count))
+{
+    // Each worker owns a stall bit of the any thread queue.
+    ASSERT(worker_count <= LockFreeLinkPolicy::max_bits_in_link_ptr);
+
+    static const char* default_name = "task graph worker";
+    if (work_thread_name.empty())
+    {
+        work_thread_name = default_name;
+    }
+
+    threads_.reserve(worker_count);
+    for (uint32 i = 0; i < worker_count; ++i)
+    {
+        String thread_name = String::format("{}-{}", work_thread_name, i);
+        threads_.emplace([this, i, thread_name, affinity](StopToken stoken) {
+            affinity.apply(i);
+            run_worker(i, stoken);
+            LOG_INFO(core, "{} terminated", thread_name)
+        }, stop_source_.get_token());
+
+        PlatformTraits::set_thread_name(threads_.last().native_handle(), thread_name);
+    }
+}
+
+TaskGraph::~TaskGraph()
+{
+    join();
+}
+
+GraphEventRef TaskGraph::dispatch(GraphTask::work_type&& work, std::span<const GraphEventRef> prerequisites,
+                                  uint32 thread, ETaskGraphPriority priority)
+{
+    ASSERT(thread == any_thread ? !threads_.is_empty() : thread < named_thread_count_);
+
+    auto task = new GraphTask(*this, std::move(work), thread, priority);
+    // The task may run and be deleted as soon as the last prerequisite is released.
+    GraphEventRef completion = task->completion_;
+
+    // One extra count is held while linking, so the task can't be queued before all prerequisites were visited.
+    const int32 prerequisite_count = static_cast<int32>(prerequisites.size());
+    task->prerequisites_remaining_.store(prerequisite_count + 1, std::memory_order_relaxed);
+
+    int32 completed_count = 1;
+    for (auto&& prerequisite : prerequisites)
+    {
+        if (!prerequisite || !prerequisite->add_subsequent(task))
+        {
+            ++completed_count;
+        }
+    }
+    task->prerequisites_completed(completed_count);
+
+    return completion;
+}
+
+void TaskGraph::process_until_idle(uint32 named_thread)
+{
+    ASSERT(named_thread < named_thread_count_);
+    NamedThread& state = named_threads_[named_thread];
+    while (GraphTask* task = state.queue.pop(0, false))
+    {
+        execute(task);
+    }
+}
+
+void TaskGraph::wait_until_completed(uint32 named_thread, const GraphEventRef& event)
+{
+    ASSERT(named_thread < named_thread_count_);
+    if (!event || event->is_completed())
+    {
+        return;
+    }
+
+    // A task queued to this thread after the event, it only flags the loop to return.
+    bool returning = false;
+    dispatch([&returning]() { returning = true; }, { &event, 1 }, named_thread, ETaskGraphPriority::High);
+
+    NamedThread& state = named_threads_[named_thread];
+    while (!returning)
+    {
+        state.signal.value.store(0, std::memory_order_seq_cst);
+        if (GraphTask* task = state.queue.pop(0, true))
+        {
+            execute(task);
+            continue;
+        }
+
+        // The queue has marked this thread as stalled, the next push clears the bit and signals it.
+        state.signal.value.wait(0, std::memory_order_acquire);
+    }
+}
+
+bool TaskGraph::request_stop()
+{
+    if (!stop_source_.stop_possible())
+    {
+        return false;
+    }
+
+    stop_source_.request_stop();
+    // wake up all work thread
+    for (uint32 i = 0; i < threads_.size(); ++i)
+    {
+        signal(worker_signals_[i]);
+    }
+    return true;
+}
+
+void TaskGraph::join()
+{
+    request_stop();
+
+    for (auto&& thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+void TaskGraph::queue_task(GraphTask* task)
+{
+    const uint32 priority = static_cast<uint32>(task->priority_);
+    if (task->thread_ == any_thread)
+    {
+        const int32 thread_to_wake = any_thread_queue_.push(task, priority);
+        if (thread_to_wake >= 0)
+        {
+            signal(worker_signals_[thread_to_wake]);
+        }
+    }
+    else
+    {
+        NamedThread& state = named_threads_[task->thread_];
+        if (state.queue.push(task, priority) >= 0)
+        {
+            signal(state.signal);
+        }
+    }
+}
+
+void TaskGraph::execute(GraphTask* task)
+{
+    std::invoke(task->work_);
+
+    GraphEventRef completion = std::move(task->completion_);
+    delete task;
+    completion->dispatch_subsequents();
+}
+
+void TaskGraph::run_worker(uint32 worker_index, const StopToken& stoken)
+{
+    WakeSignal& wake_signal = worker_signals_[worker_index];
+    while (true)
+    {
+        wake_signal.value.store(0, std::memory_order_seq_cst);
+        if (GraphTask* task = any_thread_queue_.pop(static_cast<int32>(worker_index), true))
+        {
+            execute(task);
+            continue;
+        }
+
+        // Checked after clearing the signal, so a stop request is either seen here or wakes the wait below.
+        if (stoken.stop_requested())
+        {
+            break;
+        }
+
+        // The queue has marked this worker as stalled, the next push clears the bit and signals only this worker.
+        wake_signal.value.wait(0, std::memory_order_acquire);
+    }
+}
+
+void TaskGraph::signal(WakeSignal& signal)
+{
+    signal.value.store(1, std::memory_order_seq_cst);
+    signal.value.notify_one();
+}
+
+}// namespace atlas
@@ -0,0 +1,206 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "async/thread_pool_scheduler.hpp"
+
+#include "log/logger.hpp"
+#include "platform/platform_fwd.hpp"
+
+namespace atlas
+{
+
+static thread_local ThreadPoolScheduler* current_scheduler = nullptr;
+static thread_local uint32 current_worker_index = 0;
+
+struct ThreadPoolScheduler::Worker
+{
+    // Lock free LIFO of operations pushed by any thread. Consumers only ever detach the whole list, so there is no ABA.
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<ScheduleOperation*> inbox{ nullptr };
+    // Operations detached from an inbox in FIFO order, only touched by the owner thread.
+    ScheduleOperation* local_head{ nullptr };
+    uint32 random_state{ 0 };
+};
+
+ThreadPoolScheduler::ThreadPoolScheduler(uint32 thread_count, StringView work_thread_name)
+    : ThreadPoolScheduler(thread_count, ThreadAffinityPolicy{}, work_thread_name)
+{}
+
+ThreadPoolScheduler::ThreadPoolScheduler(uint32 thread_count, const ThreadAffinityPolicy& affinity, StringView work_thread_name)
+    : worker_count_(thread_count > 0 ? thread_count : 1)
+    , workers_(std::make_unique<Worker[]>(worker_count_))
+    , parking_(worker_count_)
+{
+    static const char* default_name = "thread pool scheduler worker";
+    if (work_thread_name.empty())
+    {
+        work_thread_name = default_name;
+    }
+
+    threads_.reserve(worker_count_);
+    for (uint32 i = 0; i < worker_count_; ++i)
+    {
+        workers_[i].random_state = i + 1;
+
+        String thread_name = String::format("{}-{}", work_thread_name, i);
+        threads_.emplace([this, i, thread_name, affinity](StopToken stoken) {
+            affinity.apply(i);
+            run(i, stoken);
+            LOG_INFO(core, "{} terminated", thread_name)
+        }, stop_source_.get_token());
+
+        PlatformTraits::set_thread_name(threads_.last().native_handle(), thread_name);
+    }
+}
+
+ThreadPoolScheduler::~ThreadPoolScheduler()
+{
+    join();
+}
+
+void ThreadPoolScheduler::schedule(ScheduleOperation* operation) noexcept
+{
+    ASSERT(operation && operation->handle_);
+    // Keeps continuations of a worker on its own inbox for locality, spreads the others round robin.
+    const uint32 target = is_in_worker_thread()
+        ? current_worker_index
+        : next_worker_.fetch_add(1, std::memory_order_relaxed) % worker_count_;
+
+    std::atomic<ScheduleOperation*>& inbox = workers_[target].inbox;
+    ScheduleOperation* head = inbox.load(std::memory_order_relaxed);
+    do
+    {
+        operation->next_ = head;
+    }
+    while (!inbox.compare_exchange_weak(head, operation, std::memory_order_release, std::memory_order_relaxed));
+
+    parking_.wake_one();
+}
+
+bool ThreadPoolScheduler::request_stop()
+{
+    if (!stop_source_.stop_possible())
+    {
+        return false;
+    }
+
+    stop_source_.request_stop();
+    parking_.wake_all();
+    return true;
+}
+
+void ThreadPoolScheduler::join()
+{
+    request_stop();
+
+    for (auto&& thread : threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    drain();
+}
+
+bool ThreadPoolScheduler::is_in_worker_thread() const
+{
+    return current_scheduler == this;
+}
+
+void ThreadPoolScheduler::run(uint32 worker_index, const StopToken& stoken)
+{
+    current_scheduler = this;
+    current_worker_index = worker_index;
+
+    Worker& self = workers_[worker_index];
+    while (!stoken.stop_requested())
+    {
+        if (!self.local_head)
+        {
+            self.local_head = take_inbox(self);
+        }
+        if (!self.local_head)
+        {
+            self.local_head = steal(worker_index);
+        }
+
+        if (ScheduleOperation* operation = self.local_head)
+        {
+            // The operation lives in the coroutine frame, unlink it before resuming.
+            self.local_head = operation->next_;
+            operation->handle_.resume();
+            continue;
+        }
+
+        parking_.park(worker_index, [this, &stoken] {
+            return stoken.stop_requested() || has_pending_operation();
+        });
+    }
+
+    current_scheduler = nullptr;
+}
+
+ThreadPoolScheduler::ScheduleOperation* ThreadPoolScheduler::take_inbox(Worker& worker)
+{
+    if (!worker.inbox.load(std::memory_order_relaxed))
+    {
+        return nullptr;
+    }
+
+    ScheduleOperation* operation = worker.inbox.exchange(nullptr, std::memory_order_acquire);
+    // The inbox is LIFO, reverse it so operations are resumed in the order they were scheduled.
+    ScheduleOperation* reversed = nullptr;
+    while (operation)
+    {
+        ScheduleOperation* next = operation->next_;
+        operation->next_ = reversed;
+        reversed = operation;
+        operation = next;
+    }
+    return reversed;
+}
+
+ThreadPoolScheduler::ScheduleOperation* ThreadPoolScheduler::steal(uint32 worker_index)
+{
+    return steal_from_random_victim(workers_[worker_index].random_state, worker_index, worker_count_, [this](uint32 victim) {
+        return take_inbox(workers_[victim]);
+    });
+}
+
+bool ThreadPoolScheduler::has_pending_operation() const
+{
+    for (uint32 i = 0; i < worker_count_; ++i)
+    {
+        if (workers_[i].inbox.load(std::memory_order_relaxed))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPoolScheduler::drain()
+{
+    // Suspended coroutines would never complete otherwise. A resumed coroutine may schedule again, so loop
+    // until every inbox stays empty.
+    bool resumed = true;
+    while (resumed)
+    {
+        resumed = false;
+        for (uint32 i = 0; i < worker_count_; ++i)
+        {
+            Worker& worker = workers_[i];
+            ScheduleOperation* operation = worker.local_head ? std::exchange(worker.local_head, nullptr) : take_inbox(worker);
+            while (operation)
+            {
+                ScheduleOperation* next = operation->next_;
+                operation->handle_.resume();
+                operation = next;
+                resumed = true;
+            }
+        }
+    }
+}
+
+}// namespace atlas
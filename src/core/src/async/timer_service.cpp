@@ -0,0 +1,303 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <bit>
+#include <limits>
+
+#include "async/timer_service.hpp"
+
+#include "log/logger.hpp"
+
+namespace atlas
+{
+
+TimerService::TimerService(ThreadPoolScheduler* scheduler)
+    : owned_scheduler_(scheduler ? nullptr : std::make_unique<ThreadPoolScheduler>(continuation_worker_count_, "timer continuation"))
+    , scheduler_(scheduler ? scheduler : owned_scheduler_.get())
+    , epoch_(TimerClock::now())
+    , wake_tick_(std::numeric_limits<uint64>::max())
+    , thread_([this](StopToken stoken) {
+        run(stoken);
+        LOG_INFO(core, "timer service terminated")
+    })
+{
+    thread_.set_name("timer service");
+}
+
+TimerService::~TimerService()
+{
+    {
+        std::lock_guard lock(mutex_);
+        thread_.request_stop();
+    }
+    awake_signal_.notify_one();
+    thread_.join();
+
+    // Suspended coroutines would never complete otherwise, an owned scheduler resumes them when it is joined.
+    TimerNode* pending = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        for (uint32 level = 0; level < level_count_; ++level)
+        {
+            for (uint32 slot = 0; slot < slots_per_level_; ++slot)
+            {
+                while (TimerNode* node = slots_[level][slot])
+                {
+                    unlink(node);
+                    node->next = pending;
+                    pending = node;
+                }
+            }
+        }
+    }
+    fire(pending, true);
+}
+
+TimerService& TimerService::get()
+{
+    static TimerService service;
+    return service;
+}
+
+void TimerService::schedule(TimerNode* node, TimerClock::time_point deadline)
+{
+    ASSERT(node && !node->linked);
+    // registered before the node is linked, the node may be gone as soon as it is linked.
+    if (node->stop_token.stop_possible())
+    {
+        node->stop_callback.emplace(node->stop_token, TimerStopHandler{ this, node });
+    }
+
+    bool wake_up;
+    {
+        std::lock_guard lock(mutex_);
+        if (node->stop_token.stop_requested())
+        {
+            node->next = stopped_;
+            stopped_ = node;
+            wake_up = true;
+        }
+        else
+        {
+            node->expiry_tick = std::max(to_tick(deadline), now_tick_ + 1);
+            link(node);
+            wake_up = node->expiry_tick < wake_tick_;
+            if (wake_up)
+            {
+                wake_tick_ = node->expiry_tick;
+            }
+        }
+    }
+
+    if (wake_up)
+    {
+        awake_signal_.notify_one();
+    }
+}
+
+bool TimerService::cancel(TimerNode* node)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (!node->linked)
+        {
+            return false;
+        }
+        unlink(node);
+    }
+    // waits for a stop callback running concurrently, it finds the node unlinked.
+    node->stop_callback.reset();
+    return true;
+}
+
+void TimerStopHandler::operator()() const
+{
+    service->stop(node);
+}
+
+void TimerService::stop(TimerNode* node)
+{
+    {
+        std::lock_guard lock(mutex_);
+        if (!node->linked)
+        {
+            // not linked yet, schedule finds the stop request, or has already fired.
+            return;
+        }
+        unlink(node);
+        node->next = stopped_;
+        stopped_ = node;
+    }
+    awake_signal_.notify_one();
+}
+
+void TimerService::run(const StopToken& stoken)
+{
+    std::unique_lock lock(mutex_);
+    while (!stoken.stop_requested())
+    {
+        TimerNode* expired = nullptr;
+        advance(static_cast<uint64>((TimerClock::now() - epoch_) / tick_duration), expired);
+        TimerNode* stopped = std::exchange(stopped_, nullptr);
+        if (expired || stopped)
+        {
+            lock.unlock();
+            fire(expired, false);
+            fire(stopped, true);
+            lock.lock();
+            continue;
+        }
+
+        wake_tick_ = next_event_tick();
+        if (wake_tick_ == std::numeric_limits<uint64>::max())
+        {
+            awake_signal_.wait(lock);
+        }
+        else
+        {
+            awake_signal_.wait_until(lock, to_time_point(wake_tick_));
+        }
+    }
+}
+
+uint64 TimerService::to_tick(TimerClock::time_point time_point) const
+{
+    if (time_point <= epoch_)
+    {
+        return 0;
+    }
+    // rounds up, so a timer never fires before its deadline.
+    return static_cast<uint64>(std::chrono::ceil<std::chrono::milliseconds>(time_point - epoch_) / tick_duration);
+}
+
+TimerClock::time_point TimerService::to_time_point(uint64 tick) const
+{
+    return epoch_ + tick * tick_duration;
+}
+
+void TimerService::link(TimerNode* node)
+{
+    // timers beyond the range of the wheel wait in the top level, they are linked again when it wraps to them.
+    const uint64 delta = std::min(node->expiry_tick - now_tick_, max_delta_);
+    const uint64 place_tick = now_tick_ + delta;
+    uint32 level = 0;
+    while (level + 1 < level_count_ && delta >= (uint64(1) << (slot_bits_ * (level + 1))))
+    {
+        ++level;
+    }
+    const uint32 slot = static_cast<uint32>(place_tick >> (slot_bits_ * level)) & (slots_per_level_ - 1);
+
+    TimerNode*& head = slots_[level][slot];
+    node->prev = nullptr;
+    node->next = head;
+    if (head)
+    {
+        head->prev = node;
+    }
+    head = node;
+    occupied_[level] |= uint64(1) << slot;
+    node->slot = level * slots_per_level_ + slot;
+    node->linked = true;
+}
+
+void TimerService::unlink(TimerNode* node)
+{
+    const uint32 level = node->slot / slots_per_level_;
+    const uint32 slot = node->slot % slots_per_level_;
+    if (node->prev)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        slots_[level][slot] = node->next;
+        if (!node->next)
+        {
+            occupied_[level] &= ~(uint64(1) << slot);
+        }
+    }
+    if (node->next)
+    {
+        node->next->prev = node->prev;
+    }
+    node->prev = node->next = nullptr;
+    node->linked = false;
+}
+
+void TimerService::advance(uint64 target_tick, TimerNode*& expired)
+{
+    while (now_tick_ < target_tick)
+    {
+        // nothing happens between now and the next event, skip the empty ticks at once.
+        const uint64 next_tick = next_event_tick();
+        if (next_tick > target_tick)
+        {
+            now_tick_ = target_tick;
+            return;
+        }
+        now_tick_ = next_tick;
+
+        // moves timers of upper levels down once the level below has wrapped around.
+        for (uint32 level = level_count_ - 1; level > 0; --level)
+        {
+            const uint32 shift = slot_bits_ * level;
+            if ((now_tick_ & ((uint64(1) << shift) - 1)) != 0)
+            {
+                continue;
+            }
+
+            const uint32 slot = static_cast<uint32>(now_tick_ >> shift) & (slots_per_level_ - 1);
+            TimerNode* node = std::exchange(slots_[level][slot], nullptr);
+            occupied_[level] &= ~(uint64(1) << slot);
+            while (node)
+            {
+                TimerNode* next = node->next;
+                link(node);
+                node = next;
+            }
+        }
+
+        const uint32 slot = static_cast<uint32>(now_tick_) & (slots_per_level_ - 1);
+        while (TimerNode* node = slots_[0][slot])
+        {
+            unlink(node);
+            node->next = expired;
+            expired = node;
+        }
+    }
+}
+
+uint64 TimerService::next_event_tick() const
+{
+    uint64 result = std::numeric_limits<uint64>::max();
+    for (uint32 level = 0; level < level_count_; ++level)
+    {
+        if (occupied_[level] == 0)
+        {
+            continue;
+        }
+
+        // finds the first occupied slot after the current one, the current slot itself comes last.
+        const uint32 shift = slot_bits_ * level;
+        const uint64 position = now_tick_ >> shift;
+        const uint32 start = static_cast<uint32>(position + 1) & (slots_per_level_ - 1);
+        const uint64 distance = std::countr_zero(std::rotr(occupied_[level], static_cast<int32>(start))) + 1;
+        result = std::min(result, (position + distance) << shift);
+    }
+    return result;
+}
+
+void TimerService::fire(TimerNode* list, bool cancelled)
+{
+    while (list)
+    {
+        // the node may be destroyed by on_fired.
+        TimerNode* next = list->next;
+        // waits for a stop callback running concurrently, it finds the node unlinked.
+        list->stop_callback.reset();
+        list->on_fired(cancelled);
+        list = next;
+    }
+}
+
+}// namespace atlas
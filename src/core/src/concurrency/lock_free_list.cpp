@@ -35,7 +35,7 @@ void* atomic_compare_exchange_pointer(void* volatile* dest, void* exchange, void
 {
 #if PLATFORM_WINDOWS
     return ::_InterlockedCompareExchangePointer(dest, exchange, comparand);
-#elif PLATFORM_APPLE
+#elif PLATFORM_APPLE || PLATFORM_LINUX
     __atomic_compare_exchange_n(dest, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
     return comparand;
 #endif
@@ -45,7 +45,7 @@ int64 atomic_compare_exchange(volatile int64* dest, int64 exchange, int64 compar
 {
 #if PLATFORM_WINDOWS
     return ::_InterlockedCompareExchange64(dest, exchange, comparand);
-#elif PLATFORM_APPLE
+#elif PLATFORM_APPLE || PLATFORM_LINUX
     __atomic_compare_exchange_n(dest, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
     return comparand;
 #endif
@@ -55,42 +55,71 @@ int64 atomic_read(volatile const int64* src)
 {
 #if PLATFORM_WINDOWS
     return atomic_compare_exchange(const_cast<int64*>(src), 0, 0);
-#elif PLATFORM_APPLE
+#elif PLATFORM_APPLE || PLATFORM_LINUX
     return __atomic_load_n(src, __ATOMIC_SEQ_CST);
 #endif
 }
 
-static uint32 alloc_tls_slot()
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+bool atomic_compare_exchange_128(volatile Int128* dest, const Int128& exchange, Int128* comparand)
 {
-#if PLATFORM_WINDOWS
-    return ::TlsAlloc();
+#if COMPILER_MSVC
+    return ::_InterlockedCompareExchange128(reinterpret_cast<volatile int64*>(dest), static_cast<int64>(exchange.high),
+                                            static_cast<int64>(exchange.low), reinterpret_cast<int64*>(comparand)) == 1;
 #else
-    return 0;
+    // Inline assembly instead of __atomic builtins, which call into libatomic for 16 bytes unless built with -mcx16.
+    bool result;
+    __asm__ __volatile__("lock cmpxchg16b %1"
+        : "=@ccz"(result), "+m"(*dest), "+a"(comparand->low), "+d"(comparand->high)
+        : "b"(exchange.low), "c"(exchange.high)
+        : "memory");
+    return result;
 #endif
 }
 
-static void free_tls_slot(uint32 slot)
+void atomic_read_128(volatile const Int128* src, Int128* out_result)
 {
+    // Two ordered loads instead of a locked cmpxchg16b, which would make every read take the cache line exclusively.
+    // The pointer is loaded before the counter, so a torn result pairs a pointer with a newer counter. Such a pair
+    // only matches the value of src if src still holds that pointer with that counter, so a compare exchange using
+    // it never succeeds on a stale pointer.
+#if COMPILER_MSVC
+    out_result->low = ::__iso_volatile_load64(reinterpret_cast<volatile const int64*>(&src->low));
+    _ReadWriteBarrier();
+    out_result->high = ::__iso_volatile_load64(reinterpret_cast<volatile const int64*>(&src->high));
+    _ReadWriteBarrier();
+#else
+    out_result->low = __atomic_load_n(&src->low, __ATOMIC_ACQUIRE);
+    out_result->high = __atomic_load_n(&src->high, __ATOMIC_ACQUIRE);
+#endif
+}
+#endif
+
 #if PLATFORM_WINDOWS
+static uint32 alloc_tls_slot()
+{
+    return ::TlsAlloc();
+}
+
+static void free_tls_slot(uint32 slot)
+{
     ::TlsFree(slot);
-#endif
 }
 
 static void* get_tls_value(uint32 slot)
 {
-#if PLATFORM_WINDOWS
     return ::TlsGetValue(slot);
-#else
-    return nullptr;
-#endif
 }
 
 static void set_tls_value(uint32 slot, void* value)
 {
-#if PLATFORM_WINDOWS
 	::TlsSetValue(slot, value);
-#endif
 }
+#endif
+
+class LockFreeLinkAllocator_TLSCache;
+
+static LockFreeLinkAllocator_TLSCache& get_lock_free_allocator();
 
 class LockFreeLinkAllocator_TLSCache
 {
@@ -103,15 +132,19 @@ public:
 
 	LockFreeLinkAllocator_TLSCache()
 	{
+#if PLATFORM_WINDOWS
 		// check(IsInGameThread());
 		tls_slot_ = alloc_tls_slot();
 		// check(FPlatformTLS::IsValidTlsSlot(TlsSlot));
+#endif
 	}
 	/** Destructor, leaks all of the memory **/
 	~LockFreeLinkAllocator_TLSCache()
 	{
+#if PLATFORM_WINDOWS
 		free_tls_slot(tls_slot_);
 		tls_slot_ = 0;
+#endif
 	}
 
     LockFreeLinkAllocator_TLSCache(const LockFreeLinkAllocator_TLSCache&) = delete;
@@ -141,15 +174,29 @@ public:
 				tls.partial_bundle = global_free_list_bundles_.pop();
 				if (!tls.partial_bundle)
 				{
+#if LOCK_FREE_LINKS_USE_128BIT_ATOMICS
+					// links are never given back, a recycled link may still be read by a thread which lost a race.
+					auto links = static_cast<link_type*>(lock_free_alloc_links(per_bundle_size_ * sizeof(link_type)));
+					ASSERT(math::is_aligned(links, alignof(link_type)));
+					for (int32 index = 0; index < per_bundle_size_; index++)
+					{
+						link_type* event = new(links + index) link_type();
+						event->double_next.init();
+						event->single_next = 0;
+						event->payload = (void*)std::uintptr_t(tls.partial_bundle);
+						tls.partial_bundle = event;
+					}
+#else
                     const uint32 first_index = LockFreeLinkPolicy::link_allocator.alloc(per_bundle_size_);
 					for (int32 index = 0; index < per_bundle_size_; index++)
 					{
 						link_type* event = LockFreeLinkPolicy::index_to_link(first_index + index);
 						event->double_next.init();
 						event->single_next = 0;
-						event->payload = reinterpret_cast<void*>(static_cast<std::uintptr_t>(tls.partial_bundle));
+						event->payload = (void*)std::uintptr_t(tls.partial_bundle);
 						tls.partial_bundle = LockFreeLinkPolicy::index_to_ptr(first_index + index);
 					}
+#endif
 				}
 			}
 			tls.num_partial = per_bundle_size_;
@@ -164,6 +211,12 @@ public:
 		return result;
 	}
 
+	/** Constructs the cache of the calling thread. */
+	void ensure_tls()
+	{
+		get_tls();
+	}
+
 	/**
 	* Puts a memory block previously obtained from Allocate() back on the free list for future use.
 	*
@@ -209,6 +262,7 @@ private:
 		}
 	};
 
+#if PLATFORM_WINDOWS
 	ThreadLocalCache& get_tls()
 	{
 		// checkSlow(FPlatformTLS::IsValidTlsSlot(TlsSlot));
@@ -223,6 +277,27 @@ private:
 
 	/** Slot for TLS struct. */
 	uint32 tls_slot_;
+#else
+	/** Hands the full bundle back to the global list when the thread exits, the partial bundle is leaked. */
+	struct ThreadExitCache : ThreadLocalCache
+	{
+		~ThreadExitCache()
+		{
+			if (full_bundle)
+			{
+				get_lock_free_allocator().global_free_list_bundles_.push(full_bundle);
+				full_bundle = 0;
+			}
+		}
+	};
+
+	ThreadLocalCache& get_tls()
+	{
+		// the allocator is a never destroyed singleton, so a plain thread_local replaces the TLS slot.
+		static thread_local ThreadExitCache tls;
+		return tls;
+	}
+#endif
 
 	/** Lock free list of free memory blocks, these are all linked into a bundle of NUM_PER_BUNDLE. */
 	LockFreePointerListLIFORoot<PLATFORM_CACHE_LINE_SIZE> global_free_list_bundles_;
@@ -241,7 +316,7 @@ static LockFreeLinkAllocator_TLSCache& get_lock_free_allocator()
 	return *(LockFreeLinkAllocator_TLSCache*)data;
 }
 
-uint32 LockFreeLinkPolicy::alloc_lock_free_link()
+LockFreeLinkPolicy::link_ptr_type LockFreeLinkPolicy::alloc_lock_free_link()
 {
     LockFreeLinkPolicy::link_ptr_type result = get_lock_free_allocator().pop();
     // this can only really be a mem stomp
@@ -249,12 +324,19 @@ uint32 LockFreeLinkPolicy::alloc_lock_free_link()
     return result;
 }
 
-void LockFreeLinkPolicy::free_lock_free_link(uint32 item)
+void LockFreeLinkPolicy::free_lock_free_link(link_ptr_type item)
 {
     get_lock_free_allocator().push(item);
 }
 
+void LockFreeLinkPolicy::ensure_thread_cache()
+{
+    get_lock_free_allocator().ensure_tls();
+}
+
+#if !LOCK_FREE_LINKS_USE_128BIT_ATOMICS
 LockFreeLinkPolicy::allocator_type LockFreeLinkPolicy::link_allocator;
+#endif
 
 
 }// namespace atlas
\ No newline at end of file
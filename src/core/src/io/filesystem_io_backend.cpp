@@ -21,7 +21,8 @@ ConfigVariableRefRegister tmp("io", "filesystem_io_worker_count", g_io_worker_co
 Task<size_t> FilesystemIOBackend::async_read(Path file, IOBuffer& buffer, size_t read_size, size_t offset, EIOPriority priority)
 {
     size_t read = 0;
-    if (!std::filesystem::exists(file))
+    StopToken stop_token = co_await co_get_current_stop_token();
+    if (stop_token.stop_requested() || !std::filesystem::exists(file))
     {
         co_return read;
     }
@@ -62,9 +63,15 @@ Task<size_t> FilesystemIOBackend::async_read(Path file, IOBuffer& buffer, size_t
         co_return read;
     }
 
-    buffer.resize(old_size + actual_read_size);
+    // overwritten by the read below, zero filling it first would be a wasted pass over the buffer.
+    buffer.resize_uninitialized(old_size + actual_read_size);
 
-    co_await co_schedule_on(*this, priority);
+    if (!co_await co_schedule_read(priority, std::move(stop_token)))
+    {
+        buffer.resize(old_size);
+        guard.call_now();
+        co_return read;
+    }
 
     fseek(stream, offset, SEEK_SET);
     read = std::fread(buffer.data() + old_size, sizeof(byte), actual_read_size, stream);
@@ -78,7 +85,7 @@ Task<size_t> FilesystemIOBackend::async_read(Path file, IOBuffer& buffer, size_t
         }
         else
         {
-            buffer.resize(read);
+            buffer.resize(old_size + read);
         }
     }
 
@@ -3,9 +3,52 @@
 
 #include "memory/memory.hpp"
 
+#include "configuration/config_manager.hpp"
+#include "memory/thread_caching_malloc.hpp"
+#include "memory/tracking_malloc.hpp"
+
 namespace atlas
 {
 
+static TrackingMalloc* g_memory_tracker = nullptr;
+
+MallocBase* Memory::create_default_malloc()
+{
+    MallocBase* instance = PlatformMemory::GetDefaultMalloc().release();
+#if WITH_MEMORY_TRACKING
+    g_memory_tracker = new TrackingMalloc(instance);
+    instance = g_memory_tracker;
+#endif
+    return instance;
+}
+
+TrackingMalloc* TrackingMalloc::get()
+{
+    return g_memory_tracker;
+}
+
+/** Allocator behind Memory, "standard" or "thread_caching". */
+String g_malloc_name = "standard";
+ConfigVariableRefRegister malloc_name_register("memory", "malloc", g_malloc_name);
+
+static bool select_malloc()
+{
+    if (g_malloc_name == "thread_caching")
+    {
+        // blocks allocated so far, by the config system among others, are handed back to the previous allocator.
+        if (TrackingMalloc* tracker = TrackingMalloc::get())
+        {
+            tracker->set_inner(new ThreadCachingMalloc(tracker->get_inner()));
+        }
+        else
+        {
+            Memory::set_malloc_instance(new ThreadCachingMalloc(Memory::get_malloc_instance()));
+        }
+        return true;
+    }
+    return false;
+}
 
+static const bool g_malloc_selected = select_malloc();
 
-}
\ No newline at end of file
+}// namespace atlas
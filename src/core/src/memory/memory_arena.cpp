@@ -0,0 +1,159 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <cstring>
+
+#include "memory/memory_arena.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct alignas(std::max_align_t) ArenaChunk
+{
+    ArenaChunk* previous{ nullptr };
+    size_t size{ 0 };
+    /** Bytes in use when the arena moved on to the next chunk. */
+    size_t used{ 0 };
+
+    char* data()
+    {
+        return reinterpret_cast<char*>(this + 1);
+    }
+};
+
+}// namespace details
+
+using details::ArenaChunk;
+
+MemoryArena::MemoryArena(size_t chunk_size) : chunk_size_(chunk_size)
+{
+    ASSERT(chunk_size > 0);
+}
+
+MemoryArena::~MemoryArena()
+{
+    reset();
+    while (free_chunks_)
+    {
+        ArenaChunk* chunk = free_chunks_;
+        free_chunks_ = chunk->previous;
+        Memory::free(chunk);
+    }
+}
+
+void* MemoryArena::reallocate(void* ptr, size_t old_size, size_t new_size, size_t alignment)
+{
+    if (!ptr)
+    {
+        return allocate(new_size, alignment);
+    }
+
+    char* block = static_cast<char*>(ptr);
+    if (block + old_size == cursor_ && block + new_size <= end_)
+    {
+        cursor_ = block + new_size;
+        return ptr;
+    }
+
+    void* new_ptr = allocate(new_size, alignment);
+    std::memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
+    return new_ptr;
+}
+
+MemoryArena::Marker MemoryArena::get_marker() const
+{
+    return Marker{ current_, current_ ? static_cast<size_t>(cursor_ - current_->data()) : 0 };
+}
+
+void MemoryArena::rewind(Marker marker)
+{
+    release_chunks_after(marker.chunk);
+    if (marker.chunk)
+    {
+        ASSERT(marker.offset <= marker.chunk->size);
+        cursor_ = marker.chunk->data() + marker.offset;
+        end_ = marker.chunk->data() + marker.chunk->size;
+    }
+    else
+    {
+        cursor_ = nullptr;
+        end_ = nullptr;
+    }
+}
+
+size_t MemoryArena::get_used_size() const
+{
+    if (!current_)
+    {
+        return 0;
+    }
+
+    size_t used = cursor_ - current_->data();
+    for (ArenaChunk* chunk = current_->previous; chunk; chunk = chunk->previous)
+    {
+        used += chunk->used;
+    }
+    return used;
+}
+
+void* MemoryArena::allocate_slow(size_t size, size_t alignment)
+{
+    const size_t required = size + (alignment > alignof(ArenaChunk) ? alignment : 0);
+
+    ArenaChunk** link = &free_chunks_;
+    while (*link && (*link)->size < required)
+    {
+        link = &(*link)->previous;
+    }
+
+    ArenaChunk* chunk = *link;
+    if (chunk)
+    {
+        *link = chunk->previous;
+    }
+    else
+    {
+        const size_t chunk_size = required > chunk_size_ ? required : chunk_size_;
+        chunk = static_cast<ArenaChunk*>(Memory::malloc(sizeof(ArenaChunk) + chunk_size));
+        chunk->size = chunk_size;
+        reserved_size_ += chunk_size;
+    }
+
+    if (current_)
+    {
+        current_->used = cursor_ - current_->data();
+    }
+    chunk->previous = current_;
+    chunk->used = 0;
+    current_ = chunk;
+    cursor_ = chunk->data();
+    end_ = chunk->data() + chunk->size;
+
+    char* ptr = align_up(cursor_, alignment);
+    ASSERT(ptr + size <= end_);
+    cursor_ = ptr + size;
+    return ptr;
+}
+
+void MemoryArena::release_chunks_after(ArenaChunk* chunk)
+{
+    while (current_ != chunk)
+    {
+        ASSERT(current_);
+        ArenaChunk* released = current_;
+        current_ = released->previous;
+        released->previous = free_chunks_;
+        free_chunks_ = released;
+    }
+}
+
+FrameAllocator& FrameAllocator::get()
+{
+    static FrameAllocator instance;
+    return instance;
+}
+
+}// namespace atlas
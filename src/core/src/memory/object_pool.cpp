@@ -0,0 +1,178 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "memory/object_pool.hpp"
+
+namespace atlas
+{
+
+FixedSizeAllocator::FixedSizeAllocator(size_t block_size, size_t block_alignment, size_t page_size)
+    : block_alignment_(block_alignment)
+{
+    ASSERT(block_alignment > 0 && (block_alignment & (block_alignment - 1)) == 0);
+    if (block_size < sizeof(block_type))
+    {
+        block_size = sizeof(block_type);
+    }
+    if (block_alignment < alignof(block_type))
+    {
+        block_alignment_ = alignof(block_type);
+    }
+    block_size_ = (block_size + block_alignment_ - 1) & ~(block_alignment_ - 1);
+    page_size_ = page_size < block_size_ ? block_size_ : page_size;
+}
+
+FixedSizeAllocator::~FixedSizeAllocator()
+{
+    for (void* page : pages_)
+    {
+        Memory::aligned_free(page);
+    }
+}
+
+void* FixedSizeAllocator::allocate_page()
+{
+    void* page_ptr = Memory::aligned_malloc(page_size_, block_alignment_);
+    pages_.add(page_ptr);
+
+    char* page = static_cast<char*>(page_ptr);
+    cursor_ = page + block_size_;
+    end_ = page + page_size_ / block_size_ * block_size_;
+    return page;
+}
+
+ConcurrentFixedSizeAllocator::ConcurrentFixedSizeAllocator(size_t block_size, size_t block_alignment, size_t page_size)
+    : pages_(block_size, block_alignment, page_size)
+    , thread_caches_(this)
+{
+}
+
+ConcurrentFixedSizeAllocator::~ConcurrentFixedSizeAllocator()
+{
+    // caches of other threads are dropped once they find this allocator gone.
+    thread_caches_.unregister();
+
+    link_ptr_type link = bundles_.pop_all();
+    while (link)
+    {
+        LockFreeLinkPolicy::link_type* link_ptr = LockFreeLinkPolicy::deref_link(link);
+        link_ptr_type next = link_ptr->single_next;
+        link_ptr->payload = nullptr;
+        link_ptr->single_next = 0;
+        LockFreeLinkPolicy::free_lock_free_link(link);
+        link = next;
+    }
+}
+
+void* ConcurrentFixedSizeAllocator::allocate()
+{
+    cache_type* cache = get_cache();
+    if (!cache)
+    {
+        block_type* bundle = acquire_bundle();
+        if (bundle->next)
+        {
+            push_bundle(bundle->next);
+        }
+        return bundle;
+    }
+
+    if (!cache->blocks)
+    {
+        cache->blocks = cache->spare ? cache->spare : acquire_bundle();
+        cache->spare = nullptr;
+        cache->count = bundle_size;
+    }
+
+    block_type* block = cache->blocks;
+    cache->blocks = block->next;
+    cache->count -= cache->count > 0;
+    return block;
+}
+
+void ConcurrentFixedSizeAllocator::deallocate(void* ptr)
+{
+    ASSERT(ptr);
+    block_type* block = static_cast<block_type*>(ptr);
+    cache_type* cache = get_cache();
+    if (!cache)
+    {
+        block->next = nullptr;
+        push_bundle(block);
+        return;
+    }
+
+    block->next = cache->blocks;
+    cache->blocks = block;
+    if (++cache->count >= bundle_size)
+    {
+        if (cache->spare)
+        {
+            push_bundle(cache->spare);
+        }
+        cache->spare = cache->blocks;
+        cache->blocks = nullptr;
+        cache->count = 0;
+    }
+}
+
+ConcurrentFixedSizeAllocator::cache_type* ConcurrentFixedSizeAllocator::get_cache()
+{
+    if (cache_type* cache = thread_caches_.find())
+    {
+        return cache;
+    }
+
+    // blocks of an exited thread go straight to the shared list.
+    if (thread_caches_type::is_thread_exited())
+    {
+        return nullptr;
+    }
+    // caches are flushed into bundles_ when the thread exits, so the thread cache of lock free links must be
+    // constructed before the exit guard of the registry to be destroyed after it.
+    LockFreeLinkPolicy::ensure_thread_cache();
+    return thread_caches_.claim(true);
+}
+
+ConcurrentFixedSizeAllocator::block_type* ConcurrentFixedSizeAllocator::acquire_bundle()
+{
+    if (link_ptr_type link = bundles_.pop())
+    {
+        LockFreeLinkPolicy::link_type* link_ptr = LockFreeLinkPolicy::deref_link(link);
+        block_type* bundle = static_cast<block_type*>(link_ptr->payload);
+        link_ptr->payload = nullptr;
+        LockFreeLinkPolicy::free_lock_free_link(link);
+        return bundle;
+    }
+
+    block_type* bundle = nullptr;
+    std::lock_guard lock(mutex_);
+    for (uint32 i = 0; i < bundle_size; ++i)
+    {
+        block_type* block = static_cast<block_type*>(pages_.allocate());
+        block->next = bundle;
+        bundle = block;
+    }
+    return bundle;
+}
+
+void ConcurrentFixedSizeAllocator::push_bundle(block_type* bundle)
+{
+    link_ptr_type link = LockFreeLinkPolicy::alloc_lock_free_link();
+    LockFreeLinkPolicy::deref_link(link)->payload = bundle;
+    bundles_.push(link);
+}
+
+void ConcurrentFixedSizeAllocator::release_thread_slot(cache_type& cache)
+{
+    if (cache.blocks)
+    {
+        push_bundle(cache.blocks);
+    }
+    if (cache.spare)
+    {
+        push_bundle(cache.spare);
+    }
+}
+
+}// namespace atlas
@@ -0,0 +1,652 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#include "memory/thread_caching_malloc.hpp"
+#include "assertion.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct ThreadCachingBlock
+{
+    ThreadCachingBlock* next;
+};
+
+struct ThreadCachingPage
+{
+    /** Blocks ready to be allocated, only touched by the owner. */
+    ThreadCachingBlock* free{ nullptr };
+    /** Blocks freed by the owner, moved to free once it is empty. */
+    ThreadCachingBlock* local_free{ nullptr };
+    /** Blocks freed by other threads. */
+    std::atomic<ThreadCachingBlock*> thread_free{ nullptr };
+    /** Owner of the page, null while the page is abandoned or unassigned. */
+    std::atomic<ThreadCachingHeap*> heap{ nullptr };
+    ThreadCachingPage* prev{ nullptr };
+    ThreadCachingPage* next{ nullptr };
+    byte* start{ nullptr };
+    uint32 block_size{ 0 };
+    uint32 capacity{ 0 };
+    /** Blocks carved from the page so far, the rest of the page is never touched until needed. */
+    uint32 reserved{ 0 };
+    /** Blocks handed out and not collected back yet. */
+    uint32 used{ 0 };
+    uint32 size_class{ 0 };
+};
+
+/**
+ * @brief Header of a segment, it occupies the first page of the segment.
+ */
+struct ThreadCachingSegment
+{
+    static constexpr uint32 page_count = ThreadCachingMalloc::segment_size / ThreadCachingMalloc::page_size;
+
+    ThreadCachingPage pages[page_count];
+};
+
+static_assert(sizeof(ThreadCachingSegment) <= ThreadCachingMalloc::page_size);
+
+struct ThreadCachingHeap : public SystemNewDeleteObject
+{
+    /** Pages of each size class, the head is the page allocated from. */
+    ThreadCachingPage* pages[ThreadCachingMalloc::size_class_count]{};
+    ThreadCachingPage* tails[ThreadCachingMalloc::size_class_count]{};
+    /** Empty pages kept for the next size class that runs out of blocks. */
+    ThreadCachingPage* free_pages{ nullptr };
+    uint32 free_page_count{ 0 };
+    ThreadCachingHeap* prev{ nullptr };
+    ThreadCachingHeap* next{ nullptr };
+};
+
+}// namespace details
+
+using details::ThreadCachingBlock;
+using details::ThreadCachingPage;
+using details::ThreadCachingSegment;
+using details::ThreadCachingHeap;
+
+/** Size classes are spaced by 16 bytes up to 128 bytes, then by a quarter of their power of two. */
+static constexpr uint32 get_class_block_size(uint32 size_class)
+{
+    if (size_class < 8)
+    {
+        return (size_class + 1) * 16;
+    }
+    const uint32 shift = 7 + (size_class - 8) / 4;
+    return (1u << shift) + ((size_class - 8) % 4 + 1) * (1u << (shift - 2));
+}
+
+static constexpr uint32 get_size_class(size_t size)
+{
+    if (size <= 128)
+    {
+        return size == 0 ? 0 : static_cast<uint32>((size + 15) / 16 - 1);
+    }
+    const uint32 shift = static_cast<uint32>(std::bit_width(size - 1)) - 1;
+    return 8 + (shift - 7) * 4 + static_cast<uint32>((size - 1) >> (shift - 2)) - 4;
+}
+
+static_assert(get_class_block_size(ThreadCachingMalloc::size_class_count - 1) == ThreadCachingMalloc::max_small_size);
+static_assert(get_size_class(ThreadCachingMalloc::max_small_size) == ThreadCachingMalloc::size_class_count - 1);
+static_assert(get_size_class(129) == 8 && get_class_block_size(8) == 160);
+static_assert(get_size_class(257) == 12 && get_class_block_size(12) == 320);
+
+/** Empty pages a heap keeps before handing them back to the allocator. */
+static constexpr uint32 max_heap_free_pages = 4;
+/** Pages inspected before a heap takes a fresh page, full pages are rotated to the back. */
+static constexpr uint32 max_page_scan = 8;
+
+static void push_page(ThreadCachingPage*& head, ThreadCachingPage*& tail, ThreadCachingPage* page)
+{
+    page->prev = nullptr;
+    page->next = head;
+    if (head)
+    {
+        head->prev = page;
+    }
+    else
+    {
+        tail = page;
+    }
+    head = page;
+}
+
+static void unlink_page(ThreadCachingPage*& head, ThreadCachingPage*& tail, ThreadCachingPage* page)
+{
+    if (page->prev)
+    {
+        page->prev->next = page->next;
+    }
+    else
+    {
+        head = page->next;
+    }
+    if (page->next)
+    {
+        page->next->prev = page->prev;
+    }
+    else
+    {
+        tail = page->prev;
+    }
+    page->prev = page->next = nullptr;
+}
+
+static void* allocate_block(ThreadCachingPage* page)
+{
+    if (ThreadCachingBlock* block = page->free)
+    {
+        page->free = block->next;
+        ++page->used;
+        return block;
+    }
+    if (page->reserved < page->capacity)
+    {
+        void* block = page->start + static_cast<size_t>(page->reserved) * page->block_size;
+        ++page->reserved;
+        ++page->used;
+        return block;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Moves blocks freed by the owner and by other threads to the free list, only called once it is empty.
+ */
+static void collect_page(ThreadCachingPage* page)
+{
+    ASSERT(!page->free);
+    page->free = std::exchange(page->local_free, nullptr);
+
+    ThreadCachingBlock* remote = page->thread_free.exchange(nullptr, std::memory_order_acquire);
+    if (!remote)
+    {
+        return;
+    }
+    uint32 count = 1;
+    ThreadCachingBlock* tail = remote;
+    while (tail->next)
+    {
+        tail = tail->next;
+        ++count;
+    }
+    tail->next = page->free;
+    page->free = remote;
+    page->used -= count;
+}
+
+static void format_page(ThreadCachingPage* page, ThreadCachingHeap* heap, uint32 size_class)
+{
+    page->free = nullptr;
+    page->local_free = nullptr;
+    page->block_size = get_class_block_size(size_class);
+    page->capacity = static_cast<uint32>(ThreadCachingMalloc::page_size / page->block_size);
+    page->reserved = 0;
+    page->used = 0;
+    page->size_class = size_class;
+    page->heap.store(heap, std::memory_order_release);
+}
+
+static uint32 hash_segment(uintptr_t segment, uint32 table_size)
+{
+    return static_cast<uint32>(((segment / ThreadCachingMalloc::segment_size) * 0x9E3779B97F4A7C15ull) >> 32) & (table_size - 1);
+}
+
+ThreadCachingMalloc::ThreadCachingMalloc(MallocBase* fallback)
+    : fallback_(fallback)
+    , thread_heaps_(this)
+{
+    ASSERT(fallback_);
+}
+
+ThreadCachingMalloc::~ThreadCachingMalloc()
+{
+    thread_heaps_.unregister();
+
+    while (heaps_)
+    {
+        delete std::exchange(heaps_, heaps_->next);
+    }
+    for (auto&& entry : segment_table_)
+    {
+        if (uintptr_t segment = entry.load(std::memory_order_relaxed))
+        {
+            fallback_->aligned_free(reinterpret_cast<void*>(segment));
+        }
+    }
+}
+
+void* ThreadCachingMalloc::malloc(size_t size)
+{
+    if (size <= max_small_size)
+    {
+        if (heap_type* heap = get_heap())
+        {
+            if (void* block = malloc_small(heap, get_size_class(size)))
+            {
+                return block;
+            }
+        }
+    }
+    return fallback_->malloc(size);
+}
+
+void* ThreadCachingMalloc::aligned_malloc(size_t size, size_t alignment)
+{
+    // never forwards to malloc, a large block must come from fallback aligned_malloc to match aligned_free.
+    if (size <= max_small_size && alignment <= max_small_size)
+    {
+        if (heap_type* heap = get_heap())
+        {
+            // blocks start at a multiple of their size from an aligned page, a power of two class is always found.
+            uint32 size_class = get_size_class(std::max(size, alignment));
+            while (get_class_block_size(size_class) % alignment != 0)
+            {
+                ++size_class;
+            }
+            if (void* block = malloc_small(heap, size_class))
+            {
+                return block;
+            }
+        }
+    }
+    return fallback_->aligned_malloc(size, alignment);
+}
+
+void* ThreadCachingMalloc::realloc(void* ptr, size_t new_size)
+{
+    if (!ptr)
+    {
+        return malloc(new_size);
+    }
+
+    segment_type* segment = find_segment(ptr);
+    if (!segment)
+    {
+        return fallback_->realloc(ptr, new_size);
+    }
+
+    const size_t block_size = segment->pages[(static_cast<byte*>(ptr) - reinterpret_cast<byte*>(segment)) / page_size].block_size;
+    // shrinking keeps the block unless most of it would be wasted.
+    if (new_size <= block_size && new_size > block_size / 2)
+    {
+        return ptr;
+    }
+
+    void* new_ptr = malloc(new_size);
+    if (new_ptr)
+    {
+        std::memcpy(new_ptr, ptr, std::min(block_size, new_size));
+        free_small(segment, ptr);
+    }
+    return new_ptr;
+}
+
+void* ThreadCachingMalloc::aligned_realloc(void* ptr, size_t new_size, size_t alignment)
+{
+    if (!ptr)
+    {
+        return aligned_malloc(new_size, alignment);
+    }
+
+    segment_type* segment = find_segment(ptr);
+    if (!segment)
+    {
+        return fallback_->aligned_realloc(ptr, new_size, alignment);
+    }
+
+    const size_t block_size = segment->pages[(static_cast<byte*>(ptr) - reinterpret_cast<byte*>(segment)) / page_size].block_size;
+    if (new_size <= block_size && new_size > block_size / 2 && reinterpret_cast<uintptr_t>(ptr) % alignment == 0)
+    {
+        return ptr;
+    }
+
+    void* new_ptr = aligned_malloc(new_size, alignment);
+    if (new_ptr)
+    {
+        std::memcpy(new_ptr, ptr, std::min(block_size, new_size));
+        free_small(segment, ptr);
+    }
+    return new_ptr;
+}
+
+void ThreadCachingMalloc::free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    if (segment_type* segment = find_segment(ptr))
+    {
+        free_small(segment, ptr);
+    }
+    else
+    {
+        fallback_->free(ptr);
+    }
+}
+
+void ThreadCachingMalloc::aligned_free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    if (segment_type* segment = find_segment(ptr))
+    {
+        free_small(segment, ptr);
+    }
+    else
+    {
+        fallback_->aligned_free(ptr);
+    }
+}
+
+size_t ThreadCachingMalloc::usable_size(void* ptr)
+{
+    if (!ptr)
+    {
+        return 0;
+    }
+
+    segment_type* segment = find_segment(ptr);
+    if (!segment)
+    {
+        return fallback_->usable_size(ptr);
+    }
+    return segment->pages[(static_cast<byte*>(ptr) - reinterpret_cast<byte*>(segment)) / page_size].block_size;
+}
+
+bool ThreadCachingMalloc::try_expand_in_place(void* ptr, size_t new_size)
+{
+    if (ptr && !find_segment(ptr))
+    {
+        return fallback_->try_expand_in_place(ptr, new_size);
+    }
+    return MallocBase::try_expand_in_place(ptr, new_size);
+}
+
+bool ThreadCachingMalloc::owns(const void* ptr) const
+{
+    return ptr && find_segment(ptr);
+}
+
+ThreadCachingMalloc::heap_type* ThreadCachingMalloc::find_heap() const
+{
+    heap_type** slot = thread_heaps_.find();
+    return slot ? *slot : nullptr;
+}
+
+ThreadCachingMalloc::heap_type* ThreadCachingMalloc::get_heap()
+{
+    if (heap_type* heap = find_heap())
+    {
+        return heap;
+    }
+
+    // allocations of an exited thread, or of a thread using too many allocators, go to the fallback.
+    heap_type** slot = thread_heaps_.claim(false);
+    if (!slot)
+    {
+        return nullptr;
+    }
+
+    auto heap = new heap_type();
+    {
+        std::lock_guard lock(mutex_);
+        heap->next = heaps_;
+        if (heaps_)
+        {
+            heaps_->prev = heap;
+        }
+        heaps_ = heap;
+    }
+    *slot = heap;
+    return heap;
+}
+
+void* ThreadCachingMalloc::malloc_small(heap_type* heap, uint32 size_class)
+{
+    if (page_type* page = heap->pages[size_class])
+    {
+        if (void* block = allocate_block(page))
+        {
+            return block;
+        }
+    }
+    return malloc_slow(heap, size_class);
+}
+
+void* ThreadCachingMalloc::malloc_slow(heap_type* heap, uint32 size_class)
+{
+    // collects blocks freed since, pages that are still full are rotated to the back.
+    for (uint32 i = 0; i < max_page_scan; ++i)
+    {
+        page_type* page = heap->pages[size_class];
+        if (!page)
+        {
+            break;
+        }
+
+        collect_page(page);
+        if (void* block = allocate_block(page))
+        {
+            return block;
+        }
+        if (!page->next)
+        {
+            break;
+        }
+        unlink_page(heap->pages[size_class], heap->tails[size_class], page);
+        page->prev = heap->tails[size_class];
+        heap->tails[size_class]->next = page;
+        heap->tails[size_class] = page;
+    }
+
+    page_type* page = acquire_page(heap, size_class);
+    if (!page)
+    {
+        return nullptr;
+    }
+    push_page(heap->pages[size_class], heap->tails[size_class], page);
+    return allocate_block(page);
+}
+
+ThreadCachingMalloc::page_type* ThreadCachingMalloc::acquire_page(heap_type* heap, uint32 size_class)
+{
+    if (page_type* page = heap->free_pages)
+    {
+        heap->free_pages = page->next;
+        --heap->free_page_count;
+        format_page(page, heap, size_class);
+        return page;
+    }
+
+    std::unique_lock lock(mutex_);
+    // adopts a page of an exited thread first, its blocks would never be reused otherwise.
+    if (page_type* page = abandoned_pages_[size_class])
+    {
+        abandoned_pages_[size_class] = page->next;
+        lock.unlock();
+        page->next = nullptr;
+        page->heap.store(heap, std::memory_order_release);
+        if (!page->free)
+        {
+            collect_page(page);
+        }
+        return page;
+    }
+
+    page_type* page = free_pages_;
+    if (page)
+    {
+        free_pages_ = page->next;
+    }
+    else
+    {
+        page = allocate_segment();
+    }
+    lock.unlock();
+
+    if (page)
+    {
+        format_page(page, heap, size_class);
+    }
+    return page;
+}
+
+void ThreadCachingMalloc::release_page(heap_type* heap, page_type* page)
+{
+    unlink_page(heap->pages[page->size_class], heap->tails[page->size_class], page);
+    page->heap.store(nullptr, std::memory_order_relaxed);
+    if (heap->free_page_count < max_heap_free_pages)
+    {
+        page->next = heap->free_pages;
+        heap->free_pages = page;
+        ++heap->free_page_count;
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+    page->next = free_pages_;
+    free_pages_ = page;
+}
+
+void ThreadCachingMalloc::free_small(segment_type* segment, void* ptr)
+{
+    page_type* page = &segment->pages[(static_cast<byte*>(ptr) - reinterpret_cast<byte*>(segment)) / page_size];
+    auto block = static_cast<ThreadCachingBlock*>(ptr);
+
+    // only the owner ever sees itself as the owner of a page, the heap of a thread is never shared.
+    heap_type* heap = find_heap();
+    if (heap && page->heap.load(std::memory_order_relaxed) == heap)
+    {
+        block->next = page->local_free;
+        page->local_free = block;
+        // an empty page goes back to the pool unless it is the last page of its size class.
+        if (--page->used == 0 && (page->prev || page->next))
+        {
+            release_page(heap, page);
+        }
+        return;
+    }
+
+    ThreadCachingBlock* head = page->thread_free.load(std::memory_order_relaxed);
+    do
+    {
+        block->next = head;
+    }
+    while (!page->thread_free.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+ThreadCachingMalloc::segment_type* ThreadCachingMalloc::find_segment(const void* ptr) const
+{
+    const uintptr_t segment = reinterpret_cast<uintptr_t>(ptr) & ~(static_cast<uintptr_t>(segment_size) - 1);
+    for (uint32 i = hash_segment(segment, segment_table_size);; i = (i + 1) & (segment_table_size - 1))
+    {
+        const uintptr_t entry = segment_table_[i].load(std::memory_order_acquire);
+        if (entry == segment)
+        {
+            return reinterpret_cast<segment_type*>(segment);
+        }
+        if (entry == 0)
+        {
+            return nullptr;
+        }
+    }
+}
+
+ThreadCachingMalloc::page_type* ThreadCachingMalloc::allocate_segment()
+{
+    // keeps the table half empty, so lookups of foreign blocks stop early.
+    if (segment_count_ >= max_segment_count)
+    {
+        return nullptr;
+    }
+
+    void* memory = fallback_->aligned_malloc(segment_size, segment_size);
+    if (!memory)
+    {
+        return nullptr;
+    }
+
+    auto segment = new (memory) segment_type();
+    auto base = static_cast<byte*>(memory);
+    // the first page holds the header, the second one is handed out.
+    for (uint32 i = segment_type::page_count - 1; i > 1; --i)
+    {
+        page_type* page = &segment->pages[i];
+        page->start = base + i * page_size;
+        page->next = free_pages_;
+        free_pages_ = page;
+    }
+    segment->pages[1].start = base + page_size;
+
+    const uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+    uint32 index = hash_segment(address, segment_table_size);
+    while (segment_table_[index].load(std::memory_order_relaxed) != 0)
+    {
+        index = (index + 1) & (segment_table_size - 1);
+    }
+    segment_table_[index].store(address, std::memory_order_release);
+    ++segment_count_;
+    return &segment->pages[1];
+}
+
+void ThreadCachingMalloc::abandon_heap(heap_type* heap)
+{
+    std::lock_guard lock(mutex_);
+    for (uint32 size_class = 0; size_class < size_class_count; ++size_class)
+    {
+        page_type* page = heap->pages[size_class];
+        while (page)
+        {
+            page_type* next = page->next;
+            page->prev = nullptr;
+            page->heap.store(nullptr, std::memory_order_release);
+            if (page->used == 0)
+            {
+                page->next = free_pages_;
+                free_pages_ = page;
+            }
+            else
+            {
+                page->next = abandoned_pages_[size_class];
+                abandoned_pages_[size_class] = page;
+            }
+            page = next;
+        }
+    }
+    while (page_type* page = heap->free_pages)
+    {
+        heap->free_pages = page->next;
+        page->next = free_pages_;
+        free_pages_ = page;
+    }
+
+    if (heap->prev)
+    {
+        heap->prev->next = heap->next;
+    }
+    else
+    {
+        heaps_ = heap->next;
+    }
+    if (heap->next)
+    {
+        heap->next->prev = heap->prev;
+    }
+    delete heap;
+}
+
+}// namespace atlas
@@ -0,0 +1,470 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include "memory/tracking_malloc.hpp"
+
+namespace atlas
+{
+
+namespace details
+{
+
+struct TrackingCounters
+{
+    std::atomic<uint64> allocated_bytes{ 0 };
+    std::atomic<uint64> freed_bytes{ 0 };
+    std::atomic<uint64> allocation_count{ 0 };
+    std::atomic<uint64> free_count{ 0 };
+    std::atomic<uint64> size_histogram[MemoryTagStats::histogram_bucket_count]{};
+    /** Bytes not applied to the live bytes of the tracker yet, only touched by the owner. */
+    int64 unflushed_bytes{ 0 };
+};
+
+/**
+ * @brief Counters of a thread, only written by the thread, reused by another thread once it exits.
+ */
+struct TrackingShard : public SystemNewDeleteObject
+{
+    TrackingCounters counters[MemoryScope::max_tag_count];
+    int64 unflushed_total_bytes{ 0 };
+    bool in_use{ true };
+    TrackingShard* next{ nullptr };
+};
+
+}// namespace details
+
+using details::TrackingCounters;
+using details::TrackingShard;
+
+/**
+ * @brief Prepended to every block, right before the pointer handed out.
+ */
+struct alignas(16) TrackingHeader
+{
+    uint64 size;
+    uint32 tag;
+    /** Distance from the block of the inner allocator to the pointer handed out. */
+    uint32 offset;
+};
+
+static_assert(sizeof(TrackingHeader) == 16);
+
+static TrackingHeader* get_header(void* ptr)
+{
+    return static_cast<TrackingHeader*>(ptr) - 1;
+}
+
+static void* init_header(void* block, size_t size, uint32 tag, uint32 offset)
+{
+    void* ptr = static_cast<byte*>(block) + offset;
+    *get_header(ptr) = { size, tag, offset };
+    return ptr;
+}
+
+static uint32 get_histogram_bucket(size_t size)
+{
+    const int32 bucket = size > 16 ? static_cast<int32>(std::bit_width(size - 1)) - 4 : 0;
+    return static_cast<uint32>(std::min<int32>(bucket, MemoryTagStats::histogram_bucket_count - 1));
+}
+
+/** Counters of a shard are written by a single thread, which saves a locked instruction. */
+static void add_counter(std::atomic<uint64>& counter, uint64 value)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+static void update_peak(std::atomic<int64>& peak, int64 live)
+{
+    int64 current = peak.load(std::memory_order_relaxed);
+    while (live > current && !peak.compare_exchange_weak(current, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+static thread_local uint32 t_memory_tag = MemoryScope::untagged;
+
+static std::mutex g_tag_mutex;
+static const char* g_tag_names[MemoryScope::max_tag_count] = { "untagged" };
+static std::atomic<uint32> g_tag_count{ 1 };
+
+MemoryScope::MemoryScope(const char* name) : previous_tag_(t_memory_tag)
+{
+    t_memory_tag = get_tag(name);
+}
+
+MemoryScope::~MemoryScope()
+{
+    t_memory_tag = previous_tag_;
+}
+
+uint32 MemoryScope::get_current_tag()
+{
+    return t_memory_tag;
+}
+
+uint32 MemoryScope::get_tag(const char* name)
+{
+    uint32 count = g_tag_count.load(std::memory_order_acquire);
+    for (uint32 tag = 1; tag < count; ++tag)
+    {
+        if (g_tag_names[tag] == name || std::strcmp(g_tag_names[tag], name) == 0)
+        {
+            return tag;
+        }
+    }
+
+    std::lock_guard lock(g_tag_mutex);
+    for (uint32 tag = count; tag < g_tag_count.load(std::memory_order_relaxed); ++tag)
+    {
+        if (std::strcmp(g_tag_names[tag], name) == 0)
+        {
+            return tag;
+        }
+    }
+
+    count = g_tag_count.load(std::memory_order_relaxed);
+    if (count == max_tag_count)
+    {
+        return untagged;
+    }
+    g_tag_names[count] = name;
+    g_tag_count.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+const char* MemoryScope::get_tag_name(uint32 tag)
+{
+    return tag < g_tag_count.load(std::memory_order_acquire) ? g_tag_names[tag] : nullptr;
+}
+
+uint32 MemoryScope::get_tag_count()
+{
+    return g_tag_count.load(std::memory_order_acquire);
+}
+
+String MemoryStats::to_json() const
+{
+    auto out = fmt::memory_buffer();
+    auto format_tag = [&out](const MemoryTagStats& stats) {
+        fmt::format_to(std::back_inserter(out),
+            R"({{"name":"{}","live_bytes":{},"peak_bytes":{},"allocation_count":{},"free_count":{},"size_histogram":[)",
+            stats.name, stats.live_bytes, stats.peak_bytes, stats.allocation_count, stats.free_count);
+        for (uint32 bucket = 0; bucket < MemoryTagStats::histogram_bucket_count; ++bucket)
+        {
+            fmt::format_to(std::back_inserter(out), "{}{}", bucket > 0 ? "," : "", stats.size_histogram[bucket]);
+        }
+        fmt::format_to(std::back_inserter(out), "]}}");
+    };
+
+    fmt::format_to(std::back_inserter(out), R"({{"total":)");
+    format_tag(total);
+    fmt::format_to(std::back_inserter(out), R"(,"tags":[)");
+    for (size_t i = 0; i < tags.size(); ++i)
+    {
+        if (i > 0)
+        {
+            out.push_back(',');
+        }
+        format_tag(tags[i]);
+    }
+    fmt::format_to(std::back_inserter(out), "]}}");
+    return { out.data(), static_cast<String::size_type>(out.size()) };
+}
+
+TrackingMalloc::TrackingMalloc(MallocBase* inner)
+    : inner_(inner)
+    , thread_shards_(this)
+{
+    ASSERT(inner_);
+    // never handed to a thread, so it is always in use.
+    shared_shard_ = new TrackingShard();
+    shards_ = shared_shard_;
+}
+
+TrackingMalloc::~TrackingMalloc()
+{
+    thread_shards_.unregister();
+
+    while (shards_)
+    {
+        delete std::exchange(shards_, shards_->next);
+    }
+}
+
+void* TrackingMalloc::malloc(size_t size)
+{
+    void* block = inner_->malloc(size + sizeof(TrackingHeader));
+    if (!block)
+    {
+        return nullptr;
+    }
+    const uint32 tag = t_memory_tag;
+    on_allocated(size, tag);
+    return init_header(block, size, tag, sizeof(TrackingHeader));
+}
+
+void* TrackingMalloc::aligned_malloc(size_t size, size_t alignment)
+{
+    // the header takes a whole alignment unit, so the pointer handed out stays aligned.
+    const uint32 offset = static_cast<uint32>(std::max(alignment, sizeof(TrackingHeader)));
+    void* block = inner_->aligned_malloc(size + offset, alignment);
+    if (!block)
+    {
+        return nullptr;
+    }
+    const uint32 tag = t_memory_tag;
+    on_allocated(size, tag);
+    return init_header(block, size, tag, offset);
+}
+
+void* TrackingMalloc::realloc(void* ptr, size_t new_size)
+{
+    if (!ptr)
+    {
+        return malloc(new_size);
+    }
+
+    // a block keeps the tag it was allocated with.
+    const TrackingHeader header = *get_header(ptr);
+    ASSERT(header.offset == sizeof(TrackingHeader));
+    void* block = inner_->realloc(static_cast<byte*>(ptr) - header.offset, new_size + header.offset);
+    if (!block)
+    {
+        return nullptr;
+    }
+    on_freed(header.size, header.tag);
+    on_allocated(new_size, header.tag);
+    return init_header(block, new_size, header.tag, header.offset);
+}
+
+void* TrackingMalloc::aligned_realloc(void* ptr, size_t new_size, size_t alignment)
+{
+    if (!ptr)
+    {
+        return aligned_malloc(new_size, alignment);
+    }
+
+    const TrackingHeader header = *get_header(ptr);
+    ASSERT(header.offset == std::max(alignment, sizeof(TrackingHeader)));
+    void* block = inner_->aligned_realloc(static_cast<byte*>(ptr) - header.offset, new_size + header.offset, alignment);
+    if (!block)
+    {
+        return nullptr;
+    }
+    on_freed(header.size, header.tag);
+    on_allocated(new_size, header.tag);
+    return init_header(block, new_size, header.tag, header.offset);
+}
+
+size_t TrackingMalloc::usable_size(void* ptr)
+{
+    if (!ptr)
+    {
+        return 0;
+    }
+
+    const TrackingHeader* header = get_header(ptr);
+    const size_t size = inner_->usable_size(static_cast<byte*>(ptr) - header->offset);
+    return size > header->offset ? size - header->offset : 0;
+}
+
+bool TrackingMalloc::try_expand_in_place(void* ptr, size_t new_size)
+{
+    if (!ptr)
+    {
+        return false;
+    }
+
+    TrackingHeader* header = get_header(ptr);
+    if (!inner_->try_expand_in_place(static_cast<byte*>(ptr) - header->offset, new_size + header->offset))
+    {
+        return false;
+    }
+    on_freed(header->size, header->tag);
+    on_allocated(new_size, header->tag);
+    header->size = new_size;
+    return true;
+}
+
+void TrackingMalloc::free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    const TrackingHeader header = *get_header(ptr);
+    on_freed(header.size, header.tag);
+    inner_->free(static_cast<byte*>(ptr) - header.offset);
+}
+
+void TrackingMalloc::aligned_free(void* ptr)
+{
+    if (!ptr)
+    {
+        return;
+    }
+
+    const TrackingHeader header = *get_header(ptr);
+    on_freed(header.size, header.tag);
+    inner_->aligned_free(static_cast<byte*>(ptr) - header.offset);
+}
+
+MemoryStats TrackingMalloc::get_stats() const
+{
+    // sums up under the lock without allocating, this tracker may be the one that serves the allocation.
+    MemoryTagStats tag_stats[MemoryScope::max_tag_count];
+    const uint32 tag_count = MemoryScope::get_tag_count();
+    {
+        std::lock_guard lock(mutex_);
+        for (const TrackingShard* shard = shards_; shard; shard = shard->next)
+        {
+            for (uint32 tag = 0; tag < tag_count; ++tag)
+            {
+                const TrackingCounters& counters = shard->counters[tag];
+                MemoryTagStats& stats = tag_stats[tag];
+                stats.live_bytes += static_cast<int64>(counters.allocated_bytes.load(std::memory_order_relaxed));
+                stats.live_bytes -= static_cast<int64>(counters.freed_bytes.load(std::memory_order_relaxed));
+                stats.allocation_count += counters.allocation_count.load(std::memory_order_relaxed);
+                stats.free_count += counters.free_count.load(std::memory_order_relaxed);
+                for (uint32 bucket = 0; bucket < MemoryTagStats::histogram_bucket_count; ++bucket)
+                {
+                    stats.size_histogram[bucket] += counters.size_histogram[bucket].load(std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+
+    MemoryStats result;
+    result.total.name = "total";
+    for (uint32 tag = 0; tag < tag_count; ++tag)
+    {
+        MemoryTagStats& stats = tag_stats[tag];
+        stats.name = MemoryScope::get_tag_name(tag);
+        stats.peak_bytes = std::max(peak_bytes_[tag].load(std::memory_order_relaxed), stats.live_bytes);
+
+        result.total.live_bytes += stats.live_bytes;
+        result.total.allocation_count += stats.allocation_count;
+        result.total.free_count += stats.free_count;
+        for (uint32 bucket = 0; bucket < MemoryTagStats::histogram_bucket_count; ++bucket)
+        {
+            result.total.size_histogram[bucket] += stats.size_histogram[bucket];
+        }
+        result.tags.add(stats);
+    }
+    result.total.peak_bytes = std::max(peak_total_bytes_.load(std::memory_order_relaxed), result.total.live_bytes);
+    return result;
+}
+
+TrackingMalloc::shard_type* TrackingMalloc::get_shard()
+{
+    if (shard_type** slot = thread_shards_.find())
+    {
+        return *slot;
+    }
+
+    shard_type** slot = thread_shards_.claim(false);
+    if (!slot)
+    {
+        return nullptr;
+    }
+
+    TrackingShard* shard = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        for (shard = shards_; shard && shard->in_use; shard = shard->next)
+        {
+        }
+        if (shard)
+        {
+            shard->in_use = true;
+        }
+        else
+        {
+            shard = new TrackingShard();
+            shard->next = shards_;
+            shards_ = shard;
+        }
+    }
+    *slot = shard;
+    return shard;
+}
+
+void TrackingMalloc::release_thread_slot(shard_type*& shard)
+{
+    for (uint32 tag = 0; tag < MemoryScope::max_tag_count; ++tag)
+    {
+        flush(shard, tag);
+    }
+    std::lock_guard lock(mutex_);
+    shard->in_use = false;
+}
+
+void TrackingMalloc::on_allocated(size_t size, uint32 tag)
+{
+    shard_type* shard = get_shard();
+    if (!shard)
+    {
+        // an exited thread, or a thread using too many trackers, counts through the shared shard.
+        TrackingCounters& counters = shared_shard_->counters[tag];
+        counters.allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        counters.allocation_count.fetch_add(1, std::memory_order_relaxed);
+        counters.size_histogram[get_histogram_bucket(size)].fetch_add(1, std::memory_order_relaxed);
+        update_peak(peak_bytes_[tag], flushed_bytes_[tag].fetch_add(static_cast<int64>(size), std::memory_order_relaxed) + static_cast<int64>(size));
+        update_peak(peak_total_bytes_, flushed_total_bytes_.fetch_add(static_cast<int64>(size), std::memory_order_relaxed) + static_cast<int64>(size));
+        return;
+    }
+
+    TrackingCounters& counters = shard->counters[tag];
+    add_counter(counters.allocated_bytes, size);
+    add_counter(counters.allocation_count, 1);
+    add_counter(counters.size_histogram[get_histogram_bucket(size)], 1);
+    counters.unflushed_bytes += static_cast<int64>(size);
+    shard->unflushed_total_bytes += static_cast<int64>(size);
+    if (counters.unflushed_bytes >= flush_threshold || shard->unflushed_total_bytes >= flush_threshold)
+    {
+        flush(shard, tag);
+    }
+}
+
+void TrackingMalloc::on_freed(size_t size, uint32 tag)
+{
+    shard_type* shard = get_shard();
+    if (!shard)
+    {
+        TrackingCounters& counters = shared_shard_->counters[tag];
+        counters.freed_bytes.fetch_add(size, std::memory_order_relaxed);
+        counters.free_count.fetch_add(1, std::memory_order_relaxed);
+        flushed_bytes_[tag].fetch_sub(static_cast<int64>(size), std::memory_order_relaxed);
+        flushed_total_bytes_.fetch_sub(static_cast<int64>(size), std::memory_order_relaxed);
+        return;
+    }
+
+    TrackingCounters& counters = shard->counters[tag];
+    add_counter(counters.freed_bytes, size);
+    add_counter(counters.free_count, 1);
+    counters.unflushed_bytes -= static_cast<int64>(size);
+    shard->unflushed_total_bytes -= static_cast<int64>(size);
+    if (counters.unflushed_bytes <= -flush_threshold || shard->unflushed_total_bytes <= -flush_threshold)
+    {
+        flush(shard, tag);
+    }
+}
+
+void TrackingMalloc::flush(shard_type* shard, uint32 tag)
+{
+    if (const int64 delta = std::exchange(shard->counters[tag].unflushed_bytes, 0))
+    {
+        update_peak(peak_bytes_[tag], flushed_bytes_[tag].fetch_add(delta, std::memory_order_relaxed) + delta);
+    }
+    if (const int64 delta = std::exchange(shard->unflushed_total_bytes, 0))
+    {
+        update_peak(peak_total_bytes_, flushed_total_bytes_.fetch_add(delta, std::memory_order_relaxed) + delta);
+    }
+}
+
+}// namespace atlas
@@ -136,7 +136,7 @@ Property* MetaClass::find_property(StringName name, bool exclude_base) const
     const MetaClass* search_class = this;
     while (!!search_class)
     {
-        size_t idx = search_class->properties_.find([=](Property* prop) { return prop->name() == name; });
+        size_t idx = search_class->property_names_.find(name);
         if (idx != INDEX_NONE)
         {
             return search_class->properties_[idx];
@@ -167,13 +167,9 @@ Method* MetaClass::find_method(StringName name, bool exclude_base) const
         return nullptr;
     }
 
+    if (auto cached = methods_cache_.find_value(name))
     {
-        std::shared_lock lock(method_mutex_);
-        auto it = methods_cache_.find(name);
-        if (it != methods_cache_.end())
-        {
-            return it->second;
-        }
+        return *cached;
     }
 
     if (!interfaces_.is_empty())
@@ -183,7 +179,6 @@ Method* MetaClass::find_method(StringName name, bool exclude_base) const
             Method* method = i->find_method(name);
             if (!!method)
             {
-                std::unique_lock lock(method_mutex_);
                 methods_cache_.insert(name, method);
                 return method;
             }
@@ -195,7 +190,6 @@ Method* MetaClass::find_method(StringName name, bool exclude_base) const
         Method* method = base_->find_method(name);
         if (!!method)
         {
-            std::unique_lock lock(method_mutex_);
             methods_cache_.insert(name, method);
             return method;
         }
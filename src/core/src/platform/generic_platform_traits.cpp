@@ -1,6 +1,8 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include <thread>
+
 #include "platform/generic_platform_traits.hpp"
 
 namespace atlas
@@ -35,6 +37,23 @@ const Path& GenericPlatformTraits::get_relative_build_directory()
     return relative_path;
 }
 
+const CpuTopology& GenericPlatformTraits::get_cpu_topology()
+{
+    static CpuTopology topology = []() {
+        CpuTopology result;
+        const uint32 count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            result.processors.add({ .index = i, .core_id = i });
+        }
+        result.physical_core_count = count;
+        result.numa_node_count = 1;
+        result.l3_cache_count = 1;
+        return result;
+    }();
+    return topology;
+}
+
 Path GenericPlatformTraits::get_library_path(const Path& module_dir, StringName lib_name)
 {
 #if DEBUG
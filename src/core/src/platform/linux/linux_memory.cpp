@@ -0,0 +1,145 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "memory/memory.hpp"
+
+#ifndef MAP_HUGE_2MB
+#   define MAP_HUGE_2MB (21 << 26)
+#endif
+
+namespace atlas
+{
+
+/** Prefers the given nodes and falls back to others when they run out of memory, see set_mempolicy(2). */
+static constexpr int mpol_preferred = 1;
+static constexpr uint32 max_numa_node_count = 1024;
+
+size_t LinuxMemory::get_page_size()
+{
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+void* LinuxMemory::reserve(size_t size, EHugePages huge_pages, uint32 numa_node)
+{
+    ASSERT(size > 0 && size == get_reserve_size(size, huge_pages));
+
+    void* ptr = nullptr;
+    if (huge_pages == EHugePages::Explicit)
+    {
+        // huge pages are taken from the pool at once, touching a range reserved with MAP_NORESERVE would raise SIGBUS
+        // once the pool runs out.
+        ptr = ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            // the huge page pool is empty or not configured.
+            ptr = nullptr;
+            huge_pages = EHugePages::Transparent;
+        }
+    }
+
+    if (!ptr)
+    {
+        // over reserves and trims both ends, so the range is aligned to the reserve granularity.
+        const size_t alignment = get_reserve_size(1, huge_pages);
+        const size_t padded_size = size + alignment;
+        void* padded = ::mmap(nullptr, padded_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (padded == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        const uintptr_t begin = reinterpret_cast<uintptr_t>(padded);
+        const uintptr_t aligned = (begin + alignment - 1) & ~(alignment - 1);
+        if (aligned > begin)
+        {
+            ::munmap(padded, aligned - begin);
+        }
+        if (begin + padded_size > aligned + size)
+        {
+            ::munmap(reinterpret_cast<void*>(aligned + size), begin + padded_size - aligned - size);
+        }
+        ptr = reinterpret_cast<void*>(aligned);
+
+        if (huge_pages == EHugePages::Transparent)
+        {
+            ::madvise(ptr, size, MADV_HUGEPAGE);
+        }
+    }
+
+    if (numa_node != any_numa_node)
+    {
+        bind_numa_node(ptr, size, numa_node);
+    }
+    return ptr;
+}
+
+bool LinuxMemory::commit(void* ptr, size_t size, bool prefault)
+{
+    if (::mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+    {
+        return false;
+    }
+
+    if (prefault)
+    {
+#ifdef MADV_POPULATE_WRITE
+        if (::madvise(ptr, size, MADV_POPULATE_WRITE) == 0)
+        {
+            return true;
+        }
+#endif
+        // kernels before 5.14 have no MADV_POPULATE_WRITE, writes a byte of every page instead.
+        const size_t page_size = get_page_size();
+        for (size_t offset = 0; offset < size; offset += page_size)
+        {
+            static_cast<volatile char*>(ptr)[offset] = 0;
+        }
+    }
+    return true;
+}
+
+void LinuxMemory::decommit(void* ptr, size_t size)
+{
+    ::madvise(ptr, size, MADV_DONTNEED);
+    ::mprotect(ptr, size, PROT_NONE);
+}
+
+void LinuxMemory::release(void* ptr, size_t size)
+{
+    if (ptr)
+    {
+        ::munmap(ptr, size);
+    }
+}
+
+bool LinuxMemory::bind_numa_node(void* ptr, size_t size, uint32 numa_node)
+{
+    if (numa_node >= max_numa_node_count)
+    {
+        return false;
+    }
+
+    constexpr uint32 bits_per_word = sizeof(unsigned long) * 8;
+    unsigned long node_mask[max_numa_node_count / bits_per_word] = {};
+    node_mask[numa_node / bits_per_word] = 1ul << (numa_node % bits_per_word);
+    // mbind is called through syscall, so libnuma is not required.
+    return ::syscall(SYS_mbind, ptr, size, mpol_preferred, node_mask, max_numa_node_count + 1, 0) == 0;
+}
+
+uint32 LinuxMemory::get_current_numa_node()
+{
+    unsigned int cpu = 0;
+    unsigned int node = 0;
+    if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    {
+        return 0;
+    }
+    return node;
+}
+
+}// namespace atlas
@@ -0,0 +1,240 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <dlfcn.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "platform/linux/linux_platform_traits.hpp"
+#include "string/string_name.hpp"
+#include "core_log.hpp"
+
+namespace atlas
+{
+
+void* LinuxPlatformTraits::load_library(const Path& path)
+{
+    auto&& sys_path = path.to_os_path();
+    void* handle = ::dlopen(sys_path.data(), RTLD_LAZY);
+    if (handle == nullptr)
+    {
+        LOG_ERROR(core, "Load library {0} failed. {1}", path, ::dlerror());
+    }
+    return handle;
+}
+
+void LinuxPlatformTraits::free_library(void* module_handle)
+{
+    ASSERT(module_handle);
+    dlclose(module_handle);
+}
+
+void* LinuxPlatformTraits::get_exported_symbol(void* handle, const String& symbol_name)
+{
+    return dlsym(handle, symbol_name.data());
+}
+
+Path LinuxPlatformTraits::get_library_path(const Path& module_dir, StringName lib_name)
+{
+#if DEBUG
+    return module_dir / String::format("lib{0}d.so", lib_name.to_lexical());
+#else
+    return module_dir / String::format("lib{0}.so", lib_name.to_lexical());
+#endif
+}
+
+void LinuxPlatformTraits::set_thread_name(void* thread_handle, const String& name)
+{
+    // the kernel limits thread names to 16 bytes including the terminator.
+    char truncated[16] = {};
+    std::memcpy(truncated, name.data(), std::min<size_t>(name.size(), sizeof(truncated) - 1));
+    ::pthread_setname_np(reinterpret_cast<pthread_t>(thread_handle), truncated);
+}
+
+void* LinuxPlatformTraits::get_this_thread_handle()
+{
+    return reinterpret_cast<void*>(::pthread_self());
+}
+
+bool LinuxPlatformTraits::set_thread_affinity(void* thread_handle, std::span<const uint32> processors)
+{
+    if (processors.empty())
+    {
+        return false;
+    }
+
+    const uint32 max_processor = *std::max_element(processors.begin(), processors.end());
+    cpu_set_t* cpu_set = CPU_ALLOC(max_processor + 1);
+    const size_t set_size = CPU_ALLOC_SIZE(max_processor + 1);
+    CPU_ZERO_S(set_size, cpu_set);
+    for (uint32 processor : processors)
+    {
+        CPU_SET_S(processor, set_size, cpu_set);
+    }
+
+    const int32 error = ::pthread_setaffinity_np(reinterpret_cast<pthread_t>(thread_handle), set_size, cpu_set);
+    CPU_FREE(cpu_set);
+    if (error != 0)
+    {
+        LOG_WARN(core, "Failed to set thread affinity, error code: {0}", error);
+    }
+    return error == 0;
+}
+
+bool LinuxPlatformTraits::set_thread_priority(void* thread_handle, EThreadPriority priority)
+{
+    // threads stay SCHED_OTHER and only get another nice value, real time policies could starve the system.
+    int32 nice_value = 0;
+    switch (priority)
+    {
+        case EThreadPriority::Lowest:
+            nice_value = 19;
+            break;
+        case EThreadPriority::BelowNormal:
+            nice_value = 10;
+            break;
+        case EThreadPriority::Normal:
+            break;
+        case EThreadPriority::AboveNormal:
+            nice_value = -5;
+            break;
+        case EThreadPriority::Highest:
+            nice_value = -10;
+            break;
+        default:
+            std::unreachable();
+    }
+
+    // the nice value is per thread, but only the kernel id of the calling thread is known.
+    if (!::pthread_equal(reinterpret_cast<pthread_t>(thread_handle), ::pthread_self()))
+    {
+        LOG_WARN(core, "Failed to set thread priority, a thread can only change its own priority");
+        return false;
+    }
+
+    // a negative nice value needs CAP_SYS_NICE or a raised RLIMIT_NICE.
+    if (::setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), nice_value) != 0)
+    {
+        LOG_WARN(core, "Failed to set thread priority, error code: {0}", errno);
+        return false;
+    }
+    return true;
+}
+
+static bool read_sysfs_uint(const std::filesystem::path& path, uint32& out_value)
+{
+    std::ifstream stream(path);
+    return static_cast<bool>(stream >> out_value);
+}
+
+/**
+ * @brief Parses a cpu list such as "0-3,8,10-11".
+ */
+static Array<uint32> parse_cpu_list(const std::string& list)
+{
+    Array<uint32> result;
+    size_t pos = 0;
+    while (pos < list.size())
+    {
+        size_t next = list.find(',', pos);
+        if (next == std::string::npos)
+        {
+            next = list.size();
+        }
+
+        const std::string range = list.substr(pos, next - pos);
+        const size_t dash = range.find('-');
+        const uint32 first = static_cast<uint32>(std::stoul(range.substr(0, dash)));
+        const uint32 last = dash == std::string::npos ? first : static_cast<uint32>(std::stoul(range.substr(dash + 1)));
+        for (uint32 cpu = first; cpu <= last; ++cpu)
+        {
+            result.add(cpu);
+        }
+        pos = next + 1;
+    }
+    return result;
+}
+
+static CpuTopology query_cpu_topology()
+{
+    const std::filesystem::path cpu_root = "/sys/devices/system/cpu";
+
+    std::string online_list;
+    if (std::ifstream online(cpu_root / "online"); !(online >> online_list))
+    {
+        return GenericPlatformTraits::get_cpu_topology();
+    }
+
+    CpuTopology topology;
+    Array<uint64> cores;
+    Array<uint32> numa_nodes;
+    Array<uint32> l3_caches;
+    for (uint32 cpu : parse_cpu_list(online_list))
+    {
+        const std::filesystem::path cpu_dir = cpu_root / ("cpu" + std::to_string(cpu));
+        ProcessorInfo info{ .index = cpu };
+        read_sysfs_uint(cpu_dir / "topology" / "core_id", info.core_id);
+        read_sysfs_uint(cpu_dir / "topology" / "physical_package_id", info.package_id);
+
+        // older kernels have no cache id, the package is the best guess then.
+        if (!read_sysfs_uint(cpu_dir / "cache" / "index3" / "id", info.l3_cache_id))
+        {
+            info.l3_cache_id = info.package_id;
+        }
+
+        std::error_code error;
+        for (auto&& entry : std::filesystem::directory_iterator(cpu_dir, error))
+        {
+            const std::string file_name = entry.path().filename().string();
+            if (file_name.starts_with("node") && file_name.size() > 4 && std::isdigit(file_name[4]))
+            {
+                info.numa_node = static_cast<uint32>(std::stoul(file_name.substr(4)));
+                break;
+            }
+        }
+
+        const uint64 core_key = (static_cast<uint64>(info.package_id) << 32) | info.core_id;
+        if (std::find(cores.begin(), cores.end(), core_key) == cores.end())
+        {
+            cores.add(core_key);
+        }
+        if (std::find(numa_nodes.begin(), numa_nodes.end(), info.numa_node) == numa_nodes.end())
+        {
+            numa_nodes.add(info.numa_node);
+        }
+        if (std::find(l3_caches.begin(), l3_caches.end(), info.l3_cache_id) == l3_caches.end())
+        {
+            l3_caches.add(info.l3_cache_id);
+        }
+        topology.processors.add(info);
+    }
+
+    if (topology.processors.is_empty())
+    {
+        return GenericPlatformTraits::get_cpu_topology();
+    }
+
+    topology.physical_core_count = static_cast<uint32>(cores.size());
+    topology.numa_node_count = static_cast<uint32>(numa_nodes.size());
+    topology.l3_cache_count = static_cast<uint32>(l3_caches.size());
+    return topology;
+}
+
+const CpuTopology& LinuxPlatformTraits::get_cpu_topology()
+{
+    static CpuTopology topology = query_cpu_topology();
+    return topology;
+}
+
+} // namespace atlas
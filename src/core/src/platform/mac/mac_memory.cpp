@@ -0,0 +1,76 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "memory/memory.hpp"
+
+namespace atlas
+{
+
+size_t MacMemory::get_page_size()
+{
+    static const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+void* MacMemory::reserve(size_t size, EHugePages huge_pages, uint32 numa_node)
+{
+    ASSERT(size > 0 && size == get_reserve_size(size, huge_pages));
+
+    // there are neither huge pages for user space nor NUMA nodes, only the alignment is honored.
+    const size_t alignment = get_reserve_size(1, huge_pages);
+    const size_t padded_size = size + alignment;
+    void* padded = ::mmap(nullptr, padded_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (padded == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(padded);
+    const uintptr_t aligned = (begin + alignment - 1) & ~(alignment - 1);
+    if (aligned > begin)
+    {
+        ::munmap(padded, aligned - begin);
+    }
+    if (begin + padded_size > aligned + size)
+    {
+        ::munmap(reinterpret_cast<void*>(aligned + size), begin + padded_size - aligned - size);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+bool MacMemory::commit(void* ptr, size_t size, bool prefault)
+{
+    if (::mprotect(ptr, size, PROT_READ | PROT_WRITE) != 0)
+    {
+        return false;
+    }
+
+    if (prefault)
+    {
+        const size_t page_size = get_page_size();
+        for (size_t offset = 0; offset < size; offset += page_size)
+        {
+            static_cast<volatile char*>(ptr)[offset] = 0;
+        }
+    }
+    return true;
+}
+
+void MacMemory::decommit(void* ptr, size_t size)
+{
+    ::madvise(ptr, size, MADV_FREE);
+    ::mprotect(ptr, size, PROT_NONE);
+}
+
+void MacMemory::release(void* ptr, size_t size)
+{
+    if (ptr)
+    {
+        ::munmap(ptr, size);
+    }
+}
+
+}// namespace atlas
@@ -0,0 +1,87 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include "memory/memory.hpp"
+#include "platform/windows/windows_minimal_api.hpp"
+
+namespace atlas
+{
+
+size_t WindowsMemory::get_page_size()
+{
+    static const size_t page_size = []() {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+    }();
+    return page_size;
+}
+
+void* WindowsMemory::reserve(size_t size, EHugePages huge_pages, uint32 numa_node)
+{
+    ASSERT(size > 0 && size == get_reserve_size(size, huge_pages));
+
+    const DWORD preferred_node = numa_node == any_numa_node ? NUMA_NO_PREFERRED_NODE : numa_node;
+    if (huge_pages == EHugePages::Explicit && ::GetLargePageMinimum() > 0 && size % ::GetLargePageMinimum() == 0)
+    {
+        // large pages are committed at once and can't be decommitted, they require SeLockMemoryPrivilege.
+        void* ptr = ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                         PAGE_READWRITE, preferred_node);
+        if (ptr)
+        {
+            return ptr;
+        }
+    }
+
+    // there are no transparent huge pages, reserves are aligned to the allocation granularity of 64KB.
+    return ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, size, MEM_RESERVE, PAGE_NOACCESS, preferred_node);
+}
+
+bool WindowsMemory::commit(void* ptr, size_t size, bool prefault)
+{
+    // large pages were committed by reserve.
+    MEMORY_BASIC_INFORMATION info;
+    const bool committed = ::VirtualQuery(ptr, &info, sizeof(info)) && info.State == MEM_COMMIT
+        && info.RegionSize >= size;
+    if (!committed && !::VirtualAlloc(ptr, size, MEM_COMMIT, PAGE_READWRITE))
+    {
+        return false;
+    }
+
+    if (prefault)
+    {
+        const size_t page_size = get_page_size();
+        for (size_t offset = 0; offset < size; offset += page_size)
+        {
+            static_cast<volatile char*>(ptr)[offset] = 0;
+        }
+    }
+    return true;
+}
+
+void WindowsMemory::decommit(void* ptr, size_t size)
+{
+    ::VirtualFree(ptr, size, MEM_DECOMMIT);
+}
+
+void WindowsMemory::release(void* ptr, size_t size)
+{
+    if (ptr)
+    {
+        ::VirtualFree(ptr, 0, MEM_RELEASE);
+    }
+}
+
+uint32 WindowsMemory::get_current_numa_node()
+{
+    PROCESSOR_NUMBER processor;
+    ::GetCurrentProcessorNumberEx(&processor);
+    USHORT node = 0;
+    if (!::GetNumaProcessorNodeEx(&processor, &node))
+    {
+        return 0;
+    }
+    return node;
+}
+
+}// namespace atlas
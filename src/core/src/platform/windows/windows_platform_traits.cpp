@@ -8,6 +8,7 @@
 #include "string/string_name.hpp"
 #include "utility/guid.hpp"
 
+#include <algorithm>
 #include <combaseapi.h>
 #if WITH_CRASH_HANDLER
 #include <dbghelp.h>
@@ -57,6 +58,161 @@ void* WindowsPlatformTraits::get_this_thread_handle()
     return ::GetCurrentThread();
 }
 
+bool WindowsPlatformTraits::set_thread_affinity(void* thread_handle, std::span<const uint32> processors)
+{
+    if (processors.empty())
+    {
+        return false;
+    }
+
+    GROUP_AFFINITY affinity{};
+    affinity.Group = static_cast<WORD>(processors[0] / 64);
+    for (uint32 processor : processors)
+    {
+        if (processor / 64 == affinity.Group)
+        {
+            affinity.Mask |= KAFFINITY(1) << (processor % 64);
+        }
+    }
+
+    if (!::SetThreadGroupAffinity(thread_handle, &affinity, nullptr))
+    {
+        LOG_WARN(core, "Failed to set thread affinity, error code: {0}", ::GetLastError());
+        return false;
+    }
+    return true;
+}
+
+bool WindowsPlatformTraits::set_thread_priority(void* thread_handle, EThreadPriority priority)
+{
+    int32 value = THREAD_PRIORITY_NORMAL;
+    switch (priority)
+    {
+        case EThreadPriority::Lowest:
+            value = THREAD_PRIORITY_LOWEST;
+            break;
+        case EThreadPriority::BelowNormal:
+            value = THREAD_PRIORITY_BELOW_NORMAL;
+            break;
+        case EThreadPriority::Normal:
+            break;
+        case EThreadPriority::AboveNormal:
+            value = THREAD_PRIORITY_ABOVE_NORMAL;
+            break;
+        case EThreadPriority::Highest:
+            value = THREAD_PRIORITY_HIGHEST;
+            break;
+        default:
+            std::unreachable();
+    }
+
+    if (!::SetThreadPriority(thread_handle, value))
+    {
+        LOG_WARN(core, "Failed to set thread priority, error code: {0}", ::GetLastError());
+        return false;
+    }
+    return true;
+}
+
+template<typename Fn>
+static void for_each_processor(const GROUP_AFFINITY* masks, WORD mask_count, Fn&& fn)
+{
+    for (WORD i = 0; i < mask_count; ++i)
+    {
+        for (uint32 bit = 0; bit < 64; ++bit)
+        {
+            if (masks[i].Mask & (KAFFINITY(1) << bit))
+            {
+                fn(masks[i].Group * 64u + bit);
+            }
+        }
+    }
+}
+
+static CpuTopology query_cpu_topology()
+{
+    DWORD length = 0;
+    ::GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+    Array<uint8> buffer;
+    buffer.resize(length);
+    auto info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+    if (length == 0 || !::GetLogicalProcessorInformationEx(RelationAll, info, &length))
+    {
+        return GenericPlatformTraits::get_cpu_topology();
+    }
+
+    CpuTopology topology;
+    auto find_processor = [&topology](uint32 index) -> ProcessorInfo& {
+        for (auto&& processor : topology.processors)
+        {
+            if (processor.index == index)
+            {
+                return processor;
+            }
+        }
+        return topology.processors[topology.processors.emplace(ProcessorInfo{ .index = index })];
+    };
+
+    uint32 package_count = 0;
+    for (DWORD offset = 0; offset < length; offset += info->Size)
+    {
+        info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+        switch (info->Relationship)
+        {
+            case RelationProcessorCore:
+            {
+                const uint32 core_id = topology.physical_core_count++;
+                for_each_processor(info->Processor.GroupMask, info->Processor.GroupCount, [&](uint32 index) {
+                    find_processor(index).core_id = core_id;
+                });
+                break;
+            }
+            case RelationProcessorPackage:
+            {
+                const uint32 package_id = package_count++;
+                for_each_processor(info->Processor.GroupMask, info->Processor.GroupCount, [&](uint32 index) {
+                    find_processor(index).package_id = package_id;
+                });
+                break;
+            }
+            case RelationNumaNode:
+            {
+                topology.numa_node_count++;
+                for_each_processor(&info->NumaNode.GroupMask, 1, [&](uint32 index) {
+                    find_processor(index).numa_node = info->NumaNode.NodeNumber;
+                });
+                break;
+            }
+            case RelationCache:
+            {
+                if (info->Cache.Level == 3)
+                {
+                    const uint32 l3_cache_id = topology.l3_cache_count++;
+                    for_each_processor(&info->Cache.GroupMask, 1, [&](uint32 index) {
+                        find_processor(index).l3_cache_id = l3_cache_id;
+                    });
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    std::sort(topology.processors.begin(), topology.processors.end(), [](const ProcessorInfo& lhs, const ProcessorInfo& rhs) {
+        return lhs.index < rhs.index;
+    });
+    topology.numa_node_count = std::max(topology.numa_node_count, 1u);
+    topology.l3_cache_count = std::max(topology.l3_cache_count, 1u);
+    return topology;
+}
+
+const CpuTopology& WindowsPlatformTraits::get_cpu_topology()
+{
+    static CpuTopology topology = query_cpu_topology();
+    return topology;
+}
+
 ESystemMsgBoxReturnType WindowsPlatformTraits::show_message_box(ESystemMsgBoxType type, const String& caption, const String& message)
 {
     switch (type)
@@ -18,7 +18,7 @@ void BinaryArchiveWriter::write_bytes(const byte* bytes, size_t byte_size)
     {
         if (write_position_ + byte_size > size)
         {
-            buffer_.resize(write_position_ + byte_size);
+            buffer_.resize_uninitialized(write_position_ + byte_size);
         }
         std::memmove(buffer_.data() + write_position_, bytes, byte_size);
         write_position_ += byte_size;
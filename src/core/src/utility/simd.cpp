@@ -0,0 +1,486 @@
+// Copyright(c) 2023-present, Atlas.
+// Distributed under the MIT License (http://opensource.org/licenses/MIT)
+
+#include <bit>
+
+#include "utility/simd.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_X86 1
+#include <immintrin.h>
+#if defined(COMPILER_MSVC)
+#include <intrin.h>
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace atlas::simd
+{
+
+template<typename Lane>
+static size_t find_scalar(const Lane* data, size_t first, size_t last, Lane value)
+{
+    for (size_t i = first; i < last; ++i)
+    {
+        if (data[i] == value)
+        {
+            return i;
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+template<typename Lane>
+static size_t find_last_scalar(const Lane* data, size_t first, size_t last, Lane value)
+{
+    for (size_t i = last; i > first; --i)
+    {
+        if (data[i - 1] == value)
+        {
+            return i - 1;
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+/**
+ * @brief Converts the highest set bit of a byte mask, BitsPerByte bits for every byte of a vector, to a lane index.
+ */
+template<typename Lane, uint32 BitsPerByte, typename Mask>
+static size_t last_lane(Mask mask)
+{
+    return (sizeof(Mask) * 8 - 1 - std::countl_zero(mask)) / (sizeof(Lane) * BitsPerByte);
+}
+
+template<typename Lane, uint32 BitsPerByte, typename Mask>
+static size_t first_lane(Mask mask)
+{
+    return std::countr_zero(mask) / (sizeof(Lane) * BitsPerByte);
+}
+
+#if SIMD_X86
+
+template<typename Lane>
+static __m128i splat_sse2(Lane value)
+{
+    if constexpr (sizeof(Lane) == 1)
+    {
+        return _mm_set1_epi8(static_cast<char>(value));
+    }
+    else if constexpr (sizeof(Lane) == 2)
+    {
+        return _mm_set1_epi16(static_cast<short>(value));
+    }
+    else if constexpr (sizeof(Lane) == 4)
+    {
+        return _mm_set1_epi32(static_cast<int>(value));
+    }
+    else
+    {
+        return _mm_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+template<typename Lane>
+static uint32 match_sse2(const Lane* data, __m128i needle)
+{
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i equal;
+    if constexpr (sizeof(Lane) == 1)
+    {
+        equal = _mm_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(Lane) == 2)
+    {
+        equal = _mm_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(Lane) == 4)
+    {
+        equal = _mm_cmpeq_epi32(block, needle);
+    }
+    else
+    {
+        // sse2 has no 64 bit compare, both halves of a lane have to match.
+        equal = _mm_cmpeq_epi32(block, needle);
+        equal = _mm_and_si128(equal, _mm_shuffle_epi32(equal, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    return static_cast<uint32>(_mm_movemask_epi8(equal));
+}
+
+template<typename Lane>
+static size_t find_sse2(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 16 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_scalar(data, 0, count, value);
+    }
+
+    const __m128i needle = splat_sse2(value);
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes)
+    {
+        if (const uint32 mask = match_sse2(data + i, needle))
+        {
+            return i + first_lane<Lane, 1>(mask);
+        }
+    }
+    // the last vector overlaps lanes already searched, which can not match.
+    if (i < count)
+    {
+        if (const uint32 mask = match_sse2(data + count - lanes, needle))
+        {
+            return count - lanes + first_lane<Lane, 1>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+template<typename Lane>
+static size_t find_last_sse2(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 16 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_last_scalar(data, 0, count, value);
+    }
+
+    const __m128i needle = splat_sse2(value);
+    size_t i = count;
+    for (; i >= lanes; i -= lanes)
+    {
+        if (const uint32 mask = match_sse2(data + i - lanes, needle))
+        {
+            return i - lanes + last_lane<Lane, 1>(mask);
+        }
+    }
+    if (i > 0)
+    {
+        if (const uint32 mask = match_sse2(data, needle))
+        {
+            return last_lane<Lane, 1>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+template<typename Lane>
+SIMD_TARGET_AVX2 static __m256i splat_avx2(Lane value)
+{
+    if constexpr (sizeof(Lane) == 1)
+    {
+        return _mm256_set1_epi8(static_cast<char>(value));
+    }
+    else if constexpr (sizeof(Lane) == 2)
+    {
+        return _mm256_set1_epi16(static_cast<short>(value));
+    }
+    else if constexpr (sizeof(Lane) == 4)
+    {
+        return _mm256_set1_epi32(static_cast<int>(value));
+    }
+    else
+    {
+        return _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+}
+
+template<typename Lane>
+SIMD_TARGET_AVX2 static __m256i compare_avx2(const Lane* data, __m256i needle)
+{
+    const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    if constexpr (sizeof(Lane) == 1)
+    {
+        return _mm256_cmpeq_epi8(block, needle);
+    }
+    else if constexpr (sizeof(Lane) == 2)
+    {
+        return _mm256_cmpeq_epi16(block, needle);
+    }
+    else if constexpr (sizeof(Lane) == 4)
+    {
+        return _mm256_cmpeq_epi32(block, needle);
+    }
+    else
+    {
+        return _mm256_cmpeq_epi64(block, needle);
+    }
+}
+
+template<typename Lane>
+SIMD_TARGET_AVX2 static uint32 match_avx2(const Lane* data, __m256i needle)
+{
+    return static_cast<uint32>(_mm256_movemask_epi8(compare_avx2(data, needle)));
+}
+
+template<typename Lane>
+SIMD_TARGET_AVX2 static size_t find_avx2(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 32 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_sse2(data, count, value);
+    }
+
+    const __m256i needle = splat_avx2(value);
+    size_t i = 0;
+    // two vectors per iteration, tested with a single branch.
+    for (; i + 2 * lanes <= count; i += 2 * lanes)
+    {
+        const __m256i equal_low = compare_avx2(data + i, needle);
+        const __m256i equal_high = compare_avx2(data + i + lanes, needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(equal_low, equal_high), _mm256_or_si256(equal_low, equal_high)))
+        {
+            const uint64 mask = static_cast<uint32>(_mm256_movemask_epi8(equal_low)) |
+                                static_cast<uint64>(static_cast<uint32>(_mm256_movemask_epi8(equal_high))) << 32;
+            return i + first_lane<Lane, 1>(mask);
+        }
+    }
+    for (; i + lanes <= count; i += lanes)
+    {
+        if (const uint32 mask = match_avx2(data + i, needle))
+        {
+            return i + first_lane<Lane, 1>(mask);
+        }
+    }
+    if (i < count)
+    {
+        if (const uint32 mask = match_avx2(data + count - lanes, needle))
+        {
+            return count - lanes + first_lane<Lane, 1>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+template<typename Lane>
+SIMD_TARGET_AVX2 static size_t find_last_avx2(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 32 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_last_sse2(data, count, value);
+    }
+
+    const __m256i needle = splat_avx2(value);
+    size_t i = count;
+    for (; i >= lanes; i -= lanes)
+    {
+        if (const uint32 mask = match_avx2(data + i - lanes, needle))
+        {
+            return i - lanes + last_lane<Lane, 1>(mask);
+        }
+    }
+    if (i > 0)
+    {
+        if (const uint32 mask = match_avx2(data, needle))
+        {
+            return last_lane<Lane, 1>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+static bool has_avx2()
+{
+#if defined(COMPILER_MSVC)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    // the os must save the ymm registers on context switches.
+    constexpr int osxsave = 1 << 27;
+    if ((info[2] & osxsave) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif SIMD_NEON
+
+template<typename Lane>
+static uint8x16_t compare_neon(const Lane* data, Lane value)
+{
+    if constexpr (sizeof(Lane) == 1)
+    {
+        return vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data)), vdupq_n_u8(value));
+    }
+    else if constexpr (sizeof(Lane) == 2)
+    {
+        return vreinterpretq_u8_u16(vceqq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(data)), vdupq_n_u16(value)));
+    }
+    else if constexpr (sizeof(Lane) == 4)
+    {
+        return vreinterpretq_u8_u32(vceqq_u32(vld1q_u32(reinterpret_cast<const uint32_t*>(data)), vdupq_n_u32(value)));
+    }
+    else
+    {
+        return vreinterpretq_u8_u64(vceqq_u64(vld1q_u64(reinterpret_cast<const uint64_t*>(data)), vdupq_n_u64(value)));
+    }
+}
+
+/**
+ * @brief Neon has no movemask, narrowing every byte to 4 bits keeps the position of a match in a 64 bit mask.
+ */
+template<typename Lane>
+static uint64 match_neon(const Lane* data, Lane value)
+{
+    const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(compare_neon(data, value)), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+}
+
+template<typename Lane>
+static size_t find_neon(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 16 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_scalar(data, 0, count, value);
+    }
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes)
+    {
+        if (const uint64 mask = match_neon(data + i, value))
+        {
+            return i + first_lane<Lane, 4>(mask);
+        }
+    }
+    if (i < count)
+    {
+        if (const uint64 mask = match_neon(data + count - lanes, value))
+        {
+            return count - lanes + first_lane<Lane, 4>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+template<typename Lane>
+static size_t find_last_neon(const Lane* data, size_t count, Lane value)
+{
+    constexpr size_t lanes = 16 / sizeof(Lane);
+    if (count < lanes)
+    {
+        return find_last_scalar(data, 0, count, value);
+    }
+
+    size_t i = count;
+    for (; i >= lanes; i -= lanes)
+    {
+        if (const uint64 mask = match_neon(data + i - lanes, value))
+        {
+            return i - lanes + last_lane<Lane, 4>(mask);
+        }
+    }
+    if (i > 0)
+    {
+        if (const uint64 mask = match_neon(data, value))
+        {
+            return last_lane<Lane, 4>(mask);
+        }
+    }
+    return INDEX_NONE_ZU;
+}
+
+#endif
+
+EInstructionSet get_instruction_set()
+{
+#if SIMD_X86
+    static const EInstructionSet instruction_set = has_avx2() ? EInstructionSet::AVX2 : EInstructionSet::SSE2;
+    return instruction_set;
+#elif SIMD_NEON
+    return EInstructionSet::NEON;
+#else
+    return EInstructionSet::Scalar;
+#endif
+}
+
+template<typename Lane>
+static size_t find_impl(const Lane* data, size_t count, Lane value)
+{
+#if SIMD_X86
+    if (get_instruction_set() == EInstructionSet::AVX2)
+    {
+        return find_avx2(data, count, value);
+    }
+    return find_sse2(data, count, value);
+#elif SIMD_NEON
+    return find_neon(data, count, value);
+#else
+    return find_scalar(data, 0, count, value);
+#endif
+}
+
+template<typename Lane>
+static size_t find_last_impl(const Lane* data, size_t count, Lane value)
+{
+#if SIMD_X86
+    if (get_instruction_set() == EInstructionSet::AVX2)
+    {
+        return find_last_avx2(data, count, value);
+    }
+    return find_last_sse2(data, count, value);
+#elif SIMD_NEON
+    return find_last_neon(data, count, value);
+#else
+    return find_last_scalar(data, 0, count, value);
+#endif
+}
+
+size_t find(const uint8* data, size_t count, uint8 value)
+{
+    return find_impl(data, count, value);
+}
+
+size_t find(const uint16* data, size_t count, uint16 value)
+{
+    return find_impl(data, count, value);
+}
+
+size_t find(const uint32* data, size_t count, uint32 value)
+{
+    return find_impl(data, count, value);
+}
+
+size_t find(const uint64* data, size_t count, uint64 value)
+{
+    return find_impl(data, count, value);
+}
+
+size_t find_last(const uint8* data, size_t count, uint8 value)
+{
+    return find_last_impl(data, count, value);
+}
+
+size_t find_last(const uint16* data, size_t count, uint16 value)
+{
+    return find_last_impl(data, count, value);
+}
+
+size_t find_last(const uint32* data, size_t count, uint32 value)
+{
+    return find_last_impl(data, count, value);
+}
+
+size_t find_last(const uint64* data, size_t count, uint64 value)
+{
+    return find_last_impl(data, count, value);
+}
+
+}// namespace atlas::simd
@@ -104,10 +104,12 @@ Task<> PngImporter::import(const Path& file)
     int32 rowbytes = png_get_rowbytes(png_ptr, info_ptr);
 
     // Allocate the image_data as a big block, to be given to opengl
-    Array<png_byte> data(rowbytes * height);
+    Array<png_byte> data;
+    data.resize_uninitialized(rowbytes * height);
 
     // row_pointers is for pointing to image_data for reading the png with libpng
-    Array<png_bytep> row_pointers(height);
+    Array<png_bytep> row_pointers;
+    row_pointers.resize_uninitialized(height);
 
     // set the individual row_pointers to point at the correct offsets of image_data
     for (size_t i = 0; i < height; ++i)
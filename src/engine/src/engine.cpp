@@ -5,6 +5,7 @@
 
 #include "async/thread.hpp"
 #include "configuration/config_manager.hpp"
+#include "memory/memory_arena.hpp"
 #include "meta/meta_types.hpp"
 #include "meta/registration.hpp"
 #include "project.hpp"
@@ -54,7 +55,7 @@ void Engine::shutdown()
 
 void Engine::loop()
 {
-
+    FrameAllocator::get().begin_frame();
 }
 
 void Engine::update_tick_time()
@@ -20,6 +20,8 @@ void GameEngine::shutdown()
 
 void GameEngine::loop()
 {
+    base::loop();
+
     // Process system event first.
     update_tick_time();
 
@@ -4,6 +4,7 @@
 #include "gtest/gtest.h"
 
 #include "container/array.hpp"
+#include "string/string.hpp"
 
 namespace atlas::test
 {
@@ -95,7 +96,7 @@ TEST(ArrayTest, ArrayAdd)
         EXPECT_TRUE(array.add({1}) == 1 && array.size() == 2);
 
         PodStruct elems[2] = {{2}, {3}};
-        EXPECT_TRUE(array.append(elems) == 2 && array.size() == 4 && array.capacity() == 4);
+        EXPECT_TRUE(array.append(elems) == 2 && array.size() == 4 && array.capacity() >= 4);
 
         Array<PodStruct> array_2 = { {4}, {5} };
         array.append(array_2);
@@ -208,4 +209,157 @@ TEST(ArrayTest, ArrayRemove)
     }
 }
 
+TEST(ArrayTest, ArrayGrowInPlace)
+{
+    Array<int32> array;
+    array.reserve(5);
+    // the capacity covers the whole block the allocator handed out.
+    EXPECT_TRUE(array.capacity() >= 5);
+    EXPECT_TRUE(array.capacity() == Memory::usable_size(array.data()) / sizeof(int32));
+
+    const int32* data = array.data();
+    while (array.size() < array.capacity())
+    {
+        array.add(0);
+    }
+    EXPECT_TRUE(array.data() == data);
+}
+
+TEST(ArrayTest, ArrayAppendUninitialized)
+{
+    {
+        Array<int32> array = { 1, 2 };
+        array.resize_uninitialized(10);
+        EXPECT_TRUE(array.size() == 10 && array[1] == 2);
+        array.resize_uninitialized(1);
+        EXPECT_TRUE(array.size() == 1 && array[0] == 1);
+    }
+    {
+        Array<int32> array = { 1 };
+        auto index = array.append_with(3, [](int32* dst) {
+            for (int32 i = 0; i < 3; ++i)
+            {
+                dst[i] = i + 2;
+            }
+        });
+        EXPECT_TRUE(index == 1 && array.size() == 4 && array[3] == 4);
+
+        // a short write keeps only the written elements.
+        index = array.append_with(100, [](int32* dst) {
+            dst[0] = 5;
+            return 1;
+        });
+        EXPECT_TRUE(index == 4 && array.size() == 5 && array[4] == 5);
+    }
+    {
+        Array<NonPodStruct> array;
+        array.append_with(2, [](NonPodStruct* dst) {
+            new (dst) NonPodStruct("first");
+            new (dst + 1) NonPodStruct("second");
+        });
+        EXPECT_TRUE(array.size() == 2 && array[1].str == "second");
+    }
+}
+
+template<typename T>
+static void expect_search_matches_scalar(T value, T other)
+{
+    // every length up to a few vectors and every position of the first and last match.
+    for (size_t count = 0; count < 80; ++count)
+    {
+        for (size_t first = 0; first <= count; ++first)
+        {
+            Array<T> array;
+            for (size_t i = 0; i < count; ++i)
+            {
+                array.add(i == first || i == count - 1 - first / 2 ? value : other);
+            }
+            auto predicate = [value](const T& elem) { return elem == value; };
+            EXPECT_EQ(array.find(value), array.find(predicate));
+            EXPECT_EQ(array.find_last(value), array.find_last(predicate));
+
+            Array<T> expected = array;
+            EXPECT_EQ(array.remove_all(value), expected.remove_all(predicate));
+            EXPECT_EQ(array.size(), expected.size());
+            EXPECT_EQ(array.find(other), array.is_empty() ? INDEX_NONE_ZU : 0);
+        }
+    }
+}
+
+TEST(ArrayTest, ArrayFindSimd)
+{
+    expect_search_matches_scalar<uint8>(7, 8);
+    expect_search_matches_scalar<uint16>(0x107, 0x7);
+    expect_search_matches_scalar<int32>(-1, 0x7fffffff);
+    expect_search_matches_scalar<uint64>((1ull << 32) | 1, 1);
+    int32 a = 0, b = 0;
+    expect_search_matches_scalar<int32*>(&a, &b);
+
+    Array<int32> array = { 1, 2, 3, 2, 4, 2, 2, 5, 6, 7, 8, 9, 2, 10, 11, 12, 13, 14, 2 };
+    EXPECT_EQ(array.add_unique(14), 17);
+    EXPECT_EQ(array.remove_all(2), 6);
+    EXPECT_TRUE(array.size() == 13 && array[1] == 3 && array[3] == 5 && array[12] == 14);
+}
+
+struct MoveCounter
+{
+    MoveCounter() = default;
+    MoveCounter(const MoveCounter&) { ++copies; }
+    MoveCounter(MoveCounter&&) noexcept { ++moves; }
+    MoveCounter& operator=(const MoveCounter&) = default;
+    MoveCounter& operator=(MoveCounter&&) noexcept = default;
+    bool operator==(const MoveCounter&) const { return false; }
+
+    static inline int32 copies = 0;
+    static inline int32 moves = 0;
+};
+
+TEST(ArrayTest, ArrayRelocate)
+{
+    static_assert(is_trivially_relocatable_v<String>);
+    static_assert(is_trivially_relocatable_v<Array<String>>);
+    static_assert(!is_trivially_relocatable_v<NonPodStruct>);
+    static_assert(!is_trivially_relocatable_v<InlineArray<int32, 4>>);
+
+    {
+        Array<MoveCounter> array;
+        array.reserve(4);
+        MoveCounter counter;
+        array.add(std::move(counter));
+        array.add_unique(MoveCounter());
+        array.insert(array.cend(), MoveCounter());
+        EXPECT_TRUE(MoveCounter::moves == 3 && MoveCounter::copies == 0);
+    }
+    {
+        // long strings live on the heap and short ones inline, both have to survive growth and erasure.
+        Array<String> array;
+        for (int32 i = 0; i < 100; ++i)
+        {
+            array.add(i % 2 ? String::format("a string too long to be stored inline {}", i) : String::format("{}", i));
+        }
+        array.insert(array.cbegin() + 1, String("inserted"));
+        EXPECT_TRUE(array.size() == 101 && array[1] == "inserted" && array[2] == "a string too long to be stored inline 1");
+        array.remove_at(0, 2);
+        EXPECT_TRUE(array[0] == "a string too long to be stored inline 1" && array[1] == "2");
+        array.remove_at_swap(0);
+        EXPECT_TRUE(array[0] == "a string too long to be stored inline 99" && array[1] == "2");
+        EXPECT_EQ(array.remove_all([](const String& str) { return str.size() < 3; }), 49);
+        EXPECT_TRUE(array.size() == 49 && array[1] == "a string too long to be stored inline 3");
+
+        Array<String> other = { String("x"), String("a string too long to be stored inline") };
+        array.append(std::move(other));
+        EXPECT_TRUE(other.is_empty() && array.size() == 51 && array[50] == "a string too long to be stored inline");
+    }
+    {
+        Array<Array<String>> arrays;
+        for (int32 i = 0; i < 20; ++i)
+        {
+            Array<String> inner = { String::format("{}", i), String("a string too long to be stored inline") };
+            arrays.add(std::move(inner));
+        }
+        arrays.remove_at(0);
+        EXPECT_TRUE(arrays.size() == 19 && arrays[0][0] == "1" && arrays[18][1] == "a string too long to be stored inline");
+    }
+}
+
 }
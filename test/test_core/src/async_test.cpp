@@ -1,9 +1,19 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include "async/async_generator.hpp"
+#include "async/channel.hpp"
+#include "async/coroutine_frame_allocator.hpp"
+#include "async/parallel.hpp"
 #include "async/schedule_on.hpp"
 #include "async/static_thread_pool.hpp"
 #include "async/task.hpp"
+#include "async/task_graph.hpp"
+#include "async/thread_pool_scheduler.hpp"
+#include "async/timer_service.hpp"
+#include "async/when_all.hpp"
+#include "async/when_any.hpp"
+#include "async/work_stealing_thread_pool.hpp"
 #include "gtest/gtest.h"
 
 namespace atlas
@@ -82,6 +92,179 @@ TEST(AsyncTest, CancellationTask)
     task.wait();
 }
 
+TEST(AsyncTest, SleepFor)
+{
+    auto task = launch([]() -> Task<> {
+        const auto start = TimerClock::now();
+        EXPECT_TRUE(co_await co_sleep_for(20ms));
+        EXPECT_GE(TimerClock::now() - start, 20ms);
+        // lives in an upper level of the wheel before moving down.
+        EXPECT_TRUE(co_await co_sleep_until(TimerClock::now() + 150ms));
+        EXPECT_TRUE(co_await co_sleep_for(0ms));
+        co_return;
+    }());
+    task.wait();
+
+    StopSource source;
+    const auto start = TimerClock::now();
+    auto canceled = launch([]() -> Task<> {
+        EXPECT_FALSE(co_await co_sleep_for(1h));
+        co_return;
+    }(), source.get_token());
+    std::this_thread::sleep_for(10ms);
+    source.request_stop();
+    canceled.wait();
+    EXPECT_LT(TimerClock::now() - start, 1s);
+    // continuations never run on the timer thread.
+    ThreadPoolScheduler scheduler(1);
+    auto resumed = launch([](ThreadPoolScheduler& scheduler) -> Task<bool> {
+        EXPECT_TRUE(co_await co_sleep_for(1ms, scheduler));
+        co_return scheduler.is_in_worker_thread();
+    }(scheduler));
+    EXPECT_TRUE(resumed.get_result());
+}
+
+TEST(AsyncTest, TimerService)
+{
+    struct TestTimer final : public TimerNode
+    {
+        void on_fired(bool cancelled) override
+        {
+            EXPECT_FALSE(cancelled);
+            EXPECT_GE(TimerClock::now(), deadline);
+            fired->fetch_add(1, std::memory_order_release);
+            fired->notify_one();
+        }
+
+        TimerClock::time_point deadline;
+        std::atomic<int32>* fired{ nullptr };
+    };
+
+    constexpr int32 timer_count = 256;
+    std::atomic<int32> fired = 0;
+    auto timers = std::make_unique<TestTimer[]>(timer_count);
+    const auto now = TimerClock::now();
+    for (int32 i = 0; i < timer_count; ++i)
+    {
+        // spreads over the first two levels of the wheel, in shuffled order.
+        timers[i].deadline = now + std::chrono::milliseconds((i * 37) % 300);
+        timers[i].fired = &fired;
+        TimerService::get().schedule(&timers[i], timers[i].deadline);
+    }
+
+    // a cancelled timer never fires.
+    TestTimer cancelled;
+    TimerService::get().schedule(&cancelled, now + 1h);
+    EXPECT_TRUE(TimerService::get().cancel(&cancelled));
+    EXPECT_FALSE(TimerService::get().cancel(&cancelled));
+
+    for (int32 current = fired.load(std::memory_order_acquire); current < timer_count; current = fired.load(std::memory_order_acquire))
+    {
+        fired.wait(current, std::memory_order_acquire);
+    }
+    EXPECT_EQ(fired.load(), timer_count);
+}
+
+TEST(AsyncTest, WithTimeout)
+{
+    Task<int32> fast = []() -> Task<int32> { co_return 1; }();
+    Task<> slow = []() -> Task<> {
+        // the timeout requests stop, which cuts the sleep short.
+        EXPECT_FALSE(co_await co_sleep_for(1h));
+        co_return;
+    }();
+
+    auto task = launch([](Task<int32>& fast, Task<>& slow) -> Task<> {
+        EXPECT_TRUE(co_await with_timeout(fast, 1s));
+        EXPECT_EQ(fast.get_result(), 1);
+        // resumed on the scheduler of the timer service.
+        EXPECT_FALSE(co_await with_timeout(slow, 20ms));
+        co_return;
+    }(fast, slow));
+    task.wait();
+    slow.wait();
+}
+
+AsyncGenerator<int32> async_range(int32 count)
+{
+    for (int32 i = 0; i < count; ++i)
+    {
+        // awaits a task between values.
+        int32 value = co_await [](int32 v) -> Task<int32> { co_return v; }(i);
+        co_yield value;
+    }
+}
+
+TEST(AsyncTest, AsyncGenerator)
+{
+    auto task = launch([]() -> Task<int32> {
+        int32 sum = 0;
+        AsyncGenerator<int32> range = async_range(100);
+        while (int32* value = co_await range.next())
+        {
+            sum += *value;
+        }
+        EXPECT_TRUE(range.is_done());
+        EXPECT_EQ(co_await range.next(), nullptr);
+        co_return sum;
+    }());
+    EXPECT_EQ(task.get_result(), 4950);
+
+    // a generator destroyed before it finished releases its frame.
+    auto partial = launch([]() -> Task<> {
+        AsyncGenerator<int32> range = async_range(100);
+        EXPECT_EQ(*co_await range.next(), 0);
+        EXPECT_EQ(*co_await range.next(), 1);
+        co_return;
+    }());
+    partial.wait();
+}
+
+TEST(AsyncTest, Channel)
+{
+    ThreadPoolScheduler scheduler(2);
+    constexpr int32 value_count = 1000;
+    // woken coroutines continue on the scheduler.
+    Channel<int32> channel(4, &scheduler);
+
+    auto producer = launch([](ThreadPoolScheduler& scheduler, Channel<int32>& channel, int32 value_count) -> Task<> {
+        co_await co_schedule_on(scheduler);
+        for (int32 i = 0; i < value_count; ++i)
+        {
+            EXPECT_TRUE(co_await channel.send(i));
+        }
+        channel.close();
+        EXPECT_FALSE(co_await channel.send(0));
+        co_return;
+    }(scheduler, channel, value_count));
+
+    auto consumer = launch([](ThreadPoolScheduler& scheduler, Channel<int32>& channel) -> Task<int64> {
+        co_await co_schedule_on(scheduler);
+        int64 sum = 0;
+        int32 expected = 0;
+        while (std::optional<int32> value = co_await channel.receive())
+        {
+            EXPECT_EQ(*value, expected++);
+            sum += *value;
+        }
+        co_return sum;
+    }(scheduler, channel));
+
+    producer.wait();
+    EXPECT_EQ(consumer.get_result(), int64(value_count) * (value_count - 1) / 2);
+
+    // rendezvous channel hands values over directly.
+    Channel<int32> rendezvous(0);
+    int32 value = 1;
+    EXPECT_FALSE(rendezvous.try_send(value));
+    auto receiver = launch([](Channel<int32>& rendezvous) -> Task<int32> {
+        std::optional<int32> received = co_await rendezvous.receive();
+        co_return received.value_or(0);
+    }(rendezvous));
+    EXPECT_TRUE(rendezvous.try_send(value));
+    EXPECT_EQ(receiver.get_result(), 1);
+}
+
 TEST(AsyncTest, StaticThreadPool)
 {
     StaticThreadPool<2> thread_pool(2);
@@ -108,4 +291,362 @@ TEST(AsyncTest, StaticThreadPool)
     EXPECT_TRUE(i == 3);
 }
 
+TEST(AsyncTest, BoundedStaticThreadPool)
+{
+    StaticThreadPool<2, BoundedThreadPoolPolicy<4>> thread_pool(2);
+
+    constexpr int32 task_count = 1000;
+    std::atomic<int32> count = 0;
+    for (int32 i = 0; i < task_count; ++i)
+    {
+        // blocks while the queue is full.
+        thread_pool.push_task(i & 1, [&count]() {
+            count.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    while (count.load(std::memory_order_relaxed) < task_count)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(count.load(), task_count);
+}
+
+TEST(AsyncTest, ThreadAffinity)
+{
+    const CpuTopology& topology = Thread::get_cpu_topology();
+    ASSERT_FALSE(topology.processors.is_empty());
+    EXPECT_GE(topology.physical_core_count, 1u);
+    EXPECT_LE(topology.physical_core_count, topology.processors.size());
+    EXPECT_GE(topology.numa_node_count, 1u);
+    EXPECT_GE(topology.l3_cache_count, 1u);
+    EXPECT_EQ(topology.get_physical_core_processors().size(), topology.physical_core_count);
+
+    StaticThreadPool<1> thread_pool(4, ThreadAffinityPolicy::pin_to_physical_cores(EThreadPriority::BelowNormal));
+
+    constexpr int32 task_count = 100;
+    std::atomic<int32> count = 0;
+    for (int32 i = 0; i < task_count; ++i)
+    {
+        thread_pool.push_task([&count]() {
+            count.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    while (count.load(std::memory_order_relaxed) < task_count)
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(count.load(), task_count);
+
+    // every pool takes a policy, workers apply it to themselves.
+    ThreadPoolScheduler scheduler(2, ThreadAffinityPolicy{ EThreadAffinityMode::Shared, {}, EThreadPriority::BelowNormal });
+    auto task = launch([](ThreadPoolScheduler& scheduler) -> Task<bool> {
+        co_await co_schedule_on(scheduler);
+        co_return scheduler.is_in_worker_thread();
+    }(scheduler));
+    EXPECT_TRUE(task.get_result());
+
+#if PLATFORM_LINUX || PLATFORM_WINDOWS
+    // lowering the priority needs no privilege.
+    std::thread worker([]() {
+        EXPECT_TRUE(this_thread::set_priority(EThreadPriority::BelowNormal));
+    });
+    worker.join();
+#endif
+}
+
+TEST(AsyncTest, WorkStealingThreadPool)
+{
+    WorkStealingThreadPool<2> thread_pool(4);
+
+    constexpr int32 task_count = 1000;
+    std::atomic<int32> executed = 0;
+    std::atomic<int32> nested = 0;
+
+    for (int32 i = 0; i < task_count; ++i)
+    {
+        thread_pool.push_task(i % 2, [&]() {
+            executed.fetch_add(1);
+            // push from worker thread goes to the worker's own deque.
+            thread_pool.push_task(0, [&]() {
+                nested.fetch_add(1);
+            });
+        });
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while ((executed.load() < task_count || nested.load() < task_count) && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(executed.load(), task_count);
+    EXPECT_EQ(nested.load(), task_count);
+}
+
+Task<> resume_on_thread_pool(ThreadPoolScheduler& scheduler, std::atomic<int32>& resumed)
+{
+    co_await co_schedule_on(scheduler);
+    EXPECT_TRUE(scheduler.is_in_worker_thread());
+    // schedule from worker thread goes to the worker's own inbox.
+    co_await co_schedule_on(scheduler);
+    EXPECT_TRUE(scheduler.is_in_worker_thread());
+    resumed.fetch_add(1);
+    co_return;
+}
+
+TEST(AsyncTest, ThreadPoolScheduler)
+{
+    ThreadPoolScheduler scheduler(4);
+
+    constexpr int32 task_count = 1000;
+    std::atomic<int32> resumed = 0;
+
+    for (int32 i = 0; i < task_count; ++i)
+    {
+        launch(resume_on_thread_pool(scheduler, resumed));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (resumed.load() < task_count && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(resumed.load(), task_count);
+}
+
+Task<int32> chained_await(ThreadPoolScheduler& scheduler, int32 depth)
+{
+    if (depth == 0)
+    {
+        co_await co_schedule_on(scheduler);
+        co_return 0;
+    }
+    co_return co_await chained_await(scheduler, depth - 1) + 1;
+}
+
+TEST(AsyncTest, TaskCompletion)
+{
+    ThreadPoolScheduler scheduler(2);
+
+    Task<int32> task = launch(chained_await(scheduler, 100));
+    // blocks until a worker thread completes the chain.
+    EXPECT_EQ(task.get_result(), 100);
+
+    int32 invoked = 0;
+    task.then([&](int32 v) {
+        // already completed, callback is invoked immediately.
+        EXPECT_EQ(v, 100);
+        ++invoked;
+    });
+    EXPECT_EQ(invoked, 1);
+}
+
+Task<int32> synchronous_chain(int32 depth)
+{
+    if (depth == 0)
+    {
+        co_return 0;
+    }
+    co_return co_await synchronous_chain(depth - 1) + 1;
+}
+
+TEST(AsyncTest, DeepAwaitChain)
+{
+    // completes without suspending, would overflow the stack if every await resumed the next coroutine nested.
+    constexpr int32 depth = 100'000;
+    Task<int32> task = launch(synchronous_chain(depth));
+    EXPECT_EQ(task.get_result(), depth);
+}
+
+Task<int32> resume_value_on_thread_pool(ThreadPoolScheduler& scheduler, int32 value)
+{
+    co_await co_schedule_on(scheduler);
+    co_return value;
+}
+
+Task<> wait_stop_requested(ThreadPoolScheduler& scheduler)
+{
+    co_await co_schedule_on(scheduler);
+    StopToken token = co_await co_get_current_stop_token();
+    while (!token.stop_requested())
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    co_return;
+}
+
+TEST(AsyncTest, WhenAll)
+{
+    ThreadPoolScheduler scheduler(4);
+
+    auto task = launch([](ThreadPoolScheduler& scheduler) -> Task<int32> {
+        auto [a, b, c] = co_await when_all(
+            resume_value_on_thread_pool(scheduler, 1),
+            resume_value_on_thread_pool(scheduler, 2),
+            chained_await(scheduler, 3));
+        EXPECT_TRUE(scheduler.is_in_worker_thread());
+
+        Array<Task<int32>> tasks;
+        for (int32 i = 0; i < 64; ++i)
+        {
+            tasks.emplace(resume_value_on_thread_pool(scheduler, i));
+        }
+        Array<int32> results = co_await when_all(std::move(tasks));
+        int32 sum = 0;
+        for (int32 i = 0; i < results.size(); ++i)
+        {
+            EXPECT_EQ(results[i], i);
+            sum += results[i];
+        }
+
+        co_return a + b + c + sum;
+    }(scheduler));
+
+    EXPECT_EQ(task.get_result(), 1 + 2 + 3 + 63 * 64 / 2);
+}
+
+TEST(AsyncTest, WhenAny)
+{
+    ThreadPoolScheduler scheduler(2);
+    StopSource source;
+
+    auto task = launch([](ThreadPoolScheduler& scheduler) -> Task<size_t> {
+        Task<> slow = wait_stop_requested(scheduler);
+        Task<int32> fast = resume_value_on_thread_pool(scheduler, 5);
+        size_t first = co_await when_any(slow, fast);
+        EXPECT_EQ(fast.get_result(), 5);
+        co_return first;
+    }(scheduler), source.get_token());
+
+    EXPECT_EQ(task.get_result(), 1);
+    // stop token is propagated to children, the slow one completes after stop requested.
+    source.request_stop();
+}
+
+TEST(AsyncTest, CoroutineFrameAllocator)
+{
+    // frame freed on the owner thread is reused immediately.
+    void* frame = CoroutineFrameAllocator::allocate(1900);
+    CoroutineFrameAllocator::deallocate(frame);
+    EXPECT_EQ(CoroutineFrameAllocator::allocate(1900), frame);
+
+    // frame freed on another thread is returned to the owner.
+    std::thread([frame]() {
+        CoroutineFrameAllocator::deallocate(frame);
+    }).join();
+    EXPECT_EQ(CoroutineFrameAllocator::allocate(1900), frame);
+    CoroutineFrameAllocator::deallocate(frame);
+
+    // frame outlives the thread that allocated it.
+    void* orphan_frame = nullptr;
+    std::thread([&orphan_frame]() {
+        orphan_frame = CoroutineFrameAllocator::allocate(100);
+    }).join();
+    CoroutineFrameAllocator::deallocate(orphan_frame);
+
+    void* large_frame = CoroutineFrameAllocator::allocate(CoroutineFrameAllocator::max_pooled_size + 1);
+    EXPECT_TRUE(large_frame != nullptr);
+    CoroutineFrameAllocator::deallocate(large_frame);
+}
+
+TEST(AsyncTest, TaskGraph)
+{
+    constexpr uint32 game_thread = 0;
+    TaskGraph graph(1, 4);
+
+    std::atomic<int32> tick = 0;
+    std::atomic<int32> culling = 0;
+    GraphEventRef tick_event = graph.dispatch([&]() {
+        tick.store(1);
+    });
+    GraphEventRef culling_events[2] = {
+        graph.dispatch([&]() { culling.fetch_add(tick.load()); }, { &tick_event, 1 }),
+        graph.dispatch([&]() { culling.fetch_add(tick.load()); }, { &tick_event, 1 }, TaskGraph::any_thread, ETaskGraphPriority::High),
+    };
+
+    // upload runs on the named thread after both culling tasks.
+    int32 uploaded = 0;
+    GraphEventRef upload_event = graph.dispatch([&]() {
+        uploaded = culling.load();
+    }, culling_events, game_thread);
+
+    graph.wait_until_completed(game_thread, upload_event);
+    EXPECT_TRUE(upload_event->is_completed());
+    EXPECT_EQ(uploaded, 2);
+
+    // fan out and join.
+    constexpr int32 task_count = 1000;
+    std::atomic<int32> executed = 0;
+    Array<GraphEventRef> events;
+    for (int32 i = 0; i < task_count; ++i)
+    {
+        events.add(graph.dispatch([&]() { executed.fetch_add(1); }));
+    }
+    GraphEventRef join_event = graph.dispatch([&]() {
+        EXPECT_EQ(executed.load(), task_count);
+    }, events);
+    join_event->wait();
+    EXPECT_EQ(executed.load(), task_count);
+
+    // prerequisites that have already completed.
+    GraphEventRef late_event = graph.dispatch([]() {}, events, game_thread);
+    graph.process_until_idle(game_thread);
+    EXPECT_TRUE(late_event->is_completed());
+}
+
+TEST(AsyncTest, ParallelFor)
+{
+    Array<int32> values;
+    values.resize(10000);
+    parallel_for(values.size(), 64, [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            values[i] = static_cast<int32>(i);
+        }
+    });
+    parallel_for(values, 64, [](int32& value) { value *= 2; });
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(values[i], static_cast<int32>(i) * 2);
+    }
+
+    const int64 sum = parallel_reduce(values.size(), 64, int64(0), [&values](size_t begin, size_t end) {
+        int64 partial = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            partial += values[i];
+        }
+        return partial;
+    }, std::plus<int64>());
+    EXPECT_EQ(sum, int64(9999) * 10000);
+}
+
+TEST(AsyncTest, ParallelSort)
+{
+    for (size_t count : { size_t(0), size_t(100), size_t(10000), size_t(100003) })
+    {
+        Array<uint32> values;
+        values.reserve(count);
+        uint32 random_state = 1;
+        for (size_t i = 0; i < count; ++i)
+        {
+            random_state = random_state * 1664525u + 1013904223u;
+            // few distinct keys, so runs are full of ties.
+            values.add(random_state % 1000);
+        }
+
+        Array<uint32> expected = values;
+        std::sort(expected.begin(), expected.end());
+        parallel_sort(values);
+        EXPECT_TRUE(std::ranges::equal(values, expected));
+
+        parallel_sort(values, std::greater<>());
+        EXPECT_TRUE(std::is_sorted(values.begin(), values.end(), std::greater<>()));
+    }
+}
+
 }// namespace atlas
\ No newline at end of file
@@ -1,10 +1,17 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include <memory>
+#include <thread>
+
 #include "gtest/gtest.h"
 
+#include "container/concurrent_unordered_map.hpp"
 #include "concurrency/lock_free_list.hpp"
 #include "concurrency/priority_queue.hpp"
+#include "concurrency/ring_queue.hpp"
+#include "concurrency/work_stealing_queue.hpp"
+#include "string/string.hpp"
 
 namespace atlas
 {
@@ -28,4 +35,174 @@ TEST(ConcurrencyTest, PriorityQueueTest)
     delete t;
 }
 
+TEST(ConcurrencyTest, WorkStealingQueueTest)
+{
+    WorkStealingQueue<int32*> queue(2);
+    int32 values[4] = { 0, 1, 2, 3 };
+    for (int32& value : values)
+    {
+        queue.push(&value);
+    }
+    EXPECT_EQ(queue.size(), 4);
+
+    // owner pops in LIFO order, thief steals in FIFO order.
+    EXPECT_EQ(*queue.pop(), 3);
+    EXPECT_EQ(*queue.steal(), 0);
+    EXPECT_EQ(*queue.steal(), 1);
+    EXPECT_EQ(*queue.pop(), 2);
+    EXPECT_TRUE(queue.pop() == nullptr);
+    EXPECT_TRUE(queue.steal() == nullptr);
+    EXPECT_TRUE(queue.is_empty());
+}
+
+TEST(ConcurrencyTest, MPMCRingQueueTest)
+{
+    {
+        MPMCRingQueue<int32, 2> queue;
+        EXPECT_TRUE(queue.try_push(1));
+        EXPECT_TRUE(queue.try_push(2));
+        EXPECT_FALSE(queue.try_push(3));
+
+        int32 value = 0;
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, 1);
+        EXPECT_TRUE(queue.try_push(3));
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, 2);
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, 3);
+        EXPECT_FALSE(queue.try_pop(value));
+    }
+
+    {
+        constexpr int32 producer_count = 4;
+        constexpr int32 item_per_producer = 10000;
+        MPMCRingQueue<int32, 64> queue;
+        std::atomic<int64> sum = 0;
+        std::atomic<int32> popped = 0;
+
+        Array<std::thread> threads;
+        for (int32 i = 0; i < producer_count; ++i)
+        {
+            threads.emplace([&queue]() {
+                for (int32 j = 1; j <= item_per_producer; ++j)
+                {
+                    while (!queue.try_push(j))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+            threads.emplace([&queue, &sum, &popped]() {
+                int32 value;
+                while (popped.load(std::memory_order_relaxed) < producer_count * item_per_producer)
+                {
+                    if (queue.try_pop(value))
+                    {
+                        sum.fetch_add(value, std::memory_order_relaxed);
+                        popped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(sum.load(), int64(producer_count) * item_per_producer * (item_per_producer + 1) / 2);
+        EXPECT_TRUE(queue.is_empty());
+    }
+}
+
+TEST(ConcurrencyTest, SPSCRingQueueTest)
+{
+    constexpr int32 item_count = 100000;
+    SPSCRingQueue<std::unique_ptr<int32>, 16> queue;
+
+    std::thread producer([&queue]() {
+        for (int32 i = 0; i < item_count; ++i)
+        {
+            auto item = std::make_unique<int32>(i);
+            while (!queue.try_push(std::move(item)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // items are popped in push order.
+    int32 expected = 0;
+    std::unique_ptr<int32> item;
+    while (expected < item_count)
+    {
+        if (queue.try_pop(item))
+        {
+            EXPECT_EQ(*item, expected);
+            ++expected;
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(queue.is_empty());
+}
+
+TEST(ConcurrencyTest, ConcurrentUnorderedMapTest)
+{
+    {
+        ConcurrentUnorderedMap<String, int32> map;
+        EXPECT_TRUE(map.insert("a", 1));
+        EXPECT_FALSE(map.insert(String("a"), 2));
+        EXPECT_TRUE(map.try_emplace(StringView("b"), 2));
+        EXPECT_FALSE(map.insert_or_assign("b", 3));
+        EXPECT_EQ(map.size(), 2);
+
+        // lookups with a view need no String.
+        EXPECT_TRUE(map.contains(StringView("a")));
+        EXPECT_EQ(map.find_value(StringView("b")), 3);
+        EXPECT_FALSE(map.find_value("c").has_value());
+
+        EXPECT_EQ(map.visit("a", [](auto& pair) { pair.second += 10; }), 1);
+        EXPECT_EQ(map.cvisit("c", [](const auto&) {}), 0);
+        EXPECT_FALSE(map.insert_or_visit("a", 0, [](auto& pair) { ++pair.second; }));
+        EXPECT_EQ(map.find_value("a"), 12);
+
+        int32 sum = 0;
+        EXPECT_EQ(map.cvisit_all([&sum](const auto& pair) { sum += pair.second; }), 2);
+        EXPECT_EQ(sum, 15);
+
+        EXPECT_FALSE(map.remove_if("a", [](const auto& pair) { return pair.second < 10; }));
+        EXPECT_TRUE(map.remove("a"));
+        EXPECT_FALSE(map.remove("a"));
+        EXPECT_EQ(map.remove_all([](const auto&) { return true; }), 1);
+        EXPECT_TRUE(map.is_empty());
+    }
+
+    {
+        constexpr int32 thread_count = 4;
+        constexpr int32 key_count = 1000;
+        ConcurrentUnorderedMap<int32, int32> map;
+        map.reserve(key_count);
+
+        // every thread counts every key, so each key is inserted once and visited by the other threads.
+        Array<std::thread> threads;
+        for (int32 i = 0; i < thread_count; ++i)
+        {
+            threads.emplace([&map]() {
+                for (int32 key = 0; key < key_count; ++key)
+                {
+                    map.insert_or_visit(key, 1, [](auto& pair) { ++pair.second; });
+                    EXPECT_TRUE(map.contains(key));
+                }
+            });
+        }
+
+        for (auto&& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_EQ(map.size(), key_count);
+        EXPECT_EQ(map.cvisit_all([thread_count](const auto& pair) { EXPECT_EQ(pair.second, thread_count); }), key_count);
+    }
+}
+
 }// namespace atlas
\ No newline at end of file
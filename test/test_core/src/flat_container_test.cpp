@@ -7,6 +7,7 @@
 #include "container/map.hpp"
 #include "container/unordered_set.hpp"
 #include "container/unordered_map.hpp"
+#include "string/string.hpp"
 
 namespace atlas::test
 {
@@ -252,4 +253,26 @@ TEST(UnorderedMapTest, UnorderedMapCtor)
     EXPECT_TRUE(map.contains("atlas"));
 }
 
+TEST(UnorderedMapTest, UnorderedMapTransparentLookup)
+{
+    UnorderedMap<String, int32> map;
+    map.insert(String("atlas"), 1);
+    map.insert(String("a key too long to be stored inline"), 2);
+
+    const char* c_str = "atlas";
+    StringView view("a key too long to be stored inline");
+    EXPECT_TRUE(map.contains(c_str) && map.contains(view) && !map.contains("engine"));
+    EXPECT_TRUE(map.find("atlas") != map.end() && *map.find_value(view) == 2);
+    EXPECT_EQ(Hash<String>()(String("atlas")), Hash<String>()(StringView("atlas")));
+
+    map.find_or_insert(StringView("engine"))->second = 3;
+    EXPECT_EQ(map.find_value_ref(String("engine")), 3);
+    EXPECT_TRUE(map.remove(view) && map.size() == 2);
+
+    map.reserve(100);
+    EXPECT_TRUE(map.capacity() >= 100 && map.load_factor() <= map.max_load_factor());
+    map.rehash(0);
+    EXPECT_TRUE(map.size() == 2 && map.contains("atlas") && map.contains("engine"));
+}
+
 }
\ No newline at end of file
@@ -1,10 +1,19 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include <cstring>
+#include <thread>
+
 #include "gtest/gtest.h"
 
 #include "memory/standard_malloc.hpp"
+#include "memory/thread_caching_malloc.hpp"
+#include "memory/tracking_malloc.hpp"
 #include "memory/allocator.hpp"
+#include "memory/memory_arena.hpp"
+#include "memory/object_pool.hpp"
+#include "container/array.hpp"
+#include "container/unordered_map.hpp"
 
 namespace atlas::test
 {
@@ -21,6 +30,11 @@ TEST(MemoryTest, StandardMallocTest)
     void* ptr = standard_malloc.malloc(100);
     EXPECT_TRUE(ptr != nullptr);
 
+    // the slack of a block is usable without moving it.
+    const size_t usable_size = standard_malloc.usable_size(ptr);
+    EXPECT_GE(usable_size, 100);
+    EXPECT_TRUE(standard_malloc.try_expand_in_place(ptr, usable_size));
+
     ptr = standard_malloc.realloc(ptr, 50);
     EXPECT_TRUE(ptr != nullptr);
 
@@ -36,6 +50,153 @@ TEST(MemoryTest, StandardMallocTest)
     standard_malloc.aligned_free(ptr);
 }
 
+TEST(MemoryTest, ThreadCachingMallocTest)
+{
+    StandardMalloc standard_malloc;
+    ThreadCachingMalloc thread_caching_malloc(&standard_malloc);
+
+    for (size_t size : { 0, 1, 16, 100, 129, 1000, 4096, 16 * 1024 })
+    {
+        void* ptr = thread_caching_malloc.malloc(size);
+        EXPECT_TRUE(ptr != nullptr && reinterpret_cast<uintptr_t>(ptr) % 16 == 0);
+        EXPECT_TRUE(thread_caching_malloc.owns(ptr));
+        std::memset(ptr, 0xcd, size);
+        thread_caching_malloc.free(ptr);
+    }
+
+    // grows into another size class and keeps the content.
+    void* ptr = thread_caching_malloc.malloc(40);
+    std::memcpy(ptr, "atlas", 6);
+    ptr = thread_caching_malloc.realloc(ptr, 1000);
+    EXPECT_STREQ(static_cast<char*>(ptr), "atlas");
+    thread_caching_malloc.free(ptr);
+
+    ptr = thread_caching_malloc.aligned_malloc(100, 64);
+    EXPECT_TRUE(ptr != nullptr && reinterpret_cast<uintptr_t>(ptr) % 64 == 0);
+    ptr = thread_caching_malloc.aligned_realloc(ptr, 3000, 4096);
+    EXPECT_TRUE(ptr != nullptr && reinterpret_cast<uintptr_t>(ptr) % 4096 == 0);
+    thread_caching_malloc.aligned_free(ptr);
+
+    // large blocks and blocks of another allocator go through the fallback.
+    ptr = thread_caching_malloc.malloc(1024 * 1024);
+    EXPECT_FALSE(thread_caching_malloc.owns(ptr));
+    thread_caching_malloc.free(ptr);
+    ptr = standard_malloc.malloc(64);
+    EXPECT_FALSE(thread_caching_malloc.owns(ptr));
+    thread_caching_malloc.free(ptr);
+
+    // a large aligned block is freed by the aligned_free of the fallback, whatever its alignment.
+    struct AlignedCountingMalloc final : public StandardMalloc
+    {
+        void* aligned_malloc(size_t size, size_t alignment) override
+        {
+            ++aligned_count;
+            return StandardMalloc::aligned_malloc(size, alignment);
+        }
+
+        void aligned_free(void* ptr) override
+        {
+            --aligned_count;
+            StandardMalloc::aligned_free(ptr);
+        }
+
+        int32 aligned_count{ 0 };
+    } counting_malloc;
+    {
+        ThreadCachingMalloc large_malloc(&counting_malloc);
+        ptr = large_malloc.aligned_malloc(1024 * 1024, 16);
+        EXPECT_EQ(counting_malloc.aligned_count, 1);
+        large_malloc.aligned_free(ptr);
+        EXPECT_EQ(counting_malloc.aligned_count, 0);
+    }
+
+    // blocks are freed by other threads, the pages of an exited thread are adopted.
+    constexpr int32 block_count = 10000;
+    auto blocks = std::make_unique<void*[]>(block_count);
+    std::thread producer([&]() {
+        for (int32 i = 0; i < block_count; ++i)
+        {
+            blocks[i] = thread_caching_malloc.malloc(32);
+            *static_cast<int32*>(blocks[i]) = i;
+        }
+    });
+    producer.join();
+
+    for (int32 i = 0; i < block_count; ++i)
+    {
+        EXPECT_EQ(*static_cast<int32*>(blocks[i]), i);
+        thread_caching_malloc.free(blocks[i]);
+    }
+
+    std::thread consumer([&]() {
+        for (int32 i = 0; i < block_count; ++i)
+        {
+            blocks[i] = thread_caching_malloc.malloc(32);
+        }
+        for (int32 i = 0; i < block_count; ++i)
+        {
+            thread_caching_malloc.free(blocks[i]);
+        }
+    });
+    consumer.join();
+}
+
+TEST(MemoryTest, TrackingMallocTest)
+{
+    StandardMalloc standard_malloc;
+    TrackingMalloc tracking_malloc(&standard_malloc);
+
+    void* untagged = tracking_malloc.malloc(100);
+    void* io = nullptr;
+    void* io_aligned = nullptr;
+    {
+        MemoryScope io_scope("test_io");
+        io = tracking_malloc.malloc(1000);
+        {
+            MemoryScope nested_scope("test_nested");
+            EXPECT_NE(MemoryScope::get_current_tag(), MemoryScope::get_tag("test_io"));
+        }
+        EXPECT_EQ(MemoryScope::get_current_tag(), MemoryScope::get_tag("test_io"));
+        io_aligned = tracking_malloc.aligned_malloc(64, 64);
+        EXPECT_TRUE(io_aligned != nullptr && reinterpret_cast<uintptr_t>(io_aligned) % 64 == 0);
+    }
+    EXPECT_EQ(MemoryScope::get_current_tag(), MemoryScope::untagged);
+
+    // a block keeps its tag when it grows outside of the scope.
+    io = tracking_malloc.realloc(io, 3000);
+
+    // counted by the shard of another thread.
+    std::thread([&]() {
+        tracking_malloc.free(untagged);
+    }).join();
+
+    MemoryStats stats = tracking_malloc.get_stats();
+    const MemoryTagStats& io_stats = stats.tags[MemoryScope::get_tag("test_io")];
+    EXPECT_STREQ(io_stats.name, "test_io");
+    EXPECT_EQ(io_stats.live_bytes, 3000 + 64);
+    EXPECT_EQ(io_stats.peak_bytes, 3000 + 64);
+    EXPECT_EQ(io_stats.allocation_count, 3);
+    EXPECT_EQ(io_stats.free_count, 1);
+    EXPECT_EQ(io_stats.size_histogram[0], 0);
+    EXPECT_EQ(io_stats.size_histogram[2], 1);
+    EXPECT_EQ(io_stats.size_histogram[6], 1);
+    EXPECT_EQ(io_stats.size_histogram[8], 1);
+
+    const MemoryTagStats& untagged_stats = stats.tags[MemoryScope::untagged];
+    EXPECT_EQ(untagged_stats.live_bytes, 0);
+    EXPECT_EQ(untagged_stats.allocation_count, 1);
+    EXPECT_EQ(untagged_stats.free_count, 1);
+    EXPECT_EQ(stats.total.live_bytes, 3000 + 64);
+
+    String json = stats.to_json();
+    EXPECT_TRUE(json.starts_with("{\"total\":{\"name\":\"total\",\"live_bytes\":3064,"));
+    EXPECT_NE(json.index_of("\"name\":\"test_io\",\"live_bytes\":3064,\"peak_bytes\":3064,\"allocation_count\":3"), INDEX_NONE);
+
+    tracking_malloc.free(io);
+    tracking_malloc.aligned_free(io_aligned);
+    EXPECT_EQ(tracking_malloc.get_stats().total.live_bytes, 0);
+}
+
 TEST(MemoryTest, OperatorNewDeleteTest)
 {
     // aligned new
@@ -127,4 +288,199 @@ TEST(MemoryTest, InlineAllocatorTest)
 
 }
 
+TEST(MemoryTest, MemoryArenaTest)
+{
+    MemoryArena arena(1024);
+    EXPECT_TRUE(arena.get_used_size() == 0);
+
+    void* ptr_0 = arena.allocate(24);
+    void* ptr_1 = arena.allocate(8, 32);
+    EXPECT_TRUE(reinterpret_cast<uintptr_t>(ptr_1) % 32 == 0);
+    EXPECT_TRUE(static_cast<char*>(ptr_1) >= static_cast<char*>(ptr_0) + 24);
+
+    // the last block grows in place.
+    void* ptr_2 = arena.reallocate(ptr_1, 8, 64, 32);
+    EXPECT_TRUE(ptr_1 == ptr_2);
+
+    MemoryArena::Marker marker = arena.get_marker();
+    const size_t used = arena.get_used_size();
+    void* ptr_3 = arena.allocate(100);
+    // larger than a chunk.
+    void* ptr_4 = arena.allocate(4096);
+    EXPECT_TRUE(ptr_3 != nullptr && ptr_4 != nullptr);
+    std::memset(ptr_4, 0xff, 4096);
+    EXPECT_TRUE(arena.get_used_size() > used + 4096);
+
+    arena.rewind(marker);
+    EXPECT_TRUE(arena.get_used_size() == used);
+    EXPECT_TRUE(arena.allocate(100) == ptr_3);
+
+    // released chunks are reused.
+    const size_t reserved = arena.get_reserved_size();
+    arena.reset();
+    EXPECT_TRUE(arena.get_used_size() == 0);
+    arena.allocate(4000);
+    arena.allocate(512);
+    EXPECT_TRUE(arena.get_reserved_size() == reserved);
+}
+
+TEST(MemoryTest, ArenaAllocatorTest)
+{
+    MemoryArena arena;
+    {
+        Array<int32, ArenaAllocator<int32>> array{ ArenaAllocator<int32>(arena) };
+        for (int32 i = 0; i < 1000; ++i)
+        {
+            array.add(i);
+        }
+        EXPECT_TRUE(array.size() == 1000);
+        EXPECT_TRUE(array[999] == 999);
+        // grown in place, only the final capacity is in use.
+        EXPECT_TRUE(arena.get_used_size() == array.capacity() * sizeof(int32));
+
+        Array<std::string, ArenaAllocator<std::string>> strings{ ArenaAllocator<std::string>(arena) };
+        for (int32 i = 0; i < 100; ++i)
+        {
+            strings.add(std::to_string(i));
+        }
+        EXPECT_TRUE(strings[42] == "42");
+
+        UnorderedMap<int32, int32, Hash<int32>, EqualTo<int32>, ArenaAllocator<void>> map{ ArenaAllocator<void>(arena) };
+        for (int32 i = 0; i < 100; ++i)
+        {
+            map.insert(i, i * 2);
+        }
+        EXPECT_TRUE(map.size() == 100);
+        EXPECT_TRUE(*map.find_value(50) == 100);
+    }
+    arena.reset();
+    EXPECT_TRUE(arena.get_used_size() == 0);
+
+    FrameAllocator& frame = FrameAllocator::get();
+    frame.begin_frame();
+    MemoryArena& frame_arena = frame.get_arena();
+    Array<int32, ArenaAllocator<int32>> array;
+    array.add(1);
+    EXPECT_TRUE(frame_arena.get_used_size() == array.capacity() * sizeof(int32));
+
+    // the previous frame stays valid for one frame.
+    frame.begin_frame();
+    EXPECT_TRUE(&frame.get_arena() != &frame_arena);
+    EXPECT_TRUE(array[0] == 1);
+    frame.begin_frame();
+    EXPECT_TRUE(frame_arena.get_used_size() == 0);
+}
+
+TEST(MemoryTest, ObjectPoolTest)
+{
+    struct Node
+    {
+        explicit Node(int32 in_value) : value(in_value) {}
+        int32 value;
+        Node* next{ nullptr };
+    };
+
+    ObjectPool<Node> pool(4 * sizeof(Node));
+    Node* node_0 = pool.create(0);
+    Node* node_1 = pool.create(1);
+    EXPECT_TRUE(node_0->value == 0 && node_1->value == 1);
+    EXPECT_TRUE(reinterpret_cast<char*>(node_1) - reinterpret_cast<char*>(node_0) == sizeof(Node));
+
+    // a freed block is handed out by the next allocation.
+    pool.destroy(node_0);
+    Node* node_2 = pool.create(2);
+    EXPECT_TRUE(node_2 == node_0);
+
+    Array<Node*> nodes;
+    for (int32 i = 0; i < 10; ++i)
+    {
+        Node* node = pool.create(i);
+        nodes.add(node);
+    }
+    for (int32 i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(nodes[i]->value == i);
+        pool.destroy(nodes[i]);
+    }
+    pool.destroy(node_1);
+    pool.destroy(node_2);
+
+    ObjectPool<Alignment32> aligned_pool;
+    for (int32 i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(reinterpret_cast<uintptr_t>(aligned_pool.create()) % 32 == 0);
+    }
+
+    ObjectPool<Node, true> concurrent_pool(16 * sizeof(Node));
+    std::thread threads[4];
+    for (int32 i = 0; i < 4; ++i)
+    {
+        threads[i] = std::thread([&concurrent_pool, i] {
+            Node* thread_nodes[64];
+            for (int32 round = 0; round < 100; ++round)
+            {
+                for (int32 j = 0; j < 64; ++j)
+                {
+                    thread_nodes[j] = concurrent_pool.create(i * 1000 + j);
+                }
+                for (int32 j = 0; j < 64; ++j)
+                {
+                    EXPECT_TRUE(thread_nodes[j]->value == i * 1000 + j);
+                    concurrent_pool.destroy(thread_nodes[j]);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    using AllocType = PoolAllocator<Node>;
+    using TraitsType = AllocatorTraits<AllocType>;
+    AllocType allocator;
+    Node* ptr_0 = TraitsType::allocate(allocator, 1);
+    TraitsType::deallocate(allocator, ptr_0, 1);
+    Node* ptr_1 = TraitsType::allocate(allocator, 1);
+    EXPECT_TRUE(ptr_0 == ptr_1);
+    TraitsType::deallocate(allocator, ptr_1, 1);
+    Node* ptr_2 = TraitsType::allocate(allocator, 8);
+    EXPECT_TRUE(ptr_2 != nullptr);
+    TraitsType::deallocate(allocator, ptr_2, 8);
+}
+
+TEST(MemoryTest, VirtualMemoryTest)
+{
+    const size_t size = PlatformMemory::get_reserve_size(3 * 1024 * 1024, EHugePages::Transparent);
+    EXPECT_TRUE(size == 2 * PlatformMemory::huge_page_size);
+
+    void* ptr = PlatformMemory::reserve(size, EHugePages::Transparent, PlatformMemory::get_current_numa_node());
+    ASSERT_TRUE(ptr != nullptr);
+    EXPECT_TRUE(reinterpret_cast<uintptr_t>(ptr) % PlatformMemory::huge_page_size == 0);
+    EXPECT_TRUE(PlatformMemory::commit(ptr, size, true));
+    EXPECT_TRUE(static_cast<byte*>(ptr)[size - 1] == 0);
+    std::memset(ptr, 0xcd, size);
+
+    // decommitted pages read as zero once committed again.
+    PlatformMemory::decommit(ptr, size);
+    EXPECT_TRUE(PlatformMemory::commit(ptr, size));
+    EXPECT_TRUE(static_cast<byte*>(ptr)[0] == 0);
+    PlatformMemory::release(ptr, size);
+
+    const size_t explicit_size = PlatformMemory::get_reserve_size(1, EHugePages::Explicit);
+    void* explicit_ptr = PlatformMemory::reserve(explicit_size, EHugePages::Explicit);
+    ASSERT_TRUE(explicit_ptr != nullptr);
+    EXPECT_TRUE(PlatformMemory::commit(explicit_ptr, explicit_size));
+    static_cast<byte*>(explicit_ptr)[0] = 1;
+    PlatformMemory::release(explicit_ptr, explicit_size);
+
+    Array<byte, VirtualMemoryAllocator<byte>> buffer;
+    for (int32 i = 0; i < 3 * 1024 * 1024; ++i)
+    {
+        buffer.add(static_cast<byte>(i));
+    }
+    EXPECT_TRUE(reinterpret_cast<uintptr_t>(buffer.data()) % PlatformMemory::huge_page_size == 0);
+    EXPECT_TRUE(buffer[1024 * 1024 + 7] == 7);
+}
+
 }
@@ -1,6 +1,10 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+
 #include "gtest/gtest.h"
 
 #include "utility/delegate_fwd.hpp"
@@ -224,6 +228,49 @@ TEST(MiscTest, IOTest)
         });
         task.start();
     }
+
+    {
+        auto chunk_file = Directory::get_engine_directory() / Path("test/test_core/test_chunks.txt").normalize();
+        // the backend only writes to existing files.
+        std::ofstream(chunk_file.to_string().data()).close();
+        IOBuffer buffer = {'a','b','c','d','e'};
+        EXPECT_EQ(launch(llio.async_write(chunk_file, buffer)).get_result(), 5);
+
+        // chunks are read one at a time, the last one is short.
+        Array<IOBuffer> chunks = launch([](LowLevelIO& llio, Path file) -> Task<Array<IOBuffer>> {
+            Array<IOBuffer> result;
+            AsyncGenerator<IOBuffer> generator = llio.async_read_chunks(std::move(file), 2);
+            while (IOBuffer* chunk = co_await generator.next())
+            {
+                result.add(std::move(*chunk));
+            }
+            co_return result;
+        }(llio, chunk_file)).get_result();
+
+        ASSERT_EQ(chunks.size(), 3);
+        EXPECT_TRUE(std::ranges::equal(chunks[0], std::string_view("ab")));
+        EXPECT_TRUE(std::ranges::equal(chunks[1], std::string_view("cd")));
+        EXPECT_TRUE(std::ranges::equal(chunks[2], std::string_view("e")));
+    }
+
+    {
+        auto chunk_file = Directory::get_engine_directory() / Path("test/test_core/test_chunks.txt").normalize();
+
+        // a stop requested before the read never touches the file.
+        StopSource stopped;
+        stopped.request_stop();
+        EXPECT_TRUE(launch(llio.async_read(chunk_file), stopped.get_token()).get_result().is_empty());
+
+        // a read cancelled while queued either completes or is resumed as cancelled, it never hangs.
+        for (int32 i = 0; i < 64; ++i)
+        {
+            StopSource source;
+            auto read = launch(llio.async_read(chunk_file), source.get_token());
+            source.request_stop();
+            const size_t size = read.get_result().size();
+            EXPECT_TRUE(size == 0 || size == 5);
+        }
+    }
 }
 
 } // namespace atlas::test
\ No newline at end of file
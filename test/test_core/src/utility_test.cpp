@@ -1,12 +1,16 @@
 // Copyright(c) 2023-present, Atlas.
 // Distributed under the MIT License (http://opensource.org/licenses/MIT)
 
+#include <optional>
+
 #include "container/unordered_map.hpp"
 #include "gtest/gtest.h"
+#include "math/wyhash.hpp"
 #include "serialize/compact_binary_archive.hpp"
 #include "utility/call_traits.hpp"
 #include "utility/compression_pair.hpp"
 #include "utility/guid.hpp"
+#include "utility/stop_token.hpp"
 #include "utility/untyped_data.hpp"
 
 namespace atlas::test
@@ -78,6 +82,18 @@ TEST(UtilityTest, UntypedDataTest)
     static_assert(alignof(UntypedData<UT>) == 128 && sizeof(UntypedData<UT>) == 256);
 }
 
+TEST(UtilityTest, WyhashTest)
+{
+    // test vectors of the reference implementation, seeded with their index.
+    const char* messages[] = { "", "a", "abc", "message digest", "abcdefghijklmnopqrstuvwxyz" };
+    const uint64 expected[] = { 0x93228a4de0eec5a2ull, 0xc5bac3db178713c4ull, 0xa97f2f7b1d9b3314ull, 0x786d1f1df3801df4ull,
+                                0xdca5a8138ad37c87ull };
+    for (uint64 i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(wyhash::hash64(messages[i], std::strlen(messages[i]), i), expected[i]);
+    }
+}
+
 TEST(UtilityTest, GuidTest)
 {
     auto id = GUID::new_guid();
@@ -97,4 +113,34 @@ TEST(UtilityTest, GuidTest)
     EXPECT_EQ(id, new_id);
 }
 
-}
\ No newline at end of file
+TEST(UtilityTest, StopCallbackTest)
+{
+    StopSource source;
+    int32 called = 0;
+    {
+        StopCallback removed(source.get_token(), [&called]() { called += 100; });
+    }
+
+    StopCallback callback(source.get_token(), [&called]() { ++called; });
+    // a callback may deregister itself while it runs.
+    std::optional<StopCallback<std::function<void()>>> self;
+    self.emplace(source.get_token(), [&called, &self]() {
+        ++called;
+        self.reset();
+    });
+
+    EXPECT_TRUE(source.request_stop());
+    EXPECT_EQ(called, 2);
+    EXPECT_FALSE(source.request_stop());
+    EXPECT_EQ(called, 2);
+
+    // registered after the request, runs at once.
+    StopCallback late(source.get_token(), [&called]() { ++called; });
+    EXPECT_EQ(called, 3);
+
+    // a token without state never calls back.
+    StopCallback none(StopToken{}, [&called]() { ++called; });
+    EXPECT_EQ(called, 3);
+}
+
+}